@@ -0,0 +1,59 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockencodings.h>
+#include <kernel/cs_main.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <util/check.h>
+
+#include <vector>
+
+static constexpr size_t NUM_MEMPOOL_TXS{50000};
+static constexpr size_t NUM_BLOCK_TXS{3000};
+
+/** Reconstruct a compact block whose transactions are all in a large mempool. */
+static void BlockEncodingsInitData(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(ChainType::REGTEST);
+    CTxMemPool& pool = *testing_setup->m_node.mempool;
+    FastRandomContext det_rand{true};
+
+    CBlock block;
+    // A null header makes the compact block invalid
+    block.nBits = 0x207fffff;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    {
+        LOCK2(cs_main, pool.cs);
+        TestMemPoolEntryHelper entry;
+        for (size_t i = 0; i < NUM_MEMPOOL_TXS; ++i) {
+            CMutableTransaction tx;
+            tx.vin.emplace_back(COutPoint{Txid::FromUint256(det_rand.rand256()), 0});
+            tx.vout.emplace_back(1000, CScript{} << OP_TRUE);
+            const CTransactionRef ptx{MakeTransactionRef(tx)};
+            AddToMempool(pool, entry.FromTx(ptx));
+            if (i < NUM_BLOCK_TXS) block.vtx.push_back(ptx);
+        }
+    }
+    const CBlockHeaderAndShortTxIDs cmpctblock{block, det_rand.rand64()};
+    const std::vector<CTransactionRef> extra_txn;
+
+    bench.unit("block").run([&] {
+        PartiallyDownloadedBlock partial_block{&pool};
+        const ReadStatus status{partial_block.InitData(cmpctblock, extra_txn)};
+        assert(status == READ_STATUS_OK);
+        assert(partial_block.IsTxAvailable(NUM_BLOCK_TXS));
+    });
+}
+
+BENCHMARK(BlockEncodingsInitData, benchmark::PriorityLevel::HIGH);
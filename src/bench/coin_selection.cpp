@@ -20,8 +20,10 @@
 #include <wallet/wallet.h>
 
 #include <cassert>
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <utility>
 #include <vector>
@@ -99,6 +101,50 @@ static void CoinSelection(benchmark::Bench& bench)
     });
 }
 
+// Select coins from a pool of 100k UTXOs of random value at a high feerate, so that all of BnB,
+// CoinGrinder, Knapsack and SRD run on it, optionally with a time budget for the searches.
+static void CoinSelectionLargePool(benchmark::Bench& bench, std::optional<std::chrono::milliseconds> max_search_time)
+{
+    NodeContext node;
+    auto chain = interfaces::MakeChain(node);
+    CWallet wallet(chain.get(), "", CreateMockableWalletDatabase());
+    std::vector<std::unique_ptr<CWalletTx>> wtxs;
+    LOCK(wallet.cs_wallet);
+
+    FastRandomContext rand{/*fDeterministic=*/true};
+    for (int i = 0; i < 100'000; ++i) {
+        addCoin(100'000 + rand.randrange(COIN), wallet, wtxs);
+    }
+    wallet::CoinsResult available_coins;
+    for (const auto& wtx : wtxs) {
+        const auto txout = wtx->tx->vout.at(0);
+        available_coins.coins[OutputType::BECH32].emplace_back(COutPoint(wtx->GetHash(), 0), txout, /*depth=*/6 * 24, CalculateMaximumSignedInputSize(txout, &wallet, /*coin_control=*/nullptr), /*spendable=*/true, /*solvable=*/true, /*safe=*/true, wtx->GetTxTime(), /*from_me=*/true, /*fees=*/ 0);
+    }
+
+    const CoinEligibilityFilter filter_standard(1, 6, 0);
+    CoinSelectionParams coin_selection_params{
+        rand,
+        /*change_output_size=*/ 34,
+        /*change_spend_size=*/ 148,
+        /*min_change_target=*/ CHANGE_LOWER,
+        /*effective_feerate=*/ CFeeRate(40'000),
+        /*long_term_feerate=*/ CFeeRate(10'000),
+        /*discard_feerate=*/ CFeeRate(3000),
+        /*tx_noinputs_size=*/ 0,
+        /*avoid_partial=*/ false,
+    };
+    coin_selection_params.m_max_search_time = max_search_time;
+    auto group = wallet::GroupOutputs(wallet, available_coins, coin_selection_params, {{filter_standard}})[filter_standard];
+    bench.run([&] {
+        auto result = AttemptSelection(wallet.chain(), 20 * COIN, group, coin_selection_params, /*allow_mixed_output_types=*/true);
+        assert(result);
+        assert(result->GetSelectedValue() >= 20 * COIN);
+    });
+}
+
+static void CoinSelectionLargePoolUnlimited(benchmark::Bench& bench) { CoinSelectionLargePool(bench, /*max_search_time=*/std::nullopt); }
+static void CoinSelectionLargePoolTimeBudget(benchmark::Bench& bench) { CoinSelectionLargePool(bench, /*max_search_time=*/std::chrono::milliseconds{10}); }
+
 // Copied from src/wallet/test/coinselector_tests.cpp
 static void add_coin(const CAmount& nValue, int nInput, std::vector<OutputGroup>& set)
 {
@@ -138,4 +184,6 @@ static void BnBExhaustion(benchmark::Bench& bench)
 }
 
 BENCHMARK(CoinSelection, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CoinSelectionLargePoolUnlimited, benchmark::PriorityLevel::LOW);
+BENCHMARK(CoinSelectionLargePoolTimeBudget, benchmark::PriorityLevel::LOW);
 BENCHMARK(BnBExhaustion, benchmark::PriorityLevel::HIGH);
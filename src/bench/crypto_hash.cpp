@@ -15,8 +15,11 @@
 #include <span.h>
 #include <tinyformat.h>
 #include <uint256.h>
+#include <util/threadpool.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <future>
 #include <vector>
 
 /* Number of bytes to hash per iteration */
@@ -262,6 +265,49 @@ static void MuHashFinalize(benchmark::Bench& bench)
     });
 }
 
+/* Number of created and spent coins in a typical block */
+static constexpr int MUHASH_BLOCK_COINS{5000};
+
+/** Fold a block worth of serialized coins into the set hash, as done by the
+ *  coinstatsindex for every block, splitting the block over num_workers
+ *  partial products when num_workers > 0. */
+static void MuHashBlockUpdate(benchmark::Bench& bench, int num_workers)
+{
+    FastRandomContext rng(true);
+    std::vector<std::vector<unsigned char>> coins;
+    for (int i = 0; i < MUHASH_BLOCK_COINS; ++i) {
+        coins.push_back(rng.randbytes(60));
+    }
+    ThreadPool pool{"bench_muhash"};
+    if (num_workers > 0) pool.Start(num_workers);
+
+    MuHash3072 acc;
+    bench.batch(coins.size()).unit("coin").run([&] {
+        MuHash3072 block_hash;
+        if (num_workers == 0) {
+            for (const auto& coin : coins) block_hash.Insert(coin);
+        } else {
+            std::vector<std::future<MuHash3072>> partials;
+            const size_t chunk{(coins.size() + num_workers - 1) / num_workers};
+            for (size_t begin = 0; begin < coins.size(); begin += chunk) {
+                partials.emplace_back(pool.Submit([&coins, begin, end = std::min(begin + chunk, coins.size())] {
+                    MuHash3072 partial;
+                    for (size_t i = begin; i < end; ++i) partial.Insert(coins[i]);
+                    return partial;
+                }));
+            }
+            for (auto& partial : partials) block_hash *= partial.get();
+        }
+        acc *= block_hash;
+        uint256 out;
+        acc.Finalize(out);
+        ankerl::nanobench::doNotOptimizeAway(out);
+    });
+}
+
+static void MuHashBlock(benchmark::Bench& bench) { MuHashBlockUpdate(bench, /*num_workers=*/0); }
+static void MuHashBlockParallel(benchmark::Bench& bench) { MuHashBlockUpdate(bench, /*num_workers=*/4); }
+
 BENCHMARK(BenchRIPEMD160, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA1, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_STANDARD, benchmark::PriorityLevel::HIGH);
@@ -286,3 +332,5 @@ BENCHMARK(MuHashMul, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashDiv, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashPrecompute, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashFinalize, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashBlock, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashBlockParallel, benchmark::PriorityLevel::HIGH);
@@ -3,11 +3,15 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <common/system.h>
 #include <key.h>
 #include <script/descriptor.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
+#include <test/util/setup_common.h>
+#include <util/threadpool.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -34,4 +38,54 @@ static void ExpandDescriptor(benchmark::Bench& bench)
     });
 }
 
+enum class DerivationCacheMode {
+    DISABLED, // every position derives the whole path from the private key
+    DEFAULT,  // the derivation of the hardened parent path is memoized
+    WARM,     // every derivation of the range is in the cache
+};
+
+static void ExpandDescriptorLargeRange(benchmark::Bench& bench, DerivationCacheMode cache_mode, bool use_thread_pool)
+{
+    // Decoding the xprv needs the chain params
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>(ChainType::MAIN)};
+
+    constexpr int64_t RANGE_END{100000};
+    const auto desc_str = "wpkh(xprv9s21ZrQH143K31xYSDQpPDxsXRTUcvj2iNHm5NUtrGiGG5e2DtALGdso3pGz6ssrdK4PFmM8NSpSBHNqPqm55Qn3LqFtT2emdEXVYsCzC2U/84h/0h/0h/0/*)";
+    FlatSigningProvider provider;
+    std::string error;
+    auto descs = Parse(desc_str, provider, error);
+    assert(descs.size() == 1);
+
+    ThreadPool thread_pool{"descexpand"};
+    if (use_thread_pool) thread_pool.Start(std::max(GetNumCores(), 1));
+    const auto expand_range{[&] {
+        std::vector<std::vector<CScript>> scripts;
+        FlatSigningProvider out;
+        bool success = ExpandRange(*descs[0], 0, RANGE_END, provider, scripts, out, use_thread_pool ? &thread_pool : nullptr);
+        assert(success);
+    }};
+
+    switch (cache_mode) {
+    case DerivationCacheMode::DISABLED: SetDescriptorDerivationCacheSize(0); break;
+    case DerivationCacheMode::DEFAULT: SetDescriptorDerivationCacheSize(DEFAULT_DERIVATION_CACHE_SIZE); break;
+    case DerivationCacheMode::WARM:
+        SetDescriptorDerivationCacheSize(2 * RANGE_END);
+        expand_range();
+        break;
+    }
+
+    bench.epochs(1).epochIterations(1).batch(RANGE_END).unit("position").run(expand_range);
+
+    SetDescriptorDerivationCacheSize(DEFAULT_DERIVATION_CACHE_SIZE);
+}
+
+static void ExpandDescriptorRangeNoDerivationCache(benchmark::Bench& bench) { ExpandDescriptorLargeRange(bench, DerivationCacheMode::DISABLED, /*use_thread_pool=*/false); }
+static void ExpandDescriptorRange(benchmark::Bench& bench) { ExpandDescriptorLargeRange(bench, DerivationCacheMode::DEFAULT, /*use_thread_pool=*/false); }
+static void ExpandDescriptorRangeThreadPool(benchmark::Bench& bench) { ExpandDescriptorLargeRange(bench, DerivationCacheMode::DEFAULT, /*use_thread_pool=*/true); }
+static void ExpandDescriptorRangeWarmDerivationCache(benchmark::Bench& bench) { ExpandDescriptorLargeRange(bench, DerivationCacheMode::WARM, /*use_thread_pool=*/false); }
+
 BENCHMARK(ExpandDescriptor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ExpandDescriptorRangeNoDerivationCache, benchmark::PriorityLevel::LOW);
+BENCHMARK(ExpandDescriptorRange, benchmark::PriorityLevel::LOW);
+BENCHMARK(ExpandDescriptorRangeThreadPool, benchmark::PriorityLevel::LOW);
+BENCHMARK(ExpandDescriptorRangeWarmDerivationCache, benchmark::PriorityLevel::LOW);
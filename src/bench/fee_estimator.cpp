@@ -0,0 +1,88 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/mempool_entry.h>
+#include <policy/fees.h>
+#include <policy/fees_args.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+
+#include <cassert>
+#include <list>
+#include <memory>
+#include <vector>
+
+//! Number of transactions confirmed in each simulated block
+static constexpr unsigned int TXS_PER_BLOCK{200};
+
+/**
+ * Feed the estimator a block's worth of new transactions and mine the block
+ * at the given height. Higher fee transactions are more likely to be
+ * confirmed, the others wait for a later block.
+ */
+static void ProcessBlock(CBlockPolicyEstimator& estimator, FastRandomContext& rng, std::list<CTxMemPoolEntry>& mempool, unsigned int height)
+{
+    for (unsigned int i = 0; i < TXS_PER_BLOCK; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(rng.rand256()), 0});
+        mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+        const CTransactionRef tx{MakeTransactionRef(mtx)};
+        const CAmount fee{static_cast<CAmount>(1000 + rng.randrange(100'000))};
+        // Transactions are only tracked if they arrive at the best block seen
+        mempool.emplace_back(CTxMemPoolEntry::ExplicitCopy, TestMemPoolEntryHelper{}.Fee(fee).Height(height - 1).FromTx(tx));
+        estimator.processTransaction(NewMempoolTransactionInfo{tx, fee, mempool.back().GetTxSize(), height - 1,
+                                                               /*mempool_limit_bypassed=*/false, /*submitted_in_package=*/false,
+                                                               /*chainstate_is_current=*/true, /*has_no_mempool_parents=*/true,
+                                                               mempool.back().GetTime()});
+    }
+
+    std::vector<RemovedMempoolTransactionInfo> removed;
+    std::list<CTxMemPoolEntry> confirmed;
+    for (auto it = mempool.begin(); it != mempool.end();) {
+        if (static_cast<CAmount>(rng.randrange(101'000)) < it->GetFee()) {
+            confirmed.splice(confirmed.end(), mempool, it++);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& entry : confirmed) removed.emplace_back(entry);
+    estimator.processBlock(removed, height);
+}
+
+static void EstimateSmartFee(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    CBlockPolicyEstimator estimator{FeeestPath(*testing_setup->m_node.args), /*read_stale_estimates=*/false};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::list<CTxMemPoolEntry> mempool;
+    for (unsigned int height = 1; height <= 200; ++height) ProcessBlock(estimator, rng, mempool, height);
+
+    int target{1};
+    bench.run([&] {
+        FeeCalculation fee_calc;
+        const CFeeRate fee_rate{estimator.estimateSmartFee(target, &fee_calc, /*conservative=*/target % 2 == 0)};
+        assert(fee_calc.returnedTarget > 0);
+        ankerl::nanobench::doNotOptimizeAway(fee_rate);
+        target = target % 144 + 1;
+    });
+}
+
+static void FeeEstimatorProcessBlock(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    CBlockPolicyEstimator estimator{FeeestPath(*testing_setup->m_node.args), /*read_stale_estimates=*/false};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::list<CTxMemPoolEntry> mempool;
+    unsigned int height{1};
+    for (; height <= 200; ++height) ProcessBlock(estimator, rng, mempool, height);
+
+    bench.unit("block").run([&] { ProcessBlock(estimator, rng, mempool, height++); });
+}
+
+BENCHMARK(EstimateSmartFee, benchmark::PriorityLevel::HIGH);
+BENCHMARK(FeeEstimatorProcessBlock, benchmark::PriorityLevel::HIGH);
@@ -18,6 +18,7 @@
 #include <test/util/setup_common.h>
 #include <uint256.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <validation.h>
 
@@ -28,7 +29,8 @@
 using namespace util::hex_literals;
 
 // Very simple block filter index sync benchmark, only using coinbase outputs.
-static void BlockFilterIndexSync(benchmark::Bench& bench)
+// With a non-zero number of workers, filters are computed on a thread pool.
+static void RunBlockFilterIndexSync(benchmark::Bench& bench, int num_workers)
 {
     const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
 
@@ -43,10 +45,14 @@ static void BlockFilterIndexSync(benchmark::Bench& bench)
     }
     assert(WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveHeight() == CHAIN_SIZE));
 
+    ThreadPool thread_pool{"bench_index"};
+    if (num_workers > 0) thread_pool.Start(num_workers);
+
     bench.minEpochIterations(5).run([&] {
         BlockFilterIndex filter_index(interfaces::MakeChain(test_setup->m_node), BlockFilterType::BASIC,
                                       /*n_cache_size=*/0, /*f_memory=*/false, /*f_wipe=*/true);
         assert(filter_index.Init());
+        if (num_workers > 0) filter_index.SetThreadPool(thread_pool);
         assert(!filter_index.BlockUntilSyncedToCurrentChain());
         filter_index.Sync();
 
@@ -56,4 +62,8 @@ static void BlockFilterIndexSync(benchmark::Bench& bench)
     });
 }
 
+static void BlockFilterIndexSync(benchmark::Bench& bench) { RunBlockFilterIndexSync(bench, /*num_workers=*/0); }
+static void BlockFilterIndexSyncParallel(benchmark::Bench& bench) { RunBlockFilterIndexSync(bench, /*num_workers=*/4); }
+
 BENCHMARK(BlockFilterIndexSync, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexSyncParallel, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,54 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <key.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <cassert>
+#include <optional>
+#include <vector>
+
+//! Number of P2WPKH inputs of the benchmarked transaction
+static constexpr uint32_t NUM_INPUTS{100};
+
+static void RunMempoolAccept(benchmark::Bench& bench, int script_check_threads)
+{
+    // Disable the signature cache, so that every iteration verifies all signatures
+    auto testing_setup{MakeNoLogFileContext<TestChain100Setup>(ChainType::REGTEST, {.min_validation_cache = true, .script_check_threads = script_check_threads})};
+
+    const CKey key{GenerateRandomKey()};
+    const CScript script{GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey()))};
+    const auto& coinbase{testing_setup->m_coinbase_txns[0]};
+    const auto [fanout, fanout_fee]{testing_setup->CreateValidTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}}, /*input_height=*/1,
+                                                                          {testing_setup->coinbaseKey}, std::vector<CTxOut>(NUM_INPUTS, CTxOut{COIN / 10, script}),
+                                                                          std::nullopt, std::nullopt)};
+    testing_setup->CreateAndProcessBlock({fanout}, script);
+
+    std::vector<COutPoint> inputs;
+    for (uint32_t i = 0; i < NUM_INPUTS; ++i) inputs.emplace_back(fanout.GetHash(), i);
+    const auto [spend, spend_fee]{testing_setup->CreateValidTransaction({MakeTransactionRef(fanout)}, inputs, /*input_height=*/101, {key},
+                                                                        {CTxOut{NUM_INPUTS * (COIN / 10) - 100000, script}}, std::nullopt, std::nullopt)};
+    const CTransactionRef tx{MakeTransactionRef(spend)};
+    Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
+
+    bench.unit("input").batch(NUM_INPUTS).run([&] {
+        LOCK(::cs_main);
+        const MempoolAcceptResult result{AcceptToMemoryPool(chainstate, tx, GetTime(), /*bypass_limits=*/false, /*test_accept=*/true)};
+        assert(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    });
+}
+
+static void MempoolAcceptMultiInput(benchmark::Bench& bench) { RunMempoolAccept(bench, /*script_check_threads=*/0); }
+static void MempoolAcceptMultiInputParallel(benchmark::Bench& bench) { RunMempoolAccept(bench, /*script_check_threads=*/3); }
+
+BENCHMARK(MempoolAcceptMultiInput, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolAcceptMultiInputParallel, benchmark::PriorityLevel::HIGH);
@@ -50,6 +50,22 @@ static void ReadBlockBench(benchmark::Bench& bench)
     });
 }
 
+static void ReadBlockFromFileBench(benchmark::Bench& bench)
+{
+    // Deserialize straight from the block file, field by field, for comparison
+    // with ReadBlockBench, which deserializes from a single in-memory read.
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    const auto pos{blockman.WriteBlock(CreateTestBlock(), 413'567)};
+    CBlock block;
+    bench.run([&] {
+        AutoFile filein{blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
+        assert(!filein.IsNull());
+        block.SetNull();
+        filein >> TX_WITH_WITNESS(block);
+    });
+}
+
 static void ReadRawBlockBench(benchmark::Bench& bench)
 {
     const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
@@ -65,4 +81,5 @@ static void ReadRawBlockBench(benchmark::Bench& bench)
 
 BENCHMARK(SaveBlockBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadBlockBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadBlockFromFileBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadRawBlockBench, benchmark::PriorityLevel::HIGH);
@@ -5,8 +5,10 @@
 #include <addresstype.h>
 #include <bench/bench.h>
 #include <coins.h>
+#include <common/system.h>
 #include <key.h>
 #include <primitives/transaction.h>
+#include <psbt.h>
 #include <pubkey.h>
 #include <script/interpreter.h>
 #include <script/script.h>
@@ -15,10 +17,13 @@
 #include <span.h>
 #include <test/util/random.h>
 #include <uint256.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
+#include <utility>
 #include <vector>
 
 enum class InputType {
@@ -100,7 +105,58 @@ static void SignSchnorrWithNullMerkleRoot(benchmark::Bench& bench)
     SignSchnorrTapTweakBenchmark(bench, /*use_null_merkle_root=*/true);
 }
 
+static void SignPSBTManyInputs(benchmark::Bench& bench, InputType input_type, bool use_thread_pool)
+{
+    constexpr int NUM_INPUTS{1000};
+    ECC_Context ecc_context{};
+
+    // A consolidation spending NUM_INPUTS coins of distinct keys
+    FlatSigningProvider keystore;
+    CMutableTransaction unsigned_tx;
+    std::vector<CTxOut> prev_outs;
+    for (int i = 0; i < NUM_INPUTS; ++i) {
+        CKey privkey = GenerateRandomKey();
+        CPubKey pubkey = privkey.GetPubKey();
+        keystore.keys.emplace(pubkey.GetID(), privkey);
+        keystore.pubkeys.emplace(pubkey.GetID(), pubkey);
+        CScript prev_spk;
+        switch (input_type) {
+        case InputType::P2WPKH: prev_spk = GetScriptForDestination(WitnessV0KeyHash(pubkey)); break;
+        case InputType::P2TR:   prev_spk = GetScriptForDestination(WitnessV1Taproot(XOnlyPubKey{pubkey})); break;
+        default: assert(false);
+        }
+        unsigned_tx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(i)});
+        prev_outs.emplace_back(10000, prev_spk);
+    }
+    unsigned_tx.vout.emplace_back(NUM_INPUTS * 10000 / 2, prev_outs[0].scriptPubKey);
+    PartiallySignedTransaction unsigned_psbt{unsigned_tx};
+    std::vector<std::pair<int, const SigningProvider*>> inputs;
+    for (int i = 0; i < NUM_INPUTS; ++i) {
+        unsigned_psbt.inputs[i].witness_utxo = prev_outs[i];
+        inputs.emplace_back(i, &keystore);
+    }
+    const PrecomputedTransactionData txdata{PrecomputePSBTData(unsigned_psbt)};
+
+    ThreadPool thread_pool{"psbtsign"};
+    if (use_thread_pool) thread_pool.Start(std::max(GetNumCores(), 1));
+
+    bench.batch(NUM_INPUTS).unit("input").run([&] {
+        PartiallySignedTransaction psbt{unsigned_psbt};
+        bool complete = SignPSBTInputs(inputs, psbt, txdata, SIGHASH_DEFAULT, /*finalize=*/true, use_thread_pool ? &thread_pool : nullptr);
+        assert(complete);
+    });
+}
+
+static void SignPSBTManyInputsECDSA(benchmark::Bench& bench)           { SignPSBTManyInputs(bench, InputType::P2WPKH, /*use_thread_pool=*/false); }
+static void SignPSBTManyInputsECDSAThreadPool(benchmark::Bench& bench) { SignPSBTManyInputs(bench, InputType::P2WPKH, /*use_thread_pool=*/true);  }
+static void SignPSBTManyInputsSchnorr(benchmark::Bench& bench)           { SignPSBTManyInputs(bench, InputType::P2TR, /*use_thread_pool=*/false); }
+static void SignPSBTManyInputsSchnorrThreadPool(benchmark::Bench& bench) { SignPSBTManyInputs(bench, InputType::P2TR, /*use_thread_pool=*/true);  }
+
 BENCHMARK(SignTransactionECDSA, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SignTransactionSchnorr, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SignSchnorrWithMerkleRoot, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SignSchnorrWithNullMerkleRoot, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SignPSBTManyInputsECDSA, benchmark::PriorityLevel::LOW);
+BENCHMARK(SignPSBTManyInputsECDSAThreadPool, benchmark::PriorityLevel::LOW);
+BENCHMARK(SignPSBTManyInputsSchnorr, benchmark::PriorityLevel::LOW);
+BENCHMARK(SignPSBTManyInputsSchnorrThreadPool, benchmark::PriorityLevel::LOW);
@@ -0,0 +1,102 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <kernel/cs_main.h>
+#include <node/txrelayranking.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <uint256.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace {
+constexpr size_t NUM_PEERS{125};
+/** A full mempool of mostly unrelated transactions, every tenth spending the one before. */
+constexpr size_t NUM_MEMPOOL_TXS{50000};
+/** The most recently accepted transactions, pending announcement to the peers. */
+constexpr size_t NUM_RECENT_TXS{2000};
+/** Share of the recent transactions each peer has not been sent yet, in percent. */
+constexpr int PENDING_PERCENT{90};
+
+struct TxRelaySetup {
+    std::unique_ptr<const ChainTestingSetup> testing_setup{MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN)};
+    CTxMemPool& pool{*testing_setup->m_node.mempool};
+    std::vector<std::set<uint256>> pending;
+
+    TxRelaySetup()
+    {
+        FastRandomContext det_rand{true};
+        std::vector<uint256> wtxids;
+        {
+            LOCK2(cs_main, pool.cs);
+            TestMemPoolEntryHelper entry;
+            CTransactionRef prev;
+            for (size_t i = 0; i < NUM_MEMPOOL_TXS; ++i) {
+                CMutableTransaction tx;
+                tx.vin.resize(1);
+                tx.vin[0].prevout = i % 10 != 0 && prev ? COutPoint{prev->GetHash(), 0} : COutPoint{Txid::FromUint256(det_rand.rand256()), 0};
+                tx.vin[0].scriptSig = CScript() << OP_1;
+                tx.vout.resize(1);
+                tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+                tx.vout[0].nValue = 10 * COIN;
+                prev = MakeTransactionRef(tx);
+                AddToMempool(pool, entry.Fee(1000 + det_rand.randrange(100000)).FromTx(prev));
+                wtxids.push_back(prev->GetWitnessHash().ToUint256());
+            }
+        }
+        pending.resize(NUM_PEERS);
+        for (auto& peer_pending : pending) {
+            for (auto it{wtxids.end() - NUM_RECENT_TXS}; it != wtxids.end(); ++it) {
+                if (det_rand.randrange(100) < PENDING_PERCENT) peer_pending.insert(*it);
+            }
+        }
+    }
+};
+} // namespace
+
+/** Order every peer's pending announcements with a heap, as done per peer before the shared ranking. */
+static void TxRelayOrderPerPeer(benchmark::Bench& bench)
+{
+    TxRelaySetup setup;
+    bench.unit("peer").batch(NUM_PEERS).run([&] {
+        for (const auto& peer_pending : setup.pending) {
+            std::vector<uint256> inv{peer_pending.begin(), peer_pending.end()};
+            const auto compare{[&](const uint256& a, const uint256& b) { return setup.pool.CompareDepthAndScore(b, a, /*wtxid=*/true); }};
+            std::make_heap(inv.begin(), inv.end(), compare);
+            while (!inv.empty()) {
+                std::pop_heap(inv.begin(), inv.end(), compare);
+                inv.pop_back();
+            }
+        }
+    });
+}
+
+/** Rank the union of the peers' pending announcements once, then order every peer's against it. */
+static void TxRelayOrderShared(benchmark::Bench& bench)
+{
+    TxRelaySetup setup;
+    bench.unit("peer").batch(NUM_PEERS).run([&] {
+        node::TxRelayRanking::Hashes wtxids;
+        for (const auto& peer_pending : setup.pending) {
+            wtxids.insert(peer_pending.begin(), peer_pending.end());
+        }
+        const node::TxRelayRanking ranking{setup.pool, {}, wtxids};
+        for (const auto& peer_pending : setup.pending) {
+            std::vector<uint256> ranked, unranked;
+            ranking.Order(peer_pending, /*wtxid=*/true, ranked, unranked);
+            assert(unranked.empty());
+        }
+    });
+}
+
+BENCHMARK(TxRelayOrderPerPeer, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxRelayOrderShared, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,98 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <consensus/amount.h>
+#include <node/utxo_snapshot.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <rpc/blockchain.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <util/result.h>
+#include <util/threadpool.h>
+#include <validation.h>
+
+#include <univalue.h>
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+// Synthetic UTXO set, scaled down from the ~100M coins of mainnet so that a
+// benchmark iteration stays short.
+static constexpr int SNAPSHOT_NUM_TXS{100'000};
+
+static void RunUTXOSnapshotWrite(benchmark::Bench& bench, int num_workers)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    FastRandomContext rng{/*fDeterministic=*/true};
+
+    CCoinsViewDB coins_db{{.path = "coins", .cache_bytes = 1 << 26, .memory_only = true}, {}};
+    {
+        CCoinsViewCache cache{&coins_db};
+        cache.SetBestBlock(rng.rand256());
+        for (int i = 0; i < SNAPSHOT_NUM_TXS; ++i) {
+            const Txid txid{Txid::FromUint256(rng.rand256())};
+            // Two outputs per transaction on average
+            const uint32_t num_outputs{1 + static_cast<uint32_t>(rng.randrange(3))};
+            for (uint32_t n = 0; n < num_outputs; ++n) {
+                CScript script;
+                script << OP_0 << rng.randbytes(20);
+                cache.AddCoin(COutPoint{txid, n}, Coin{CTxOut{static_cast<CAmount>(rng.randrange(MAX_MONEY)), script}, 1, false}, /*possible_overwrite=*/false);
+            }
+        }
+        assert(cache.Flush());
+    }
+    const auto snapshot{coins_db.Snapshot()};
+
+    ThreadPool thread_pool{"bench_snapshot"};
+    if (num_workers > 0) thread_pool.Start(num_workers);
+
+    const fs::path path{testing_setup->m_path_root / "utxo.dat"};
+    bench.unit("coin").batch(SNAPSHOT_NUM_TXS * 2).run([&] {
+        AutoFile file{fsbridge::fopen(path, "wb")};
+        const uint64_t coins_written{node::WriteSnapshotCoins(file, *snapshot, num_workers > 0 ? &thread_pool : nullptr)};
+        assert(coins_written > 0);
+        assert(file.fclose() == 0);
+    });
+}
+
+static void UTXOSnapshotWrite(benchmark::Bench& bench) { RunUTXOSnapshotWrite(bench, /*num_workers=*/0); }
+static void UTXOSnapshotWriteParallel(benchmark::Bench& bench) { RunUTXOSnapshotWrite(bench, /*num_workers=*/4); }
+
+static void UTXOSnapshotLoad(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    node::NodeContext& node{testing_setup->m_node};
+    ChainstateManager& chainman{*node.chainman};
+    // Regtest has an assumeutxo hash for height 110.
+    testing_setup->mineBlocks(10);
+
+    const fs::path path{testing_setup->m_path_root / "utxo.dat"};
+    {
+        AutoFile file{fsbridge::fopen(path, "wb")};
+        CreateUTXOSnapshot(node, chainman.ActiveChainstate(), file, path, path);
+    }
+
+    // The snapshot is loaded and validated in full, but not activated, since
+    // its base block is the active tip. This leaves the node unchanged for the
+    // next iteration.
+    bench.run([&] {
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        node::SnapshotMetadata metadata{chainman.GetParams().MessageStart()};
+        file >> metadata;
+        const auto res{chainman.ActivateSnapshot(file, metadata, /*in_memory=*/true)};
+        assert(util::ErrorString(res).original == "work does not exceed active chainstate");
+    });
+}
+
+BENCHMARK(UTXOSnapshotLoad, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UTXOSnapshotWrite, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UTXOSnapshotWriteParallel, benchmark::PriorityLevel::HIGH);
@@ -159,7 +159,7 @@ static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type
     });
 }
 
-static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type)
+static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type, bool new_dest_per_block)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
     // Set clock to genesis block, so the descriptors/keys creation time don't interfere with the blocks scanning process.
@@ -182,8 +182,10 @@ static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType
     const auto& params = Params();
     unsigned int chain_size = 1000;
     for (unsigned int i = 0; i < chain_size / dest_wallet.size(); ++i) {
-        for (const auto& dest : dest_wallet) {
-            generateFakeBlock(params, test_setup->m_node, wallet, dest);
+        for (size_t j = 0; j < dest_wallet.size(); ++j) {
+            // Coins of distinct scripts need their input size and type computed separately
+            if (new_dest_per_block && i > 0) dest_wallet[j] = GetScriptForDestination(getNewDestination(wallet, output_type[j]));
+            generateFakeBlock(params, test_setup->m_node, wallet, dest_wallet[j]);
         }
     }
 
@@ -204,8 +206,14 @@ static void WalletCreateTxUseOnlyPresetInputs(benchmark::Bench& bench) { WalletC
 static void WalletCreateTxUsePresetInputsAndCoinSelection(benchmark::Bench& bench) { WalletCreateTx(bench, OutputType::BECH32, /*allow_other_inputs=*/true,
                                                                                                     {{/*num_of_internal_inputs=*/4}}); }
 
-static void WalletAvailableCoins(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}); }
+static void WalletCreateTxUseCoinSelection(benchmark::Bench& bench) { WalletCreateTx(bench, OutputType::BECH32, /*allow_other_inputs=*/true,
+                                                                                     /*preset_inputs=*/std::nullopt); }
+
+static void WalletAvailableCoins(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}, /*new_dest_per_block=*/false); }
+static void WalletAvailableCoinsManyScripts(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32, OutputType::BECH32M}, /*new_dest_per_block=*/true); }
 
 BENCHMARK(WalletCreateTxUseOnlyPresetInputs, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletCreateTxUsePresetInputsAndCoinSelection, benchmark::PriorityLevel::LOW)
+BENCHMARK(WalletCreateTxUseCoinSelection, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletAvailableCoins, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletAvailableCoinsManyScripts, benchmark::PriorityLevel::LOW);
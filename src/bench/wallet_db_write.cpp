@@ -0,0 +1,68 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bitcoin-build-config.h> // IWYU pragma: keep
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <util/fs.h>
+#include <util/translation.h>
+#include <wallet/db.h>
+#include <wallet/transaction.h>
+#include <wallet/walletdb.h>
+
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace wallet {
+#ifdef USE_SQLITE
+// Write wallet transactions to a SQLite database the way a block with many wallet
+// transactions does, reporting the number of transactions written per second.
+static void WalletWriteTxs(benchmark::Bench& bench, bool group_commit, bool use_wal)
+{
+    constexpr size_t NUM_TXS{100};
+    const auto test_setup = MakeNoLogFileContext<const BasicTestingSetup>();
+    FastRandomContext rng{/*fDeterministic=*/true};
+
+    DatabaseOptions options;
+    options.require_format = DatabaseFormat::SQLITE;
+    options.require_create = true;
+    options.use_sqlite_wal = use_wal;
+    DatabaseStatus status;
+    bilingual_str error;
+    auto database = MakeDatabase(test_setup->m_path_root / "test_wallet", options, status, error);
+    assert(database);
+
+    std::vector<std::unique_ptr<CWalletTx>> wtxs;
+    for (size_t i = 0; i < NUM_TXS; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(Txid::FromUint256(rng.rand256()), 0);
+        mtx.vout.emplace_back(COIN, CScript() << OP_0 << rng.randbytes(20));
+        wtxs.push_back(std::make_unique<CWalletTx>(MakeTransactionRef(std::move(mtx)), TxStateInactive{}));
+    }
+
+    bench.batch(NUM_TXS).unit("tx").run([&] {
+        std::optional<DatabaseGroupCommit> group;
+        if (group_commit) group.emplace(*database);
+        for (const auto& wtx : wtxs) {
+            // A new batch per write, as AddToWallet does
+            const bool written{WalletBatch{*database}.WriteTx(*wtx)};
+            assert(written);
+        }
+    });
+}
+
+static void WalletWriteTxsAutocommit(benchmark::Bench& bench) { WalletWriteTxs(bench, /*group_commit=*/false, /*use_wal=*/false); }
+static void WalletWriteTxsGroupCommit(benchmark::Bench& bench) { WalletWriteTxs(bench, /*group_commit=*/true, /*use_wal=*/false); }
+static void WalletWriteTxsGroupCommitWAL(benchmark::Bench& bench) { WalletWriteTxs(bench, /*group_commit=*/true, /*use_wal=*/true); }
+
+BENCHMARK(WalletWriteTxsAutocommit, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletWriteTxsGroupCommit, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletWriteTxsGroupCommitWAL, benchmark::PriorityLevel::LOW);
+#endif
+} // namespace wallet
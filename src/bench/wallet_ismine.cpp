@@ -7,13 +7,17 @@
 #include <bitcoin-build-config.h> // IWYU pragma: keep
 #include <key.h>
 #include <key_io.h>
+#include <random.h>
 #include <script/descriptor.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
 #include <sync.h>
 #include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/hasher.h>
 #include <wallet/context.h>
 #include <wallet/db.h>
+#include <wallet/scriptfilter.h>
 #include <wallet/test/util.h>
 #include <wallet/types.h>
 #include <wallet/wallet.h>
@@ -23,7 +27,9 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace wallet {
 static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_combo = 0)
@@ -70,6 +76,41 @@ static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_co
     TestUnloadWallet(std::move(wallet));
 }
 
+// Look up scripts that are not in a 1M script wallet, as done for nearly every output during a rescan or
+// block connection, in the script cache alone and with the fingerprint filter in front of it.
+static void WalletIsMineScriptCache(benchmark::Bench& bench, bool use_filter)
+{
+    constexpr size_t NUM_WALLET_SCRIPTS{1'000'000};
+    constexpr size_t NUM_LOOKUPS{1'000};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto random_script{[&] { return GetScriptForDestination(WitnessV0KeyHash{uint160{rng.randbytes(20)}}); }};
+
+    std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> cached_spks;
+    ScriptPubKeyFilter filter;
+    filter.Reset(NUM_WALLET_SCRIPTS);
+    for (size_t i = 0; i < NUM_WALLET_SCRIPTS; ++i) {
+        const CScript script{random_script()};
+        cached_spks[script].push_back(nullptr);
+        filter.Insert(script);
+    }
+    std::vector<CScript> lookups;
+    for (size_t i = 0; i < NUM_LOOKUPS; ++i) lookups.push_back(random_script());
+
+    bench.batch(NUM_LOOKUPS).unit("script").run([&] {
+        size_t found{0};
+        for (const CScript& script : lookups) {
+            if (use_filter && !filter.MayContain(script)) continue;
+            found += cached_spks.count(script);
+        }
+        assert(found == 0);
+    });
+}
+
+static void WalletIsMineScriptCacheMap(benchmark::Bench& bench) { WalletIsMineScriptCache(bench, /*use_filter=*/false); }
+static void WalletIsMineScriptCacheFilter(benchmark::Bench& bench) { WalletIsMineScriptCache(bench, /*use_filter=*/true); }
+BENCHMARK(WalletIsMineScriptCacheMap, benchmark::PriorityLevel::HIGH);
+BENCHMARK(WalletIsMineScriptCacheFilter, benchmark::PriorityLevel::HIGH);
+
 #ifdef USE_BDB
 static void WalletIsMineLegacy(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/true); }
 BENCHMARK(WalletIsMineLegacy, benchmark::PriorityLevel::LOW);
@@ -0,0 +1,58 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <interfaces/chain.h>
+#include <kernel/chainparams.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/time.h>
+#include <validation.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+#include <cassert>
+#include <memory>
+#include <string>
+
+namespace wallet {
+static void WalletRescan(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+
+    // Set clock to genesis block, so the descriptors creation time doesn't skip any of the blocks generated below.
+    SetMockTime(test_setup->m_node.chainman->GetParams().GenesisBlock().nTime);
+    CWallet wallet{test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase()};
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet.SetupDescriptorScriptPubKeyMans();
+    }
+    auto handler = test_setup->m_node.chain->handleNotifications({&wallet, [](CWallet*) {}});
+
+    const std::string address_mine{getnewaddress(wallet)};
+    for (int i = 0; i < 100; ++i) {
+        generatetoaddress(test_setup->m_node, address_mine);
+        for (int j = 0; j < 4; ++j) generatetoaddress(test_setup->m_node, ADDRESS_BCRT1_UNSPENDABLE);
+    }
+    // Calls SyncWithValidationInterfaceQueue
+    wallet.chain().waitForNotificationsIfTipChanged(uint256::ZERO);
+    const int tip_height{WITH_LOCK(wallet.cs_wallet, return wallet.GetLastBlockHeight())};
+    const uint256 genesis_hash{test_setup->m_node.chainman->GetParams().GenesisBlock().GetHash()};
+
+    bench.run([&] {
+        WalletRescanReserver reserver(wallet);
+        assert(reserver.reserve());
+        const auto result{wallet.ScanForWalletTransactions(genesis_hash, /*start_height=*/0, /*max_height=*/{}, reserver, /*fUpdate=*/true, /*save_progress=*/false)};
+        assert(result.status == CWallet::ScanResult::SUCCESS);
+        assert(result.last_scanned_height == tip_height);
+    });
+}
+
+BENCHMARK(WalletRescan, benchmark::PriorityLevel::HIGH);
+} // namespace wallet
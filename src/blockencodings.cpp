@@ -17,6 +17,9 @@
 
 #include <unordered_map>
 
+/** Size of the bitset used to rule out mempool transactions whose short ID is not in a compact block. */
+static constexpr size_t SHORTID_FILTER_BITS{1 << 18};
+
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce) :
         nonce(nonce),
         shorttxids(block.vtx.size() - 1), prefilledtxn(1), header(block) {
@@ -104,15 +107,25 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     if (shorttxids.size() != cmpctblock.shorttxids.size())
         return READ_STATUS_FAILED; // Short ID collision
 
+    // Every mempool transaction's short ID is checked against this bitset before looking it up
+    // in shorttxids. Unlike shorttxids it stays in the CPU cache, and it rules out all but a few
+    // percent of the mempool.
+    std::vector<uint64_t> shortid_filter(SHORTID_FILTER_BITS / 64);
+    for (const uint64_t shortid : cmpctblock.shorttxids) {
+        shortid_filter[shortid % SHORTID_FILTER_BITS / 64] |= uint64_t{1} << (shortid % 64);
+    }
+
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (const auto& tx : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(tx->GetWitnessHash());
+    // Scan the witness hashes, which are stored contiguously, rather than the transactions.
+    for (size_t i = 0; i < pool->wtxids_randomized.size(); i++) {
+        uint64_t shortid = cmpctblock.GetShortID(pool->wtxids_randomized[i]);
+        if (!((shortid_filter[shortid % SHORTID_FILTER_BITS / 64] >> (shortid % 64)) & 1)) continue;
         std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
         if (idit != shorttxids.end()) {
             if (!have_txn[idit->second]) {
-                txn_available[idit->second] = tx;
+                txn_available[idit->second] = pool->txns_randomized[i];
                 have_txn[idit->second]  = true;
                 mempool_count++;
             } else {
@@ -249,6 +249,43 @@ private:
     uint256 hashBlock;
 };
 
+/**
+ * Consistent point-in-time view of the coins in a CCoinsView, whose key space
+ * is split into ranges by the first two bytes of the txid. Cursors over
+ * disjoint ranges can be created and used concurrently from different threads,
+ * e.g. to compute statistics over the whole UTXO set in parallel.
+ */
+class CCoinsViewSnapshot
+{
+public:
+    //! Number of distinct txid prefixes that ranges are expressed in.
+    static constexpr uint32_t NUM_PREFIXES{1 << 16};
+    //! Number of ranges a parallel scan of the whole snapshot is split into.
+    //! Each range holds about 1/4096th of the coins, which keeps the results
+    //! buffered per range small.
+    static constexpr uint32_t NUM_SCAN_RANGES{1 << 12};
+
+    CCoinsViewSnapshot(const uint256& hashBlockIn) : hashBlock(hashBlockIn) {}
+    virtual ~CCoinsViewSnapshot() = default;
+
+    //! Get a cursor over the coins whose txid prefix is in [prefix_begin, prefix_end),
+    //! where the prefix is the first two bytes of the txid, read big endian.
+    //! Coins are returned in the same order as from CCoinsView::Cursor().
+    virtual std::unique_ptr<CCoinsViewCursor> Cursor(uint32_t prefix_begin, uint32_t prefix_end) const = 0;
+
+    //! Get best block at the time this snapshot was taken
+    const uint256& GetBestBlock() const { return hashBlock; }
+
+    //! Get the txid prefix of an outpoint, as used to select ranges.
+    static uint32_t Prefix(const COutPoint& outpoint)
+    {
+        return (std::to_integer<uint32_t>(outpoint.hash.data()[0]) << 8) | std::to_integer<uint32_t>(outpoint.hash.data()[1]);
+    }
+
+private:
+    uint256 hashBlock;
+};
+
 /**
  * Cursor for iterating over the linked list of flagged entries in CCoinsViewCache.
  *
@@ -331,6 +368,10 @@ public:
     //! Get a cursor to iterate over the whole state
     virtual std::unique_ptr<CCoinsViewCursor> Cursor() const;
 
+    //! Get a snapshot of the whole state that can be iterated in parallel
+    //! ranges, or nullptr if this is not supported by the view.
+    virtual std::unique_ptr<CCoinsViewSnapshot> Snapshot() const;
+
     //! As we use CCoinsViews polymorphically, have a virtual destructor
     virtual ~CCoinsView() = default;
 
@@ -354,6 +395,7 @@ public:
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::unique_ptr<CCoinsViewSnapshot> Snapshot() const override;
     size_t EstimateSize() const override;
 };
 
@@ -395,6 +437,8 @@ public:
     std::unique_ptr<CCoinsViewCursor> Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
+    //! Not supported, the cached changes would be missing from a snapshot of the base view
+    std::unique_ptr<CCoinsViewSnapshot> Snapshot() const override { return nullptr; }
 
     /**
      * Check if we have the given utxo already loaded in this cache.
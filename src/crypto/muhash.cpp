@@ -76,14 +76,15 @@ inline void muln2(limb_t& c0, limb_t& c1, const limb_t& n)
 /** [c0,c1,c2] += a * b */
 inline void muladd3(limb_t& c0, limb_t& c1, limb_t& c2, const limb_t& a, const limb_t& b)
 {
+    // Accumulate [c0,c1] as a single double limb, so that compilers can emit
+    // one widening multiply followed by an add/adc/adc carry chain (or
+    // mulx/adcx when targeting BMI2/ADX) instead of two compare-and-carry steps.
     double_limb_t t = (double_limb_t)a * b;
-    limb_t th = t >> LIMB_SIZE;
-    limb_t tl = t;
-
-    c0 += tl;
-    th += (c0 < tl) ? 1 : 0;
-    c1 += th;
-    c2 += (c1 < th) ? 1 : 0;
+    double_limb_t c = ((double_limb_t)c1 << LIMB_SIZE) | c0;
+    c += t;
+    c2 += (c < t) ? 1 : 0;
+    c0 = c;
+    c1 = c >> LIMB_SIZE;
 }
 
 /**
@@ -396,6 +396,34 @@ CDBIterator* CDBWrapper::NewIterator()
     return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(DBContext().iteroptions))};
 }
 
+struct CDBSnapshot::SnapshotImpl {
+    leveldb::DB* const db;
+    const leveldb::Snapshot* const snapshot;
+    leveldb::ReadOptions iteroptions;
+
+    SnapshotImpl(leveldb::DB* _db, const leveldb::ReadOptions& _iteroptions)
+        : db{_db}, snapshot{_db->GetSnapshot()}, iteroptions{_iteroptions}
+    {
+        iteroptions.snapshot = snapshot;
+    }
+    ~SnapshotImpl() { db->ReleaseSnapshot(snapshot); }
+};
+
+CDBSnapshot::CDBSnapshot(const CDBWrapper& _parent, std::unique_ptr<SnapshotImpl> _psnapshot) : parent(_parent),
+                                                                                                m_impl_snapshot(std::move(_psnapshot)) {}
+
+CDBSnapshot::~CDBSnapshot() = default;
+
+CDBIterator* CDBSnapshot::NewIterator() const
+{
+    return new CDBIterator{parent, std::make_unique<CDBIterator::IteratorImpl>(m_impl_snapshot->db->NewIterator(m_impl_snapshot->iteroptions))};
+}
+
+std::unique_ptr<CDBSnapshot> CDBWrapper::NewSnapshot() const
+{
+    return std::make_unique<CDBSnapshot>(*this, std::make_unique<CDBSnapshot::SnapshotImpl>(DBContext().pdb, DBContext().iteroptions));
+}
+
 void CDBIterator::SeekImpl(Span<const std::byte> key)
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
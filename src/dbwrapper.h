@@ -177,6 +177,39 @@ public:
     }
 };
 
+/**
+ * Consistent point-in-time view of a CDBWrapper. Iterators created from a
+ * snapshot do not observe writes made to the database after the snapshot was
+ * taken. The snapshot must not outlive the database it was taken from.
+ */
+class CDBSnapshot
+{
+public:
+    struct SnapshotImpl;
+
+private:
+    const CDBWrapper& parent;
+    const std::unique_ptr<SnapshotImpl> m_impl_snapshot;
+
+public:
+    /**
+     * @param[in] _parent          Parent CDBWrapper instance.
+     * @param[in] _psnapshot       The leveldb snapshot.
+     */
+    CDBSnapshot(const CDBWrapper& _parent, std::unique_ptr<SnapshotImpl> _psnapshot);
+    ~CDBSnapshot();
+
+    CDBSnapshot(const CDBSnapshot&) = delete;
+    CDBSnapshot& operator=(const CDBSnapshot&) = delete;
+
+    /**
+     * Create an iterator over the snapshot. A single iterator must not be
+     * shared between threads, but several iterators of the same snapshot may
+     * be used concurrently.
+     */
+    CDBIterator* NewIterator() const;
+};
+
 struct LevelDBContext;
 
 class CDBWrapper
@@ -278,6 +311,9 @@ public:
 
     CDBIterator* NewIterator();
 
+    //! Take a snapshot of the current state of the database.
+    std::unique_ptr<CDBSnapshot> NewSnapshot() const;
+
     /**
      * Return true if the database managed by this class contains no entries.
      */
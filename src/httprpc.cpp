@@ -18,6 +18,7 @@
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -153,6 +154,38 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return multiUserAuthorized(strUserPass);
 }
 
+/** Write a JSON-RPC reply object in parts, with the parts of its result in
+ *  place of the null result it holds, see JSONRPCRequest::m_result_parts. */
+static std::function<std::optional<std::string>()> JSONRPCReplyParts(const UniValue& reply, std::function<std::optional<std::string>()> result_parts)
+{
+    const std::vector<std::string>& keys{reply.getKeys()};
+    const std::vector<UniValue>& values{reply.getValues()};
+    std::string head{"{"};
+    size_t i{0};
+    for (; i < keys.size() && keys[i] != "result"; ++i) {
+        head += UniValue{keys[i]}.write() + ':' + values[i].write() + ',';
+    }
+    head += "\"result\":";
+    std::string tail;
+    for (++i; i < keys.size(); ++i) {
+        tail += ',' + UniValue{keys[i]}.write() + ':' + values[i].write();
+    }
+    tail += "}\n";
+    return [head = std::move(head), tail = std::move(tail), result_parts = std::move(result_parts), stage = 0]() mutable -> std::optional<std::string> {
+        switch (stage) {
+        case 0:
+            stage = 1;
+            return std::move(head);
+        case 1:
+            if (auto part{result_parts()}) return part;
+            stage = 2;
+            return std::move(tail);
+        default:
+            return std::nullopt;
+        }
+    };
+}
+
 static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
 {
     // JSONRPC handles only POST
@@ -214,13 +247,21 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
+            std::function<std::optional<std::string>()> result_parts;
+            if (!jreq.IsNotification()) jreq.m_result_parts = &result_parts;
             reply = JSONRPCExec(jreq, catch_errors);
+            jreq.m_result_parts = nullptr;
 
             if (jreq.IsNotification()) {
                 // Even though we do execute notifications, we do not respond to them
                 req->WriteReply(HTTP_NO_CONTENT);
                 return true;
             }
+            if (result_parts && reply.find_value("error").isNull()) {
+                req->WriteHeader("Content-Type", "application/json");
+                req->WriteReplyParts(JSONRPCReplyParts(reply, std::move(result_parts)));
+                return true;
+            }
 
         // array of requests
         } else if (valRequest.isArray()) {
@@ -55,9 +55,15 @@ public:
         req(std::move(_req)), path(_path), func(_func)
     {
     }
+    /** Continue a reply sent in parts, see HTTPRequest::WriteReplyParts */
+    explicit HTTPWorkItem(std::unique_ptr<HTTPRequest> _req):
+        req(std::move(_req))
+    {
+    }
     void operator()() override
     {
-        func(req.get(), path);
+        if (func) func(req.get(), path);
+        if (req->m_next_part) HTTPRequest::SendReplyParts(std::move(req));
     }
 
     std::unique_ptr<HTTPRequest> req;
@@ -206,6 +212,71 @@ public:
 //! Track active requests
 static HTTPRequestTracker g_requests;
 
+/** Connection close callback, see http_request_cb */
+static void http_connection_close_cb(evhttp_connection* conn, void* arg)
+{
+    g_requests.RemoveConnection(conn);
+}
+
+/**
+ * State shared between the worker threads producing a reply in parts and the
+ * main http thread sending it. While too much of the reply is queued for a
+ * slow client, the request is parked here instead of holding on to a worker,
+ * and it is handed back to a worker once the queued parts were sent.
+ */
+struct HTTPReplyStream
+{
+    Mutex m_mutex;
+    //! Bytes handed to the main thread and not yet written to the socket
+    size_t m_bytes_queued GUARDED_BY(m_mutex){0};
+    //! Whether the client connection was closed while the reply was sent
+    bool m_closed GUARDED_BY(m_mutex){false};
+    //! Request waiting for the queued parts to be sent before more are produced
+    std::unique_ptr<HTTPRequest> m_waiting GUARDED_BY(m_mutex);
+
+    void Drained() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::unique_ptr<HTTPRequest> waiting;
+        {
+            LOCK(m_mutex);
+            m_bytes_queued = 0;
+            waiting = std::move(m_waiting);
+        }
+        if (waiting) Resume(std::move(waiting));
+    }
+    void Close() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::unique_ptr<HTTPRequest> waiting;
+        {
+            LOCK(m_mutex);
+            m_closed = true;
+            waiting = std::move(m_waiting);
+        }
+        if (waiting) Resume(std::move(waiting));
+    }
+
+private:
+    /** Hand a parked request back to a worker. Called from the main http thread. */
+    static void Resume(std::unique_ptr<HTTPRequest> req)
+    {
+        std::unique_ptr<HTTPWorkItem> item{new HTTPWorkItem(std::move(req))};
+        if (g_work_queue->Enqueue(item.get())) {
+            item.release(); /* if true, queue took ownership */
+        } else {
+            // The queue is full or shutting down. Produce the next parts here,
+            // without waiting for the client on shutdown, so the request is not lost.
+            HTTPRequest::SendReplyParts(std::move(item->req));
+        }
+    }
+};
+
+/** Connection close callback while a chunked reply is being sent on it */
+static void http_stream_close_cb(evhttp_connection* conn, void* arg)
+{
+    http_connection_close_cb(conn, nullptr);
+    static_cast<HTTPReplyStream*>(arg)->Close();
+}
+
 /** Check if a network address is allowed to access the HTTP server */
 static bool ClientAllowed(const CNetAddr& netaddr)
 {
@@ -268,9 +339,7 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
         evhttp_request_set_on_complete_cb(req, [](struct evhttp_request* req, void*) {
             g_requests.RemoveRequest(req);
         }, nullptr);
-        evhttp_connection_set_closecb(conn, [](evhttp_connection* conn, void* arg) {
-            g_requests.RemoveConnection(conn);
-        }, nullptr);
+        evhttp_connection_set_closecb(conn, http_connection_close_cb, nullptr);
     }
 
     // Disable reading to work around a libevent bug, fixed in 2.1.9
@@ -644,6 +713,89 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
     evhttp_add_header(headers, hdr.c_str(), value.c_str());
 }
 
+void HTTPRequest::WriteReplyParts(std::function<std::optional<std::string>()> next_part)
+{
+    assert(!replySent && req && !m_next_part && next_part);
+    m_next_part = std::move(next_part);
+}
+
+void HTTPRequest::SendReplyParts(std::unique_ptr<HTTPRequest> request)
+{
+    HTTPRequest& self{*request};
+    if (!self.m_reply_stream) {
+        if (self.m_interrupt) {
+            self.WriteHeader("Connection", "close");
+        }
+        self.m_reply_stream = std::make_shared<HTTPReplyStream>();
+        auto req_copy = self.req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, stream = self.m_reply_stream] {
+            evhttp_send_reply_start(req_copy, HTTP_OK, nullptr);
+            // Resume the request if the client goes away before the reply is complete.
+            if (evhttp_connection* conn = evhttp_request_get_connection(req_copy)) {
+                evhttp_connection_set_closecb(conn, http_stream_close_cb, stream.get());
+            } else {
+                stream->Close();
+            }
+        });
+        ev->trigger(nullptr);
+    }
+
+    HTTPReplyStream& stream{*self.m_reply_stream};
+    while (true) {
+        {
+            LOCK(stream.m_mutex);
+            if (stream.m_closed) break;
+            // A parked request could not be handed back to a worker on
+            // shutdown, so the rest of the reply is sent without waiting.
+            if (stream.m_bytes_queued >= HTTP_REPLY_STREAM_MAX_QUEUED && !self.m_interrupt) {
+                stream.m_waiting = std::move(request);
+                return;
+            }
+        }
+        std::optional<std::string> part;
+        try {
+            part = self.m_next_part();
+        } catch (const std::exception& e) {
+            LogPrintf("%s: Reply to %s cut short: %s\n", __func__, self.GetURI(), e.what());
+            break;
+        }
+        if (!part) break;
+        self.QueueReplyPart(std::as_bytes(std::span{*part}));
+    }
+    self.m_next_part = nullptr;
+    self.WriteReply(HTTP_OK);
+}
+
+/** Send a part of the reply as a chunk from the main http thread, unless the
+ * client went away.
+ */
+void HTTPRequest::QueueReplyPart(std::span<const std::byte> data)
+{
+    if (data.empty()) return;
+    {
+        LOCK(m_reply_stream->m_mutex);
+        if (m_reply_stream->m_closed) return;
+        m_reply_stream->m_bytes_queued += data.size();
+    }
+
+    struct evbuffer* evb = evbuffer_new();
+    assert(evb);
+    evbuffer_add(evb, data.data(), data.size());
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, evb, stream = m_reply_stream] {
+        if (evhttp_request_get_connection(req_copy)) {
+            // Called once everything queued on the connection has been written out.
+            evhttp_send_reply_chunk_with_cb(req_copy, evb, [](evhttp_connection*, void* arg) {
+                static_cast<HTTPReplyStream*>(arg)->Drained();
+            }, stream.get());
+        } else {
+            stream->Close();
+        }
+        evbuffer_free(evb);
+    });
+    ev->trigger(nullptr);
+}
+
 /** Closure sent to main thread to request a reply to be sent to
  * a HTTP request.
  * Replies must be sent in the main loop in the main http thread,
@@ -652,6 +804,33 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
 {
     assert(!replySent && req);
+    if (m_reply_stream) {
+        // The status line was sent with the first part.
+        Assume(nStatus == HTTP_OK);
+        QueueReplyPart(reply);
+        auto req_copy = req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, stream = m_reply_stream] {
+            if (evhttp_connection* conn = evhttp_request_get_connection(req_copy)) {
+                evhttp_connection_set_closecb(conn, http_connection_close_cb, nullptr);
+            }
+            evhttp_send_reply_end(req_copy);
+            // Re-enable reading from the socket. This is the second part of the libevent
+            // workaround in http_request_cb.
+            if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
+                evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+                if (conn) {
+                    bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+                    if (bev) {
+                        bufferevent_enable(bev, EV_READ | EV_WRITE);
+                    }
+                }
+            }
+        });
+        ev->trigger(nullptr);
+        replySent = true;
+        req = nullptr; // transferred back to main thread
+        return;
+    }
     if (m_interrupt) {
         WriteHeader("Connection", "close");
     }
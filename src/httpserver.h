@@ -6,6 +6,7 @@
 #define BITCOIN_HTTPSERVER_H
 
 #include <functional>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
@@ -27,10 +28,15 @@ static const int DEFAULT_HTTP_WORKQUEUE=64;
 
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
 
+/** Reply bytes queued for a client before the rest of a reply sent in parts is produced. */
+static const size_t HTTP_REPLY_STREAM_MAX_QUEUED{1 << 20};
+
 struct evhttp_request;
 struct event_base;
 class CService;
 class HTTPRequest;
+struct HTTPReplyStream;
+class HTTPWorkItem;
 
 /** Initialize HTTP server.
  * Call this before RegisterHTTPHandler or EventBase().
@@ -73,6 +79,17 @@ private:
     struct evhttp_request* req;
     const util::SignalInterrupt& m_interrupt;
     bool replySent;
+    //! Produces the rest of a reply sent in parts, see WriteReplyParts
+    std::function<std::optional<std::string>()> m_next_part;
+    //! Set once the first part of the reply was sent
+    std::shared_ptr<HTTPReplyStream> m_reply_stream;
+
+    friend class HTTPWorkItem;
+    friend struct HTTPReplyStream;
+    /** Send the reply parts produced by m_next_part until the reply is complete,
+     *  or park the request on its stream while too much of it waits for the client. */
+    static void SendReplyParts(std::unique_ptr<HTTPRequest> request);
+    void QueueReplyPart(std::span<const std::byte> data);
 
 public:
     explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
@@ -130,10 +147,24 @@ public:
      */
     void WriteHeader(const std::string& hdr, const std::string& value);
 
+    /**
+     * Reply with HTTP_OK and a body produced in parts by next_part, using
+     * chunked transfer encoding. next_part returns the next part of the body,
+     * or std::nullopt once it is complete. It is called on the worker threads
+     * after the handler returned, whenever less than HTTP_REPLY_STREAM_MAX_QUEUED
+     * bytes wait to be sent to the client, so a large reply is never held in
+     * memory and a slow client does not hold on to a worker in between.
+     *
+     * @note Like WriteReply, this can be called only once and must be the last
+     * call on the request. next_part must stay valid after the handler returned.
+     */
+    void WriteReplyParts(std::function<std::optional<std::string>()> next_part);
+
     /**
      * Write HTTP reply.
      * nStatus is the HTTP status code to send.
-     * reply is the body of the reply. Keep it empty to send a standard message.
+     * reply is the body of the reply.
+     * Keep it empty to send a standard message.
      *
      * @note Can be called only once. As this will give the request back to the
      * main thread, do not call any other HTTPRequest methods after calling this.
@@ -0,0 +1,366 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addressindex.h>
+
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <undo.h>
+#include <validation.h>
+
+static constexpr uint8_t DB_ADDRESS_HISTORY{'h'};
+static constexpr uint8_t DB_ADDRESS_UNSPENT{'u'};
+static constexpr uint8_t DB_ADDRESS_BALANCE{'b'};
+
+std::unique_ptr<AddressIndex> g_address_index;
+
+namespace {
+
+/** History entries are ordered by script, then height, so that the history
+ *  of a script within a height range is a single contiguous key range. */
+struct DBHistoryKey {
+    uint256 script_hash;
+    int height{0};
+    Txid txid;
+    uint32_t index{0};
+    bool spent{false};
+
+    DBHistoryKey() = default;
+    DBHistoryKey(const uint256& script_hash_in, int height_in, const Txid& txid_in, uint32_t index_in, bool spent_in)
+        : script_hash(script_hash_in), height(height_in), txid(txid_in), index(index_in), spent(spent_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_ADDRESS_HISTORY);
+        s << script_hash;
+        ser_writedata32be(s, height);
+        s << txid;
+        ser_writedata32be(s, index);
+        ser_writedata8(s, spent);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_ADDRESS_HISTORY) {
+            throw std::ios_base::failure("Invalid format for addressindex DB history key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+        s >> txid;
+        index = ser_readdata32be(s);
+        spent = ser_readdata8(s) != 0;
+    }
+};
+
+struct DBUnspentKey {
+    uint256 script_hash;
+    COutPoint outpoint;
+
+    DBUnspentKey() = default;
+    DBUnspentKey(const uint256& script_hash_in, const COutPoint& outpoint_in)
+        : script_hash(script_hash_in), outpoint(outpoint_in) {}
+
+    SERIALIZE_METHODS(DBUnspentKey, obj)
+    {
+        uint8_t prefix{DB_ADDRESS_UNSPENT};
+        READWRITE(prefix);
+        if (prefix != DB_ADDRESS_UNSPENT) {
+            throw std::ios_base::failure("Invalid format for addressindex DB unspent key");
+        }
+        READWRITE(obj.script_hash, obj.outpoint);
+    }
+};
+
+struct DBBalanceKey {
+    uint256 script_hash;
+
+    explicit DBBalanceKey(const uint256& script_hash_in) : script_hash(script_hash_in) {}
+
+    SERIALIZE_METHODS(DBBalanceKey, obj)
+    {
+        uint8_t prefix{DB_ADDRESS_BALANCE};
+        READWRITE(prefix);
+        if (prefix != DB_ADDRESS_BALANCE) {
+            throw std::ios_base::failure("Invalid format for addressindex DB balance key");
+        }
+        READWRITE(obj.script_hash);
+    }
+};
+
+struct DBUnspentValue {
+    CAmount amount{0};
+    int height{0};
+
+    SERIALIZE_METHODS(DBUnspentValue, obj) { READWRITE(obj.amount, obj.height); }
+};
+
+/** Index entries produced by a single block. */
+struct BlockAddressDelta {
+    std::vector<std::pair<DBHistoryKey, CAmount>> history;
+    std::vector<std::pair<DBUnspentKey, DBUnspentValue>> created;
+    std::vector<DBUnspentKey> spent;
+    //! Change of the running totals of each script
+    std::map<uint256, AddressBalance> balance_changes;
+};
+
+} // namespace
+
+/** Access to the addressindex database (indexes/addressindex/) */
+class AddressIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the entries of a block to the DB.
+    [[nodiscard]] bool WriteDelta(const BlockAddressDelta& delta);
+
+    /// Add changes to the running totals stored in the DB to a batch.
+    [[nodiscard]] bool ApplyBalanceChanges(const std::map<uint256, AddressBalance>& balance_changes, CDBBatch& batch);
+};
+
+AddressIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "addressindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool AddressIndex::DB::WriteDelta(const BlockAddressDelta& delta)
+{
+    CDBBatch batch(*this);
+    for (const auto& [key, amount] : delta.history) {
+        batch.Write(key, amount);
+    }
+    // Outputs created and spent within the same block must end up erased, so
+    // all creations are written before any spends.
+    for (const auto& [key, value] : delta.created) {
+        batch.Write(key, value);
+    }
+    for (const auto& key : delta.spent) {
+        batch.Erase(key);
+    }
+    return ApplyBalanceChanges(delta.balance_changes, batch) && WriteBatch(batch);
+}
+
+bool AddressIndex::DB::ApplyBalanceChanges(const std::map<uint256, AddressBalance>& balance_changes, CDBBatch& batch)
+{
+    for (const auto& [script_hash, change] : balance_changes) {
+        const DBBalanceKey key{script_hash};
+        AddressBalance balance;
+        if (Exists(key) && !Read(key, balance)) {
+            LogError("%s: unable to read balance in addressindex\n", __func__);
+            return false;
+        }
+        balance += change;
+        if (balance.balance == 0 && balance.received == 0 && balance.unspent == 0) {
+            batch.Erase(key);
+        } else {
+            batch.Write(key, balance);
+        }
+    }
+    return true;
+}
+
+AddressIndex::AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "addressindex"), m_db(std::make_unique<AddressIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+AddressIndex::~AddressIndex() = default;
+
+uint256 AddressIndex::GetScriptHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+bool AddressIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any delta;
+    return CustomProcessBlock(block, delta) && CustomPostProcessBlock(block, std::move(delta));
+}
+
+bool AddressIndex::CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result)
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return true;
+
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
+    CBlockUndo block_undo;
+    if (!m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
+        return false;
+    }
+
+    assert(block.data);
+    BlockAddressDelta delta;
+    for (size_t i = 0; i < block.data->vtx.size(); ++i) {
+        const auto& tx{block.data->vtx.at(i)};
+
+        // Skip duplicate txid coinbase transactions (BIP30), their outputs
+        // were overwritten in the UTXO set and can never be spent.
+        if (IsBIP30Unspendable(*pindex) && tx->IsCoinBase()) continue;
+
+        for (uint32_t j = 0; j < tx->vout.size(); ++j) {
+            const CTxOut& out{tx->vout[j]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+
+            const uint256 script_hash{GetScriptHash(out.scriptPubKey)};
+            delta.history.emplace_back(DBHistoryKey{script_hash, block.height, tx->GetHash(), j, /*spent_in=*/false}, out.nValue);
+            delta.created.emplace_back(DBUnspentKey{script_hash, COutPoint{tx->GetHash(), j}}, DBUnspentValue{out.nValue, block.height});
+            delta.balance_changes[script_hash] += AddressBalance{.balance = out.nValue, .received = out.nValue, .unspent = 1};
+        }
+
+        // The coinbase tx has no undo data since no former output is spent
+        if (!tx->IsCoinBase()) {
+            const auto& tx_undo{block_undo.vtxundo.at(i - 1)};
+
+            for (uint32_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout[j]};
+                const uint256 script_hash{GetScriptHash(coin.out.scriptPubKey)};
+                delta.history.emplace_back(DBHistoryKey{script_hash, block.height, tx->GetHash(), j, /*spent_in=*/true}, -coin.out.nValue);
+                delta.spent.emplace_back(script_hash, tx->vin[j].prevout);
+                delta.balance_changes[script_hash] += AddressBalance{.balance = -coin.out.nValue, .unspent = -1};
+            }
+        }
+    }
+
+    result = std::move(delta);
+    return true;
+}
+
+bool AddressIndex::CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result)
+{
+    if (!result.has_value()) return true;
+    return m_db->WriteDelta(std::any_cast<const BlockAddressDelta&>(result));
+}
+
+bool AddressIndex::CustomRewind(const interfaces::BlockRef& current_tip, const interfaces::BlockRef& new_tip)
+{
+    CDBBatch batch(*m_db);
+    std::map<uint256, AddressBalance> balance_changes;
+    {
+        LOCK(cs_main);
+        const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+        const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+        // Blocks are reversed from the tip down, so that an output spent in a
+        // later block is restored before the block creating it erases it.
+        do {
+            CBlock block;
+
+            if (!m_chainstate->m_blockman.ReadBlock(block, *iter_tip)) {
+                LogError("%s: Failed to read block %s from disk\n",
+                             __func__, iter_tip->GetBlockHash().ToString());
+                return false;
+            }
+
+            if (!ReverseBlock(block, *iter_tip, batch, balance_changes)) {
+                return false; // failure cause logged internally
+            }
+
+            iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+        } while (new_tip_index != iter_tip);
+    }
+
+    return m_db->ApplyBalanceChanges(balance_changes, batch) && m_db->WriteBatch(batch);
+}
+
+// Reverse a single block as part of a reorg
+bool AddressIndex::ReverseBlock(const CBlock& block, const CBlockIndex& block_index, CDBBatch& batch, std::map<uint256, AddressBalance>& balance_changes)
+{
+    if (block_index.nHeight == 0) return true;
+
+    CBlockUndo block_undo;
+    if (!m_chainstate->m_blockman.ReadBlockUndo(block_undo, block_index)) {
+        return false;
+    }
+
+    // Restore the outputs spent by the block first, so that outputs created
+    // and spent within the block are erased again below.
+    for (size_t i = 1; i < block.vtx.size(); ++i) {
+        const auto& tx{block.vtx.at(i)};
+        const auto& tx_undo{block_undo.vtxundo.at(i - 1)};
+
+        for (uint32_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+            const Coin& coin{tx_undo.vprevout[j]};
+            const uint256 script_hash{GetScriptHash(coin.out.scriptPubKey)};
+            batch.Erase(DBHistoryKey{script_hash, block_index.nHeight, tx->GetHash(), j, /*spent_in=*/true});
+            batch.Write(DBUnspentKey{script_hash, tx->vin[j].prevout}, DBUnspentValue{coin.out.nValue, static_cast<int>(coin.nHeight)});
+            balance_changes[script_hash] += AddressBalance{.balance = coin.out.nValue, .unspent = 1};
+        }
+    }
+
+    for (const auto& tx : block.vtx) {
+        // Skip duplicate txid coinbase transactions (BIP30), like CustomProcessBlock
+        if (IsBIP30Unspendable(block_index) && tx->IsCoinBase()) continue;
+
+        for (uint32_t j = 0; j < tx->vout.size(); ++j) {
+            const CTxOut& out{tx->vout[j]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+
+            const uint256 script_hash{GetScriptHash(out.scriptPubKey)};
+            batch.Erase(DBHistoryKey{script_hash, block_index.nHeight, tx->GetHash(), j, /*spent_in=*/false});
+            batch.Erase(DBUnspentKey{script_hash, COutPoint{tx->GetHash(), j}});
+            balance_changes[script_hash] += AddressBalance{.balance = -out.nValue, .received = -out.nValue, .unspent = -1};
+        }
+    }
+
+    return true;
+}
+
+BaseIndex::DB& AddressIndex::GetDB() const { return *m_db; }
+
+bool AddressIndex::LookUpHistory(const CScript& script, int start_height, int end_height, std::vector<AddressHistoryEntry>& entries) const
+{
+    const uint256 script_hash{GetScriptHash(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    db_it->Seek(DBHistoryKey{script_hash, std::max(start_height, 0), Txid{}, 0, false});
+
+    DBHistoryKey key;
+    while (db_it->Valid() && db_it->GetKey(key) && key.script_hash == script_hash && key.height <= end_height) {
+        CAmount amount;
+        if (!db_it->GetValue(amount)) {
+            LogError("%s: unable to read value in %s at height %d\n", __func__, GetName(), key.height);
+            return false;
+        }
+        entries.push_back({key.height, key.txid, key.index, key.spent, amount});
+        db_it->Next();
+    }
+    return true;
+}
+
+bool AddressIndex::LookUpUnspent(const CScript& script, std::vector<AddressUnspentEntry>& entries) const
+{
+    const uint256 script_hash{GetScriptHash(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    db_it->Seek(DBUnspentKey{script_hash, COutPoint{Txid{}, 0}});
+
+    DBUnspentKey key;
+    while (db_it->Valid() && db_it->GetKey(key) && key.script_hash == script_hash) {
+        DBUnspentValue value;
+        if (!db_it->GetValue(value)) {
+            LogError("%s: unable to read value in %s for %s\n", __func__, GetName(), key.outpoint.ToString());
+            return false;
+        }
+        entries.push_back({key.outpoint, value.height, value.amount});
+        db_it->Next();
+    }
+    return true;
+}
+
+bool AddressIndex::LookUpBalance(const CScript& script, AddressBalance& balance) const
+{
+    const DBBalanceKey key{GetScriptHash(script)};
+    balance = AddressBalance{};
+    if (!m_db->Exists(key)) return true;
+    if (!m_db->Read(key, balance)) {
+        LogError("%s: unable to read balance in %s\n", __func__, GetName());
+        return false;
+    }
+    return true;
+}
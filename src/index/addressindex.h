@@ -0,0 +1,134 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_ADDRESSINDEX_H
+#define BITCOIN_INDEX_ADDRESSINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+class CDBBatch;
+class CScript;
+
+static constexpr bool DEFAULT_ADDRESSINDEX{false};
+
+/** A single credit or debit of a script, as recorded in the address index. */
+struct AddressHistoryEntry {
+    int height;
+    //! Transaction creating (credit) or spending (debit) the output
+    Txid txid;
+    //! Output index for credits, input index for debits
+    uint32_t index;
+    bool spent;
+    //! Positive for credits, negative for debits
+    CAmount amount;
+};
+
+/** An unspent output paying to a script, as recorded in the address index. */
+struct AddressUnspentEntry {
+    COutPoint outpoint;
+    int height;
+    CAmount amount;
+};
+
+/** Running totals of a script, as recorded in the address index. */
+struct AddressBalance {
+    //! Sum of the unspent outputs paying to the script
+    CAmount balance{0};
+    //! Sum of all outputs ever paying to the script
+    CAmount received{0};
+    //! Number of unspent outputs paying to the script
+    int64_t unspent{0};
+
+    SERIALIZE_METHODS(AddressBalance, obj) { READWRITE(obj.balance, obj.received, obj.unspent); }
+
+    AddressBalance& operator+=(const AddressBalance& other)
+    {
+        balance += other.balance;
+        received += other.received;
+        unspent += other.unspent;
+        return *this;
+    }
+};
+
+/**
+ * AddressIndex records, for every output script, the history of outputs
+ * paying to it and of inputs spending those outputs, the set of its outputs
+ * that are currently unspent, and its running totals. Scripts are keyed by
+ * the SHA256 of the scriptPubKey so that entries for all address types have
+ * a fixed size.
+ */
+class AddressIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return false; }
+
+    [[nodiscard]] bool ReverseBlock(const CBlock& block, const CBlockIndex& block_index, CDBBatch& batch, std::map<uint256, AddressBalance>& balance_changes);
+
+protected:
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool AllowParallelSync() const override { return true; }
+
+    bool CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result) override;
+
+    bool CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result) override;
+
+    bool CustomRewind(const interfaces::BlockRef& current_tip, const interfaces::BlockRef& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~AddressIndex() override;
+
+    /// Key under which the entries of a script are stored.
+    static uint256 GetScriptHash(const CScript& script);
+
+    /// Look up the credits and debits of a script within a height range, in
+    /// order of height.
+    ///
+    /// @param[in]   script  The output script to look up.
+    /// @param[in]   start_height  The first height to include.
+    /// @param[in]   end_height  The last height to include.
+    /// @param[out]  entries  The history entries found.
+    /// @return  false if the database could not be read
+    bool LookUpHistory(const CScript& script, int start_height, int end_height, std::vector<AddressHistoryEntry>& entries) const;
+
+    bool LookUpHistory(const CScript& script, std::vector<AddressHistoryEntry>& entries) const
+    {
+        return LookUpHistory(script, 0, std::numeric_limits<int>::max(), entries);
+    }
+
+    /// Look up the outputs paying to a script that are unspent as of the
+    /// index's best block.
+    bool LookUpUnspent(const CScript& script, std::vector<AddressUnspentEntry>& entries) const;
+
+    /// Look up the running totals of a script as of the index's best block.
+    bool LookUpBalance(const CScript& script, AddressBalance& balance) const;
+};
+
+/// The global address index. May be null.
+extern std::unique_ptr<AddressIndex> g_address_index;
+
+#endif // BITCOIN_INDEX_ADDRESSINDEX_H
@@ -16,9 +16,12 @@
 #include <tinyformat.h>
 #include <util/string.h>
 #include <util/thread.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h> // For g_chainman
 
+#include <algorithm>
+#include <future>
 #include <string>
 #include <utility>
 
@@ -183,22 +186,38 @@ void BaseIndex::Sync()
                 FatalErrorf("%s: Failed to rewind index %s to a previous chain tip", __func__, GetName());
                 return;
             }
-            pindex = pindex_next;
-
-
-            CBlock block;
-            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
-                FatalErrorf("%s: Failed to read block %s from disk",
-                           __func__, pindex->GetBlockHash().ToString());
-                return;
+            if (m_thread_pool && AllowParallelSync()) {
+                // Hand a run of consecutive blocks on the active chain to the
+                // thread pool. If the chain is reorganized in the meantime, the
+                // next NextSyncBlock call finds the fork and rewinds as usual.
+                std::vector<const CBlockIndex*> blocks{pindex_next};
+                {
+                    LOCK(cs_main);
+                    while (blocks.size() < static_cast<size_t>(m_sync_batch_size)) {
+                        const CBlockIndex* next{m_chainstate->m_chain.Next(blocks.back())};
+                        if (!next) break;
+                        blocks.push_back(next);
+                    }
+                }
+                pindex = ProcessBlocksParallel(blocks);
+                if (!pindex) return;
             } else {
-                block_info.data = &block;
-            }
-            if (!CustomAppend(block_info)) {
-                FatalErrorf("%s: Failed to write block %s to index database",
-                           __func__, pindex->GetBlockHash().ToString());
-                return;
+                pindex = pindex_next;
+
+                CBlock block;
+                interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
+                if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
+                    FatalErrorf("%s: Failed to read block %s from disk",
+                               __func__, pindex->GetBlockHash().ToString());
+                    return;
+                } else {
+                    block_info.data = &block;
+                }
+                if (!CustomAppend(block_info)) {
+                    FatalErrorf("%s: Failed to write block %s to index database",
+                               __func__, pindex->GetBlockHash().ToString());
+                    return;
+                }
             }
 
             auto current_time{std::chrono::steady_clock::now()};
@@ -224,6 +243,51 @@ void BaseIndex::Sync()
     }
 }
 
+const CBlockIndex* BaseIndex::ProcessBlocksParallel(const std::vector<const CBlockIndex*>& blocks)
+{
+    struct ProcessedBlock {
+        bool read_ok{false};
+        bool process_ok{false};
+        std::any result;
+    };
+
+    std::vector<std::future<ProcessedBlock>> futures;
+    futures.reserve(blocks.size());
+    for (const CBlockIndex* pindex : blocks) {
+        futures.emplace_back(m_thread_pool->Submit([this, pindex] {
+            ProcessedBlock processed;
+            CBlock block;
+            if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) return processed;
+            processed.read_ok = true;
+            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, &block);
+            processed.process_ok = CustomProcessBlock(block_info, processed.result);
+            return processed;
+        }));
+    }
+
+    // Append the results in chain order. On failure, still wait for the
+    // remaining tasks, as they reference this index.
+    const CBlockIndex* last_appended{nullptr};
+    bool failed{false};
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        ProcessedBlock processed{futures[i].get()};
+        if (failed) continue;
+        const CBlockIndex* pindex{blocks[i]};
+        if (!processed.read_ok) {
+            FatalErrorf("%s: Failed to read block %s from disk",
+                       __func__, pindex->GetBlockHash().ToString());
+            failed = true;
+        } else if (!processed.process_ok || !CustomPostProcessBlock(kernel::MakeBlockInfo(pindex), std::move(processed.result))) {
+            FatalErrorf("%s: Failed to write block %s to index database",
+                       __func__, pindex->GetBlockHash().ToString());
+            failed = true;
+        } else {
+            last_appended = pindex;
+        }
+    }
+    return failed ? nullptr : last_appended;
+}
+
 bool BaseIndex::Commit()
 {
     // Don't commit anything if we haven't indexed any block yet
@@ -399,6 +463,13 @@ void BaseIndex::Interrupt()
     m_interrupt();
 }
 
+void BaseIndex::SetThreadPool(ThreadPool& thread_pool, int batch_size)
+{
+    if (m_thread_sync.joinable()) throw std::logic_error("Error: Cannot set the thread pool of a running index");
+    m_thread_pool = &thread_pool;
+    m_sync_batch_size = std::max(batch_size, 1);
+}
+
 bool BaseIndex::StartBackgroundSync()
 {
     if (!m_init) throw std::logic_error("Error: Cannot start a non-initialized index");
@@ -12,16 +12,26 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <any>
 #include <string>
+#include <vector>
 
 class CBlock;
 class CBlockIndex;
 class Chainstate;
 class ChainstateManager;
+class ThreadPool;
 namespace interfaces {
 class Chain;
 } // namespace interfaces
 
+/** Default for -indexworkers, number of threads used to build indexes (0 = sequential) */
+static constexpr int DEFAULT_INDEX_WORKERS{0};
+/** Maximum for -indexworkers */
+static constexpr int MAX_INDEX_WORKERS{64};
+/** Number of blocks processed per batch during a parallel initial sync */
+static constexpr int DEFAULT_INDEX_SYNC_BATCH_SIZE{100};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -80,6 +90,12 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Worker pool used to process blocks concurrently during the initial
+    /// sync. Only used if the index implements AllowParallelSync().
+    ThreadPool* m_thread_pool{nullptr};
+    /// Maximum number of blocks handed to the thread pool at once.
+    int m_sync_batch_size{DEFAULT_INDEX_SYNC_BATCH_SIZE};
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -93,6 +109,12 @@ private:
     /// Loop over disconnected blocks and call CustomRewind.
     bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip);
 
+    /// Read the given consecutive blocks and run CustomProcessBlock on them
+    /// using the thread pool, then call CustomPostProcessBlock in block order.
+    /// Returns the last block that was appended to the index, or nullptr on
+    /// failure.
+    const CBlockIndex* ProcessBlocksParallel(const std::vector<const CBlockIndex*>& blocks);
+
     virtual bool AllowPrune() const = 0;
 
     template <typename... Args>
@@ -113,6 +135,19 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether the index implements CustomProcessBlock and
+    /// CustomPostProcessBlock, so the initial sync can compute block data on
+    /// a thread pool and only write it to the index in block order.
+    virtual bool AllowParallelSync() const { return false; }
+
+    /// Compute the index data for a block without modifying index state. This
+    /// may be called concurrently for different blocks from worker threads.
+    [[nodiscard]] virtual bool CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result) { return true; }
+
+    /// Write index entries computed by CustomProcessBlock. Called for one
+    /// block at a time, in chain order.
+    [[nodiscard]] virtual bool CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result) { return true; }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -150,6 +185,11 @@ public:
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
+    /// Use the given thread pool to process blocks during the initial sync.
+    /// Must be called before StartBackgroundSync, and the pool must outlive
+    /// the sync thread. Indexes that do not support parallel sync ignore it.
+    void SetThreadPool(ThreadPool& thread_pool, int batch_size = DEFAULT_INDEX_SYNC_BATCH_SIZE);
+
     /// Sync the index with the block index starting from the current best block.
     /// Intended to be run in its own thread, m_thread_sync, and can be
     /// interrupted with m_interrupt. Once the index gets in sync, the m_synced
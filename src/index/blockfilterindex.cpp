@@ -249,6 +249,12 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
 }
 
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any filter;
+    return CustomProcessBlock(block, filter) && CustomPostProcessBlock(block, std::move(filter));
+}
+
+bool BlockFilterIndex::CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result)
 {
     CBlockUndo block_undo;
 
@@ -261,8 +267,16 @@ bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
         }
     }
 
-    BlockFilter filter(m_filter_type, *Assert(block.data), block_undo);
+    result = BlockFilter(m_filter_type, *Assert(block.data), block_undo);
+    return true;
+}
+
+bool BlockFilterIndex::CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result)
+{
+    const BlockFilter& filter = std::any_cast<const BlockFilter&>(result);
 
+    // The filter header commits to the previous one, so it is computed here,
+    // in block order, rather than in CustomProcessBlock.
     const uint256& header = filter.ComputeHeader(m_last_header);
     bool res = Write(filter, block.height, header);
     if (res) m_last_header = header; // update last header
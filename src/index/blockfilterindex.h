@@ -58,6 +58,12 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool AllowParallelSync() const override { return true; }
+
+    bool CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result) override;
+
+    bool CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result) override;
+
     bool CustomRewind(const interfaces::BlockRef& current_tip, const interfaces::BlockRef& new_tip) override;
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
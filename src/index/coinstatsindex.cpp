@@ -99,6 +99,24 @@ struct DBHashKey {
     }
 };
 
+/** Changes to the UTXO set statistics caused by a single block. Output count
+ *  and bogo size deltas wrap around like the totals they are applied to. */
+struct BlockStatsDelta {
+    //! Product of the created coins (numerator) and spent coins (denominator)
+    MuHash3072 muhash;
+    uint64_t transaction_output_count{0};
+    uint64_t bogo_size{0};
+    CAmount total_amount{0};
+    CAmount total_subsidy{0};
+    CAmount total_unspendable_amount{0};
+    CAmount total_prevout_spent_amount{0};
+    CAmount total_new_outputs_ex_coinbase_amount{0};
+    CAmount total_coinbase_amount{0};
+    CAmount total_unspendables_genesis_block{0};
+    CAmount total_unspendables_bip30{0};
+    CAmount total_unspendables_scripts{0};
+};
+
 }; // namespace
 
 std::unique_ptr<CoinStatsIndex> g_coin_stats_index;
@@ -113,10 +131,17 @@ CoinStatsIndex::CoinStatsIndex(std::unique_ptr<interfaces::Chain> chain, size_t
 }
 
 bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any delta;
+    return CustomProcessBlock(block, delta) && CustomPostProcessBlock(block, std::move(delta));
+}
+
+bool CoinStatsIndex::CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result)
 {
     CBlockUndo block_undo;
+    BlockStatsDelta delta;
     const CAmount block_subsidy{GetBlockSubsidy(block.height, Params().GetConsensus())};
-    m_total_subsidy += block_subsidy;
+    delta.total_subsidy = block_subsidy;
 
     // Include genesis block
     if (block.height >= 0) {
@@ -127,34 +152,18 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
             return false;
         }
 
-        if (block.height > 0) {
-            std::pair<uint256, DBVal> read_out;
-            if (!m_db->Read(DBHeightKey(block.height - 1), read_out)) {
-                return false;
-            }
-
-            uint256 expected_block_hash{*Assert(block.prev_hash)};
-            if (read_out.first != expected_block_hash) {
-                LogPrintf("WARNING: previous block header belongs to unexpected block %s; expected %s\n",
-                        read_out.first.ToString(), expected_block_hash.ToString());
-
-                if (!m_db->Read(DBHashKey(expected_block_hash), read_out)) {
-                    LogError("%s: previous block header not found; expected %s\n",
-                                __func__, expected_block_hash.ToString());
-                    return false;
-                }
-            }
-        }
-
-        // Add the new utxos created from the block
+        // Add the new utxos created from the block. MuHash is commutative, so
+        // the block's coins are folded into a separate MuHash3072 that is
+        // combined with the running set hash in CustomPostProcessBlock. This
+        // allows multiple blocks to be hashed concurrently.
         assert(block.data);
         for (size_t i = 0; i < block.data->vtx.size(); ++i) {
             const auto& tx{block.data->vtx.at(i)};
 
             // Skip duplicate txid coinbase transactions (BIP30).
             if (IsBIP30Unspendable(*pindex) && tx->IsCoinBase()) {
-                m_total_unspendable_amount += block_subsidy;
-                m_total_unspendables_bip30 += block_subsidy;
+                delta.total_unspendable_amount += block_subsidy;
+                delta.total_unspendables_bip30 += block_subsidy;
                 continue;
             }
 
@@ -165,22 +174,22 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
 
                 // Skip unspendable coins
                 if (coin.out.scriptPubKey.IsUnspendable()) {
-                    m_total_unspendable_amount += coin.out.nValue;
-                    m_total_unspendables_scripts += coin.out.nValue;
+                    delta.total_unspendable_amount += coin.out.nValue;
+                    delta.total_unspendables_scripts += coin.out.nValue;
                     continue;
                 }
 
-                ApplyCoinHash(m_muhash, outpoint, coin);
+                ApplyCoinHash(delta.muhash, outpoint, coin);
 
                 if (tx->IsCoinBase()) {
-                    m_total_coinbase_amount += coin.out.nValue;
+                    delta.total_coinbase_amount += coin.out.nValue;
                 } else {
-                    m_total_new_outputs_ex_coinbase_amount += coin.out.nValue;
+                    delta.total_new_outputs_ex_coinbase_amount += coin.out.nValue;
                 }
 
-                ++m_transaction_output_count;
-                m_total_amount += coin.out.nValue;
-                m_bogo_size += GetBogoSize(coin.out.scriptPubKey);
+                ++delta.transaction_output_count;
+                delta.total_amount += coin.out.nValue;
+                delta.bogo_size += GetBogoSize(coin.out.scriptPubKey);
             }
 
             // The coinbase tx has no undo data since no former output is spent
@@ -191,22 +200,62 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                     Coin coin{tx_undo.vprevout[j]};
                     COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
 
-                    RemoveCoinHash(m_muhash, outpoint, coin);
+                    RemoveCoinHash(delta.muhash, outpoint, coin);
 
-                    m_total_prevout_spent_amount += coin.out.nValue;
+                    delta.total_prevout_spent_amount += coin.out.nValue;
 
-                    --m_transaction_output_count;
-                    m_total_amount -= coin.out.nValue;
-                    m_bogo_size -= GetBogoSize(coin.out.scriptPubKey);
+                    --delta.transaction_output_count;
+                    delta.total_amount -= coin.out.nValue;
+                    delta.bogo_size -= GetBogoSize(coin.out.scriptPubKey);
                 }
             }
         }
     } else {
         // genesis block
-        m_total_unspendable_amount += block_subsidy;
-        m_total_unspendables_genesis_block += block_subsidy;
+        delta.total_unspendable_amount += block_subsidy;
+        delta.total_unspendables_genesis_block += block_subsidy;
     }
 
+    result = std::move(delta);
+    return true;
+}
+
+bool CoinStatsIndex::CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result)
+{
+    const BlockStatsDelta& delta = std::any_cast<const BlockStatsDelta&>(result);
+
+    if (block.height > 0) {
+        std::pair<uint256, DBVal> read_out;
+        if (!m_db->Read(DBHeightKey(block.height - 1), read_out)) {
+            return false;
+        }
+
+        uint256 expected_block_hash{*Assert(block.prev_hash)};
+        if (read_out.first != expected_block_hash) {
+            LogPrintf("WARNING: previous block header belongs to unexpected block %s; expected %s\n",
+                    read_out.first.ToString(), expected_block_hash.ToString());
+
+            if (!m_db->Read(DBHashKey(expected_block_hash), read_out)) {
+                LogError("%s: previous block header not found; expected %s\n",
+                            __func__, expected_block_hash.ToString());
+                return false;
+            }
+        }
+    }
+
+    m_muhash *= delta.muhash;
+    m_transaction_output_count += delta.transaction_output_count;
+    m_bogo_size += delta.bogo_size;
+    m_total_amount += delta.total_amount;
+    m_total_subsidy += delta.total_subsidy;
+    m_total_unspendable_amount += delta.total_unspendable_amount;
+    m_total_prevout_spent_amount += delta.total_prevout_spent_amount;
+    m_total_new_outputs_ex_coinbase_amount += delta.total_new_outputs_ex_coinbase_amount;
+    m_total_coinbase_amount += delta.total_coinbase_amount;
+    m_total_unspendables_genesis_block += delta.total_unspendables_genesis_block;
+    m_total_unspendables_bip30 += delta.total_unspendables_bip30;
+    m_total_unspendables_scripts += delta.total_unspendables_scripts;
+
     // If spent prevouts + block subsidy are still a higher amount than
     // new outputs + coinbase + current unspendable amount this means
     // the miner did not claim the full block reward. Unclaimed block
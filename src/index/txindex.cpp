@@ -55,6 +55,12 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 TxIndex::~TxIndex() = default;
 
 bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any tx_positions;
+    return CustomProcessBlock(block, tx_positions) && CustomPostProcessBlock(block, std::move(tx_positions));
+}
+
+bool TxIndex::CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result)
 {
     // Exclude genesis block transaction because outputs are not spendable.
     if (block.height == 0) return true;
@@ -67,7 +73,14 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    return m_db->WriteTxs(vPos);
+    result = std::move(vPos);
+    return true;
+}
+
+bool TxIndex::CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result)
+{
+    if (!result.has_value()) return true;
+    return m_db->WriteTxs(std::any_cast<const std::vector<std::pair<uint256, CDiskTxPos>>&>(result));
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
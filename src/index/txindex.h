@@ -27,6 +27,12 @@ private:
 protected:
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool AllowParallelSync() const override { return true; }
+
+    bool CustomProcessBlock(const interfaces::BlockInfo& block, std::any& result) override;
+
+    bool CustomPostProcessBlock(const interfaces::BlockInfo& block, std::any&& result) override;
+
     BaseIndex::DB& GetDB() const override;
 
 public:
@@ -309,6 +309,10 @@ public:
     using TransactionChangedFn = std::function<void(const uint256& txid, ChangeType status)>;
     virtual std::unique_ptr<Handler> handleTransactionChanged(TransactionChangedFn fn) = 0;
 
+    //! Register handler for messages about transactions changed together, e.g. by a block.
+    using TransactionsChangedFn = std::function<void(const std::vector<std::pair<uint256, ChangeType>>& changes)>;
+    virtual std::unique_ptr<Handler> handleTransactionsChanged(TransactionsChangedFn fn) = 0;
+
     //! Register handler for watchonly changed messages.
     using WatchOnlyChangedFn = std::function<void(bool have_watch_only)>;
     virtual std::unique_ptr<Handler> handleWatchOnlyChanged(WatchOnlyChangedFn fn) = 0;
@@ -20,13 +20,20 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/overflow.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
+#include <atomic>
 #include <cassert>
+#include <deque>
+#include <functional>
+#include <future>
 #include <iosfwd>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -55,7 +62,12 @@ static void TxOutSer(T& ss, const COutPoint& outpoint, const Coin& coin)
     ss << coin.out;
 }
 
-static void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
+{
+    TxOutSer(ss, outpoint, coin);
+}
+
+static void ApplyCoinHash(DataStream& ss, const COutPoint& outpoint, const Coin& coin)
 {
     TxOutSer(ss, outpoint, coin);
 }
@@ -111,20 +123,17 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
+//! Apply the coins of a cursor to the statistics and the hash object
 template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+static bool ApplyCursor(CCoinsViewCursor& cursor, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
-
     Txid prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
+    while (cursor.Valid()) {
         if (interruption_point) interruption_point();
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
             if (!outputs.empty() && key.hash != prevkey) {
                 ApplyStats(stats, prevkey, outputs);
                 ApplyHash(hash_obj, prevkey, outputs);
@@ -137,12 +146,119 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
             LogError("%s: unable to read value\n", __func__);
             return false;
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
         ApplyStats(stats, prevkey, outputs);
         ApplyHash(hash_obj, prevkey, outputs);
     }
+    return true;
+}
+
+//! Calculate statistics about the unspent transaction output set
+template <typename T>
+static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+{
+    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
+    assert(pcursor);
+
+    if (!ApplyCursor(*pcursor, stats, hash_obj, interruption_point)) return false;
+
+    FinalizeHash(hash_obj, stats);
+
+    stats.nDiskSize = view->EstimateSize();
+
+    return true;
+}
+
+// When computing the statistics in parallel, each range of the UTXO set is
+// hashed into a partial result, which is merged into the final hash object in
+// range order. The serialized hash is not commutative, so its partial result
+// is the serialized coins themselves, written to the hasher in key order. The
+// MuHash partial results could be merged in any order.
+static DataStream NewPartialHash(const HashWriter&) { return DataStream{}; }
+static MuHash3072 NewPartialHash(const MuHash3072&) { return {}; }
+static std::nullptr_t NewPartialHash(std::nullptr_t) { return nullptr; }
+
+static void MergePartialHash(HashWriter& ss, const DataStream& partial) { ss.write(partial); }
+static void MergePartialHash(MuHash3072& muhash, const MuHash3072& partial) { muhash *= partial; }
+static void MergePartialHash(std::nullptr_t, std::nullptr_t) {}
+
+static void MergeStats(CCoinsStats& stats, const CCoinsStats& partial)
+{
+    stats.nTransactions += partial.nTransactions;
+    stats.nTransactionOutputs += partial.nTransactionOutputs;
+    stats.nBogoSize += partial.nBogoSize;
+    stats.coins_count += partial.coins_count;
+    if (stats.total_amount.has_value() && partial.total_amount.has_value()) {
+        stats.total_amount = CheckedAdd(*stats.total_amount, *partial.total_amount);
+    } else {
+        stats.total_amount = std::nullopt;
+    }
+}
+
+//! Calculate statistics about the unspent transaction output set, scanning
+//! ranges of the snapshot concurrently on the thread pool
+template <typename T>
+static bool ComputeUTXOStats(CCoinsView* view, const CCoinsViewSnapshot& snapshot, CCoinsStats& stats, T hash_obj,
+                             ThreadPool& thread_pool, const std::function<void()>& interruption_point)
+{
+    using Partial = decltype(NewPartialHash(hash_obj));
+    constexpr uint32_t num_ranges{CCoinsViewSnapshot::NUM_SCAN_RANGES};
+    constexpr uint32_t range_size{CCoinsViewSnapshot::NUM_PREFIXES / num_ranges};
+    // Bound the number of ranges in flight, so that the buffered partial
+    // results of HASH_SERIALIZED stay small.
+    const size_t max_in_flight{2 * thread_pool.WorkersCount()};
+
+    std::atomic<bool> stop{false};
+    const std::function<void()> worker_interruption_point{[&stop] {
+        if (stop) throw std::runtime_error("UTXO set scan stopped");
+    }};
+    std::deque<std::future<std::optional<std::pair<CCoinsStats, Partial>>>> in_flight;
+    uint32_t next_range{0};
+    const auto submit_range{[&] {
+        const uint32_t prefix_begin{next_range * range_size};
+        in_flight.push_back(thread_pool.Submit([&, prefix_begin]() -> std::optional<std::pair<CCoinsStats, Partial>> {
+            std::pair<CCoinsStats, Partial> result{CCoinsStats{}, NewPartialHash(hash_obj)};
+            const auto cursor{snapshot.Cursor(prefix_begin, prefix_begin + range_size)};
+            if (!ApplyCursor(*cursor, result.first, result.second, worker_interruption_point)) return std::nullopt;
+            return result;
+        }));
+        ++next_range;
+    }};
+
+    bool success{true};
+    int last_progress{0};
+    try {
+        for (uint32_t range{0}; range < num_ranges; ++range) {
+            while (next_range < num_ranges && in_flight.size() < max_in_flight) submit_range();
+            auto result{in_flight.front().get()};
+            in_flight.pop_front();
+            if (!result) {
+                success = false;
+                break;
+            }
+            MergeStats(stats, result->first);
+            MergePartialHash(hash_obj, result->second);
+
+            if (interruption_point) interruption_point();
+            const int progress{static_cast<int>((range + 1) * 100 / num_ranges)};
+            if (progress >= last_progress + 10) {
+                LogDebug(BCLog::COINDB, "Computing UTXO set statistics... %d%%\n", progress);
+                last_progress = progress;
+            }
+        }
+    } catch (...) {
+        // Tasks still in flight reference local state, wait for them to stop.
+        stop = true;
+        for (auto& future : in_flight) future.wait();
+        throw;
+    }
+    if (!success) {
+        stop = true;
+        for (auto& future : in_flight) future.wait();
+        return false;
+    }
 
     FinalizeHash(hash_obj, stats);
 
@@ -151,23 +267,31 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
     return true;
 }
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point, ThreadPool* thread_pool)
 {
-    CBlockIndex* pindex = WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(view->GetBestBlock()));
+    // Scan in parallel if a thread pool is given and the view supports it
+    std::unique_ptr<CCoinsViewSnapshot> snapshot;
+    if (thread_pool && thread_pool->WorkersCount() > 0) snapshot = view->Snapshot();
+
+    const uint256 best_block{snapshot ? snapshot->GetBestBlock() : view->GetBestBlock()};
+    CBlockIndex* pindex = WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(best_block));
     CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
 
+    const auto compute{[&](auto hash_obj) -> bool {
+        if (snapshot) return ComputeUTXOStats(view, *snapshot, stats, hash_obj, *thread_pool, interruption_point);
+        return ComputeUTXOStats(view, stats, hash_obj, interruption_point);
+    }};
+
     bool success = [&]() -> bool {
         switch (hash_type) {
         case(CoinStatsHashType::HASH_SERIALIZED): {
-            HashWriter ss{};
-            return ComputeUTXOStats(view, stats, ss, interruption_point);
+            return compute(HashWriter{});
         }
         case(CoinStatsHashType::MUHASH): {
-            MuHash3072 muhash;
-            return ComputeUTXOStats(view, stats, muhash, interruption_point);
+            return compute(MuHash3072{});
         }
         case(CoinStatsHashType::NONE): {
-            return ComputeUTXOStats(view, stats, nullptr, interruption_point);
+            return compute(nullptr);
         }
         } // no default case, so the compiler can warn about missing cases
         assert(false);
@@ -18,6 +18,8 @@ class CCoinsView;
 class Coin;
 class COutPoint;
 class CScript;
+class HashWriter;
+class ThreadPool;
 namespace node {
 class BlockManager;
 } // namespace node
@@ -73,10 +75,19 @@ struct CCoinsStats {
 
 uint64_t GetBogoSize(const CScript& script_pub_key);
 
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+/**
+ * Calculate statistics about the unspent transaction output set.
+ *
+ * If a running thread pool is given and the view supports snapshots, ranges
+ * of the UTXO set are scanned concurrently on it. The result is identical to
+ * a sequential scan.
+ */
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman,
+                                            const std::function<void()>& interruption_point = {}, ThreadPool* thread_pool = nullptr);
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_COINSTATS_H
@@ -13,6 +13,7 @@
 #include <primitives/transaction.h>
 #include <util/epochguard.h>
 #include <util/overflow.h>
+#include <util/vectorset.h>
 
 #include <chrono>
 #include <functional>
@@ -67,8 +68,10 @@ class CTxMemPoolEntry
 public:
     typedef std::reference_wrapper<const CTxMemPoolEntry> CTxMemPoolEntryRef;
     // two aliases, should the types ever diverge
-    typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Parents;
-    typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Children;
+    // Flat sets: most entries have few in-mempool parents and children, for
+    // which a sorted vector takes far less memory than tree nodes.
+    typedef VectorSet<CTxMemPoolEntryRef, CompareIteratorByHash> Parents;
+    typedef VectorSet<CTxMemPoolEntryRef, CompareIteratorByHash> Children;
 
 private:
     CTxMemPoolEntry(const CTxMemPoolEntry&) = default;
@@ -236,17 +239,21 @@ struct NewMempoolTransactionInfo {
     const bool m_chainstate_is_current;
     /* Indicates whether the transaction has unconfirmed parents. */
     const bool m_has_no_mempool_parents;
+    /* The time the transaction entered the mempool */
+    const std::chrono::seconds m_entry_time;
 
     explicit NewMempoolTransactionInfo(const CTransactionRef& tx, const CAmount& fee,
                                        const int64_t vsize, const unsigned int height,
                                        const bool mempool_limit_bypassed, const bool submitted_in_package,
                                        const bool chainstate_is_current,
-                                       const bool has_no_mempool_parents)
+                                       const bool has_no_mempool_parents,
+                                       const std::chrono::seconds entry_time)
         : info{tx, fee, vsize, height},
           m_mempool_limit_bypassed{mempool_limit_bypassed},
           m_submitted_in_package{submitted_in_package},
           m_chainstate_is_current{chainstate_is_current},
-          m_has_no_mempool_parents{has_no_mempool_parents} {}
+          m_has_no_mempool_parents{has_no_mempool_parents},
+          m_entry_time{entry_time} {}
 };
 
 #endif // BITCOIN_KERNEL_MEMPOOL_ENTRY_H
@@ -26,6 +26,7 @@
 #include <node/timeoffsets.h>
 #include <node/txdownloadman.h>
 #include <node/txreconciliation.h>
+#include <node/txrelayranking.h>
 #include <node/warnings.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
@@ -820,6 +821,18 @@ private:
     std::chrono::microseconds NextInvToInbounds(std::chrono::microseconds now,
                                                 std::chrono::seconds average_interval) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
 
+    /** Order of all peers' pending transaction announcements, shared by all peers for sorting them. */
+    std::unique_ptr<const node::TxRelayRanking> m_tx_relay_ranking GUARDED_BY(g_msgproc_mutex);
+    /** When m_tx_relay_ranking was last computed. */
+    std::chrono::microseconds m_tx_relay_ranking_time GUARDED_BY(g_msgproc_mutex){0};
+
+    /**
+     * Rank the union of all peers' pending transaction announcements again, at
+     * most once per TX_RELAY_RANKING_MIN_INTERVAL. Transactions queued for
+     * announcement in between are ordered separately by the caller.
+     */
+    void UpdateTxRelayRanking(std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_peer_mutex);
+
 
     // All of the following cache a recent block, and are protected by m_most_recent_block_mutex
     Mutex m_most_recent_block_mutex;
@@ -1096,6 +1109,18 @@ static void AddKnownTx(Peer& peer, const uint256& hash)
     tx_relay->m_tx_inventory_known_filter.insert(hash);
 }
 
+/** Queue announcements of transactions that reconciliation found the peer to be missing. */
+static void AnnounceReconciledTxs(Peer& peer, const std::vector<Wtxid>& wtxids)
+{
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay) return;
+
+    LOCK(tx_relay->m_tx_inventory_mutex);
+    for (const Wtxid& wtxid : wtxids) {
+        tx_relay->m_tx_inventory_to_send.insert(wtxid.ToUint256());
+    }
+}
+
 /** Whether this peer can serve us blocks. */
 static bool CanServeBlocks(const Peer& peer)
 {
@@ -1733,6 +1758,7 @@ PeerManagerInfo PeerManagerImpl::GetInfo() const
     return PeerManagerInfo{
         .median_outbound_time_offset = m_outbound_time_offsets.Median(),
         .ignores_incoming_txs = m_opts.ignore_incoming_txs,
+        .txreconciliation = m_txreconciliation ? std::make_optional(m_txreconciliation->GetStats()) : std::nullopt,
     };
 }
 
@@ -1898,8 +1924,7 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
       m_warnings{warnings},
       m_opts{opts}
 {
-    // While Erlay support is incomplete, it must be enabled explicitly via -txreconciliation.
-    // This argument can go away after Erlay support is complete.
+    // Reconciliation-based relay (Erlay) is opt-in via -txreconciliation.
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
@@ -2136,9 +2161,15 @@ void PeerManagerImpl::RelayTransaction(const uint256& txid, const uint256& wtxid
         if (tx_relay->m_next_inv_send_time == 0s) continue;
 
         const uint256& hash{peer.m_wtxid_relay ? wtxid : txid};
-        if (!tx_relay->m_tx_inventory_known_filter.contains(hash)) {
-            tx_relay->m_tx_inventory_to_send.insert(hash);
+        if (tx_relay->m_tx_inventory_known_filter.contains(hash)) continue;
+
+        // Peers we reconcile with learn about most transactions through reconciliation,
+        // only a few of them get the transaction flooded. If their set is full, flood.
+        if (m_txreconciliation && !m_txreconciliation->ShouldFanoutTo(Wtxid::FromUint256(wtxid), peer.m_id) &&
+            m_txreconciliation->AddToSet(peer.m_id, Wtxid::FromUint256(wtxid))) {
+            continue;
         }
+        tx_relay->m_tx_inventory_to_send.insert(hash);
     };
 }
 
@@ -3937,6 +3968,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
                 const GenTxid gtxid = ToGenTxid(inv);
                 AddKnownTx(*peer, inv.hash);
+                if (m_txreconciliation && gtxid.IsWtxid()) m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(inv.hash));
 
                 if (!m_chainman.IsInitialBlockDownload()) {
                     const bool fAlreadyHave{m_txdownloadman.AddTxAnnouncement(pfrom.GetId(), gtxid, current_time)};
@@ -4229,6 +4261,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         const uint256& hash = peer->m_wtxid_relay ? wtxid : txid;
         AddKnownTx(*peer, hash);
+        if (m_txreconciliation) m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(wtxid));
 
         LOCK2(cs_main, m_tx_download_mutex);
 
@@ -4853,6 +4886,50 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         return;
     }
 
+    if (msg_type == NetMsgType::REQRECON) {
+        if (!m_txreconciliation) return;
+        uint16_t peer_set_size, peer_q;
+        vRecv >> peer_set_size >> peer_q;
+        // The sketch is sent along with the next announcements, see SendMessages.
+        if (!m_txreconciliation->HandleReconciliationRequest(pfrom.GetId(), peer_set_size, peer_q)) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reqrecon), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+        }
+        return;
+    }
+
+    if (msg_type == NetMsgType::SKETCH) {
+        if (!m_txreconciliation) return;
+        std::vector<uint8_t> skdata;
+        vRecv >> skdata;
+        bool success;
+        std::vector<uint32_t> ask_short_ids;
+        std::vector<Wtxid> txs_to_announce;
+        if (!m_txreconciliation->HandleSketch(pfrom.GetId(), skdata, success, ask_short_ids, txs_to_announce)) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected sketch), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        MakeAndPushMessage(pfrom, NetMsgType::RECONCILDIFF, success, ask_short_ids);
+        AnnounceReconciledTxs(*peer, txs_to_announce);
+        return;
+    }
+
+    if (msg_type == NetMsgType::RECONCILDIFF) {
+        if (!m_txreconciliation) return;
+        bool success;
+        std::vector<uint32_t> ask_short_ids;
+        vRecv >> success >> ask_short_ids;
+        std::vector<Wtxid> txs_to_announce;
+        if (!m_txreconciliation->HandleReconciliationDifference(pfrom.GetId(), success, ask_short_ids, txs_to_announce)) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reconcildiff), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        AnnounceReconciledTxs(*peer, txs_to_announce);
+        return;
+    }
+
     if (msg_type == NetMsgType::GETCFILTERS) {
         ProcessGetCFilters(pfrom, *peer, vRecv);
         return;
@@ -5372,26 +5449,23 @@ void PeerManagerImpl::MaybeSendFeefilter(CNode& pto, Peer& peer, std::chrono::mi
     }
 }
 
-namespace {
-class CompareInvMempoolOrder
+void PeerManagerImpl::UpdateTxRelayRanking(std::chrono::microseconds now)
 {
-    CTxMemPool* mp;
-    bool m_wtxid_relay;
-public:
-    explicit CompareInvMempoolOrder(CTxMemPool *_mempool, bool use_wtxid)
-    {
-        mp = _mempool;
-        m_wtxid_relay = use_wtxid;
-    }
+    if (m_tx_relay_ranking && now < m_tx_relay_ranking_time + node::TX_RELAY_RANKING_MIN_INTERVAL) return;
 
-    bool operator()(std::set<uint256>::iterator a, std::set<uint256>::iterator b)
+    node::TxRelayRanking::Hashes txids, wtxids;
     {
-        /* As std::make_heap produces a max-heap, we want the entries with the
-         * fewest ancestors/highest fee to sort later. */
-        return mp->CompareDepthAndScore(*b, *a, m_wtxid_relay);
+        LOCK(m_peer_mutex);
+        for (const auto& [_, peer] : m_peer_map) {
+            if (auto tx_relay = peer->GetTxRelay(); tx_relay != nullptr) {
+                LOCK(tx_relay->m_tx_inventory_mutex);
+                (peer->m_wtxid_relay ? wtxids : txids).insert(tx_relay->m_tx_inventory_to_send.begin(), tx_relay->m_tx_inventory_to_send.end());
+            }
+        }
     }
-};
-} // namespace
+    m_tx_relay_ranking = std::make_unique<const node::TxRelayRanking>(m_mempool, txids, wtxids);
+    m_tx_relay_ranking_time = now;
+}
 
 bool PeerManagerImpl::RejectIncomingTxs(const CNode& peer) const
 {
@@ -5673,6 +5747,8 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         }
 
         if (auto tx_relay = peer->GetTxRelay(); tx_relay != nullptr) {
+                // Before the inventory lock is taken, as it must not be held when locking m_peer_mutex.
+                UpdateTxRelayRanking(current_time);
                 LOCK(tx_relay->m_tx_inventory_mutex);
                 // Check whether periodic sends should happen
                 bool fSendTrickle = pto->HasPermission(NetPermissionFlags::NoBan);
@@ -5724,34 +5800,47 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     }
                 }
 
+                if (m_txreconciliation) {
+                    // Announce the set of a reconciliation the peer has not answered in time.
+                    for (const Wtxid& wtxid : m_txreconciliation->ExpireReconciliationRequest(pto->GetId(), current_time)) {
+                        tx_relay->m_tx_inventory_to_send.insert(wtxid.ToUint256());
+                    }
+                    if (const auto request{m_txreconciliation->InitiateReconciliationRequest(pto->GetId(), current_time)}) {
+                        MakeAndPushMessage(*pto, NetMsgType::REQRECON, request->first, request->second);
+                    }
+                    // Respond to reconciliation requests along with the announcements, so the time of
+                    // the response does not tell when we received the transactions in the sketch.
+                    if (fSendTrickle) {
+                        if (const auto skdata{m_txreconciliation->RespondToReconciliationRequest(pto->GetId())}) {
+                            MakeAndPushMessage(*pto, NetMsgType::SKETCH, *skdata);
+                        }
+                    }
+                }
+
                 // Determine transactions to relay
                 if (fSendTrickle) {
-                    // Produce a vector with all candidates for sending
-                    std::vector<std::set<uint256>::iterator> vInvTx;
-                    vInvTx.reserve(tx_relay->m_tx_inventory_to_send.size());
-                    for (std::set<uint256>::iterator it = tx_relay->m_tx_inventory_to_send.begin(); it != tx_relay->m_tx_inventory_to_send.end(); it++) {
-                        vInvTx.push_back(it);
-                    }
-                    const CFeeRate filterrate{tx_relay->m_fee_filter_received.load()};
                     // Topologically and fee-rate sort the inventory we send for privacy and priority reasons.
-                    // A heap is used so that not all items need sorting if only a few are being sent.
-                    CompareInvMempoolOrder compareInvMempoolOrder(&m_mempool, peer->m_wtxid_relay);
-                    std::make_heap(vInvTx.begin(), vInvTx.end(), compareInvMempoolOrder);
+                    // The order is computed once for the announcements pending to all peers and shared between
+                    // them; only transactions queued since then need sorting against the mempool here.
+                    std::vector<uint256> vInvTx;
+                    std::vector<uint256> unranked;
+                    Assert(m_tx_relay_ranking)->Order(tx_relay->m_tx_inventory_to_send, peer->m_wtxid_relay, vInvTx, unranked);
+                    std::sort(unranked.begin(), unranked.end(), [&](const uint256& a, const uint256& b) {
+                        return m_mempool.CompareDepthAndScore(a, b, peer->m_wtxid_relay);
+                    });
+                    vInvTx.insert(vInvTx.end(), unranked.begin(), unranked.end());
+                    const CFeeRate filterrate{tx_relay->m_fee_filter_received.load()};
                     // No reason to drain out at many times the network's capacity,
                     // especially since we have many peers and some will draw much shorter delays.
                     unsigned int nRelayedTransactions = 0;
                     LOCK(tx_relay->m_bloom_filter_mutex);
                     size_t broadcast_max{INVENTORY_BROADCAST_TARGET + (tx_relay->m_tx_inventory_to_send.size()/1000)*5};
                     broadcast_max = std::min<size_t>(INVENTORY_BROADCAST_MAX, broadcast_max);
-                    while (!vInvTx.empty() && nRelayedTransactions < broadcast_max) {
-                        // Fetch the top element from the heap
-                        std::pop_heap(vInvTx.begin(), vInvTx.end(), compareInvMempoolOrder);
-                        std::set<uint256>::iterator it = vInvTx.back();
-                        vInvTx.pop_back();
-                        uint256 hash = *it;
+                    for (const uint256& hash : vInvTx) {
+                        if (nRelayedTransactions >= broadcast_max) break;
                         CInv inv(peer->m_wtxid_relay ? MSG_WTX : MSG_TX, hash);
                         // Remove it from the to-be-sent set
-                        tx_relay->m_tx_inventory_to_send.erase(it);
+                        tx_relay->m_tx_inventory_to_send.erase(hash);
                         // Check if not in the filter already
                         if (tx_relay->m_tx_inventory_known_filter.contains(hash)) {
                             continue;
@@ -7,10 +7,12 @@
 #define BITCOIN_NET_PROCESSING_H
 
 #include <net.h>
+#include <node/txreconciliation.h>
 #include <txorphanage.h>
 #include <validationinterface.h>
 
 #include <chrono>
+#include <optional>
 
 class AddrMan;
 class CChainParams;
@@ -55,6 +57,8 @@ struct CNodeStateStats {
 struct PeerManagerInfo {
     std::chrono::seconds median_outbound_time_offset{0s};
     bool ignores_incoming_txs{false};
+    /** Set when transaction reconciliation is enabled. */
+    std::optional<TxReconciliationStats> txreconciliation;
 };
 
 class PeerManager : public CValidationInterface, public NetEventsInterface
@@ -14,10 +14,12 @@
 #include <net_processing.h>
 #include <netgroup.h>
 #include <node/kernel_notifications.h>
+#include <node/mempool_persist.h>
 #include <node/warnings.h>
 #include <policy/fees.h>
 #include <scheduler.h>
 #include <txmempool.h>
+#include <util/threadpool.h>
 #include <validation.h>
 #include <validationinterface.h>
 
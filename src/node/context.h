@@ -25,6 +25,7 @@ class ChainstateManager;
 class ECC_Context;
 class NetGroupManager;
 class PeerManager;
+class ThreadPool;
 namespace interfaces {
 class Chain;
 class ChainClient;
@@ -41,6 +42,7 @@ class SignalInterrupt;
 
 namespace node {
 class KernelNotifications;
+class MempoolJournal;
 class Warnings;
 
 //! NodeContext struct containing references to chain state and connection
@@ -68,11 +70,17 @@ struct NodeContext {
     std::unique_ptr<CTxMemPool> mempool;
     std::unique_ptr<const NetGroupManager> netgroupman;
     std::unique_ptr<CBlockPolicyEstimator> fee_estimator;
+    //! Journal of the mempool changes since the last dump (see -mempooljournal)
+    std::unique_ptr<MempoolJournal> mempool_journal;
     std::unique_ptr<PeerManager> peerman;
     std::unique_ptr<ChainstateManager> chainman;
     std::unique_ptr<BanMan> banman;
     ArgsManager* args{nullptr}; // Currently a raw pointer because the memory is not managed by this struct
     std::vector<BaseIndex*> indexes; // raw pointers because memory is not managed by this struct
+    //! Worker threads shared by the indexes during their initial sync (see -indexworkers)
+    std::unique_ptr<ThreadPool> index_threadpool;
+    //! Worker threads shared by the RPCs scanning the whole UTXO set, started by the first scan, null to scan it sequentially
+    std::unique_ptr<ThreadPool> utxo_scan_threadpool;
     std::unique_ptr<interfaces::Chain> chain;
     //! List of all chain clients (wallet processes or other client) connected to node.
     std::vector<std::unique_ptr<interfaces::ChainClient>> chain_clients;
@@ -6,6 +6,9 @@
 
 #include <clientversion.h>
 #include <consensus/amount.h>
+#include <consensus/validation.h>
+#include <crypto/common.h>
+#include <hash.h>
 #include <logging.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -17,17 +20,22 @@
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/signalinterrupt.h>
+#include <util/strencodings.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -37,6 +45,60 @@ namespace node {
 
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
 static const uint64_t MEMPOOL_DUMP_VERSION{2};
+static const uint64_t MEMPOOL_JOURNAL_VERSION{1};
+
+//! Number of transactions read from mempool.dat before they are added to the mempool
+static constexpr size_t MEMPOOL_LOAD_BATCH_SIZE{1000};
+
+//! Journal record types
+static constexpr uint8_t JOURNAL_ADD{'a'};
+static constexpr uint8_t JOURNAL_REMOVE{'r'};
+static constexpr uint8_t JOURNAL_PRIORITISE{'p'};
+
+namespace {
+struct ImportStats {
+    int64_t count{0};
+    int64_t expired{0};
+    int64_t failed{0};
+    int64_t already_there{0};
+};
+} // namespace
+
+/**
+ * Attempt to add a batch of transactions, with their entry times, to the
+ * mempool.
+ */
+static bool ImportTransactions(CTxMemPool& pool, Chainstate& active_chainstate, std::vector<std::pair<CTransactionRef, int64_t>>& batch,
+                               NodeClock::time_point now, ImportStats& stats)
+{
+    std::erase_if(batch, [&](const auto& entry) {
+        if (entry.second > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) return false;
+        ++stats.expired;
+        return true;
+    });
+
+    for (const auto& [tx, nTime] : batch) {
+        LOCK(cs_main);
+        const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
+        if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
+            ++stats.count;
+        } else {
+            // mempool may contain the transaction already, e.g. from
+            // wallet(s) having loaded it while we were processing
+            // mempool transactions; consider these as valid, instead of
+            // failed, but mark them as 'already there'
+            if (pool.exists(GenTxid::Txid(tx->GetHash()))) {
+                ++stats.already_there;
+            } else {
+                ++stats.failed;
+            }
+        }
+        if (active_chainstate.m_chainman.m_interrupt)
+            return false;
+    }
+    batch.clear();
+    return true;
+}
 
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
@@ -48,10 +110,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         return false;
     }
 
-    int64_t count = 0;
-    int64_t expired = 0;
-    int64_t failed = 0;
-    int64_t already_there = 0;
+    ImportStats stats;
     int64_t unbroadcast = 0;
     const auto now{NodeClock::now()};
 
@@ -72,6 +131,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         uint64_t txns_tried = 0;
         LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
         int next_tenth_to_report = 0;
+        std::vector<std::pair<CTransactionRef, int64_t>> batch;
         while (txns_tried < total_txns_to_load) {
             const int percentage_done(100.0 * txns_tried / total_txns_to_load);
             if (next_tenth_to_report < percentage_done / 10) {
@@ -96,27 +156,10 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             if (amountdelta && opts.apply_fee_delta_priority) {
                 pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
             }
-            if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
-                LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
-                if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
-                    ++count;
-                } else {
-                    // mempool may contain the transaction already, e.g. from
-                    // wallet(s) having loaded it while we were processing
-                    // mempool transactions; consider these as valid, instead of
-                    // failed, but mark them as 'already there'
-                    if (pool.exists(GenTxid::Txid(tx->GetHash()))) {
-                        ++already_there;
-                    } else {
-                        ++failed;
-                    }
-                }
-            } else {
-                ++expired;
+            batch.emplace_back(std::move(tx), nTime);
+            if (batch.size() >= MEMPOOL_LOAD_BATCH_SIZE || txns_tried == total_txns_to_load) {
+                if (!ImportTransactions(pool, active_chainstate, batch, now, stats)) return false;
             }
-            if (active_chainstate.m_chainman.m_interrupt)
-                return false;
         }
         std::map<uint256, CAmount> mapDeltas;
         file >> mapDeltas;
@@ -142,7 +185,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         return false;
     }
 
-    LogInfo("Imported mempool transactions from file: %i succeeded, %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", count, failed, expired, already_there, unbroadcast);
+    LogInfo("Imported mempool transactions from file: %i succeeded, %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", stats.count, stats.failed, stats.expired, stats.already_there, unbroadcast);
     return true;
 }
 
@@ -218,4 +261,303 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
     return true;
 }
 
+MempoolJournal::MempoolJournal(fs::path dir, FopenFn mockable_fopen_function)
+    : m_dir{std::move(dir)}, m_fopen{std::move(mockable_fopen_function)} {}
+
+MempoolJournal::~MempoolJournal()
+{
+    StopBackgroundThread();
+    Flush();
+}
+
+fs::path MempoolJournal::FilePath(uint32_t file_number) const
+{
+    return m_dir / fs::u8path(strprintf("jrn%08u.dat", file_number));
+}
+
+std::vector<uint32_t> MempoolJournal::ListFiles() const
+{
+    std::vector<uint32_t> file_numbers;
+    std::error_code ec;
+    for (fs::directory_iterator it(m_dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        const std::string name{fs::PathToString(it->path().filename())};
+        if (!fs::is_regular_file(*it) || name.length() != 15 || !name.starts_with("jrn") || !name.ends_with(".dat")) continue;
+        if (const auto file_number{ToIntegral<uint32_t>(name.substr(3, 8))}) file_numbers.push_back(*file_number);
+    }
+    std::sort(file_numbers.begin(), file_numbers.end());
+    return file_numbers;
+}
+
+bool MempoolJournal::Replay(CTxMemPool& pool, Chainstate& active_chainstate, ImportMempoolOptions&& opts) const
+{
+    // Fold the records into the transactions that were still in the mempool
+    // after the last record, in the order they were added.
+    std::vector<std::pair<CTransactionRef, int64_t>> added;
+    std::map<uint256, size_t> added_pos;
+    std::map<uint256, CAmount> deltas;
+    //! Transactions whose last record is a removal, which may be in the dump
+    std::map<uint256, MemPoolRemovalReason> removed;
+    uint64_t records{0};
+    const std::vector<uint32_t> file_numbers{ListFiles()};
+    for (const uint32_t file_number : file_numbers) {
+        AutoFile file{m_fopen(FilePath(file_number), "rb")};
+        if (file.IsNull()) {
+            LogInfo("Failed to open mempool journal file %u. Continuing anyway.\n", file_number);
+            continue;
+        }
+        try {
+            uint64_t version;
+            std::vector<std::byte> xor_key;
+            file >> version;
+            if (version != MEMPOOL_JOURNAL_VERSION) continue;
+            file >> xor_key;
+            file.SetXor(xor_key);
+            while (true) {
+                uint32_t size;
+                uint32_t checksum;
+                file >> size >> checksum;
+                if (size > MAX_SIZE) break;
+                std::vector<std::byte> payload(size);
+                file.read(payload);
+                // A record that was not completely written is the end of the journal
+                if (ReadLE32(Hash(payload).begin()) != checksum) break;
+
+                DataStream record{payload};
+                uint8_t type;
+                record >> type;
+                if (type == JOURNAL_ADD) {
+                    CTransactionRef tx;
+                    int64_t nTime;
+                    record >> TX_WITH_WITNESS(tx) >> nTime;
+                    if (opts.use_current_time) nTime = TicksSinceEpoch<std::chrono::seconds>(NodeClock::now());
+                    removed.erase(tx->GetHash());
+                    added_pos[tx->GetHash()] = added.size();
+                    added.emplace_back(std::move(tx), nTime);
+                } else if (type == JOURNAL_REMOVE) {
+                    uint256 txid;
+                    uint8_t reason;
+                    record >> txid >> reason;
+                    if (const auto it{added_pos.find(txid)}; it != added_pos.end()) {
+                        added[it->second].first.reset();
+                        added_pos.erase(it);
+                    }
+                    removed[txid] = static_cast<MemPoolRemovalReason>(reason);
+                } else if (type == JOURNAL_PRIORITISE) {
+                    uint256 txid;
+                    CAmount total_delta;
+                    record >> txid >> total_delta;
+                    deltas[txid] = total_delta;
+                }
+                ++records;
+            }
+        } catch (const std::exception&) {
+            // End of file, or a record that was not completely written
+        }
+    }
+    std::erase_if(added, [](const auto& entry) { return entry.first == nullptr; });
+    if (records == 0) return true;
+    LogInfo("Replaying %u mempool journal records from %u files: %u transactions to add, %u to remove, %u prioritisations\n",
+            records, file_numbers.size(), added.size(), removed.size(), deltas.size());
+
+    // Transactions loaded from the dump may have been removed after it was written
+    size_t removed_count{0};
+    {
+        LOCK2(cs_main, pool.cs);
+        for (const auto& [txid, reason] : removed) {
+            if (const CTransactionRef tx{pool.get(txid)}) {
+                pool.removeRecursive(*tx, reason);
+                ++removed_count;
+            }
+        }
+    }
+
+    if (opts.apply_fee_delta_priority) {
+        for (const auto& [txid, total_delta] : deltas) {
+            CAmount current_delta{0};
+            WITH_LOCK(pool.cs, pool.ApplyDelta(txid, current_delta));
+            if (total_delta != current_delta) pool.PrioritiseTransaction(txid, total_delta - current_delta);
+        }
+    }
+
+    ImportStats stats;
+    const auto now{NodeClock::now()};
+    for (size_t i = 0; i < added.size(); i += MEMPOOL_LOAD_BATCH_SIZE) {
+        std::vector<std::pair<CTransactionRef, int64_t>> batch(added.begin() + i, added.begin() + std::min(added.size(), i + MEMPOOL_LOAD_BATCH_SIZE));
+        if (!ImportTransactions(pool, active_chainstate, batch, now, stats)) return false;
+    }
+
+    LogInfo("Imported mempool transactions from journal: %i succeeded, %i failed, %i expired, %i already there, %u removed\n", stats.count, stats.failed, stats.expired, stats.already_there, removed_count);
+    return true;
+}
+
+bool MempoolJournal::Open()
+{
+    LOCK(m_mutex);
+    try {
+        TryCreateDirectories(m_dir);
+    } catch (const fs::filesystem_error& e) {
+        LogError("Failed to create mempool journal directory: %s\n", fsbridge::get_filesystem_error_message(e));
+        return false;
+    }
+    std::error_code ec;
+    m_size = 0;
+    for (const uint32_t file_number : ListFiles()) {
+        m_file_number = file_number;
+        const uintmax_t size{fs::file_size(FilePath(file_number), ec)};
+        if (ec) {
+            LogWarning("Failed to get the size of mempool journal file %u: %s\n", file_number, ec.message());
+            continue;
+        }
+        m_size += size;
+    }
+    return OpenNext();
+}
+
+bool MempoolJournal::OpenNext()
+{
+    AssertLockHeld(m_mutex);
+    if (m_file) m_file->Commit();
+    m_file.reset();
+
+    const uint32_t file_number{m_file_number + 1};
+    auto file{std::make_unique<AutoFile>(m_fopen(FilePath(file_number), "wb"))};
+    if (file->IsNull()) {
+        LogError("Failed to create mempool journal file %s\n", fs::PathToString(FilePath(file_number)));
+        return false;
+    }
+    try {
+        std::vector<std::byte> xor_key(8);
+        FastRandomContext{}.fillrand(xor_key);
+        *file << MEMPOOL_JOURNAL_VERSION << xor_key;
+        file->SetXor(xor_key);
+        m_size += file->tell();
+    } catch (const std::exception& e) {
+        LogError("Failed to write mempool journal file header: %s\n", e.what());
+        return false;
+    }
+    m_file = std::move(file);
+    m_file_number = file_number;
+    return true;
+}
+
+void MempoolJournal::Append(Span<const std::byte> record)
+{
+    AssertLockHeld(m_mutex);
+    if (!m_file) return;
+    try {
+        *m_file << uint32_t(record.size()) << ReadLE32(Hash(record).begin());
+        m_file->write(record);
+        m_size += 2 * sizeof(uint32_t) + record.size();
+    } catch (const std::exception& e) {
+        // Stop appending, so that the journal does not miss a change in the
+        // middle. The next compaction starts a new file.
+        LogError("Failed to write to mempool journal: %s\n", e.what());
+        m_file.reset();
+    }
+}
+
+void MempoolJournal::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
+{
+    DataStream record;
+    record << JOURNAL_ADD << TX_WITH_WITNESS(*tx.info.m_tx) << int64_t{count_seconds(tx.m_entry_time)};
+    LOCK(m_mutex);
+    Append(record);
+}
+
+void MempoolJournal::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence)
+{
+    DataStream record;
+    record << JOURNAL_REMOVE << tx->GetHash() << static_cast<uint8_t>(reason);
+    LOCK(m_mutex);
+    Append(record);
+}
+
+void MempoolJournal::MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
+{
+    LOCK(m_mutex);
+    for (const auto& removed : txs_removed_for_block) {
+        DataStream record;
+        record << JOURNAL_REMOVE << removed.info.m_tx->GetHash() << static_cast<uint8_t>(MemPoolRemovalReason::BLOCK);
+        Append(record);
+    }
+}
+
+void MempoolJournal::Prioritise(const uint256& txid, CAmount total_delta)
+{
+    DataStream record;
+    record << JOURNAL_PRIORITISE << txid << total_delta;
+    LOCK(m_mutex);
+    Append(record);
+}
+
+void MempoolJournal::Flush()
+{
+    LOCK(m_mutex);
+    if (m_file && !m_file->Commit()) {
+        LogError("Failed to flush mempool journal\n");
+    }
+}
+
+bool MempoolJournal::Compact(const CTxMemPool& pool, const fs::path& dump_path)
+{
+    uint32_t last_redundant_file;
+    uint64_t redundant_size;
+    {
+        LOCK(m_mutex);
+        // Everything recorded so far happened before the dump below copies
+        // the mempool, so the current and older files become redundant.
+        last_redundant_file = m_file_number;
+        redundant_size = m_size;
+        if (!OpenNext()) return false;
+    }
+    if (!DumpMempool(pool, dump_path)) return false;
+
+    for (const uint32_t file_number : ListFiles()) {
+        if (file_number > last_redundant_file) break;
+        std::error_code ec;
+        fs::remove(FilePath(file_number), ec);
+    }
+    LOCK(m_mutex);
+    m_size -= redundant_size;
+    return true;
+}
+
+bool MempoolJournal::MaybeCompact(const CTxMemPool& pool, const fs::path& dump_path)
+{
+    uint64_t size;
+    {
+        LOCK(m_mutex);
+        // Nothing to compact before the journal was opened
+        if (m_file_number == 0) return true;
+        // Compact right away after a write failure, to resume journaling
+        size = m_file ? m_size : std::numeric_limits<uint64_t>::max();
+    }
+    if (size < std::max<uint64_t>(MEMPOOL_JOURNAL_MIN_COMPACT_SIZE, WITH_LOCK(pool.cs, return pool.GetTotalTxSize()))) return true;
+    LogDebug(BCLog::MEMPOOL, "Compacting mempool journal\n");
+    return Compact(pool, dump_path);
+}
+
+uint64_t MempoolJournal::GetSize() const
+{
+    LOCK(m_mutex);
+    return m_size;
+}
+
+void MempoolJournal::StartBackgroundThread(const CTxMemPool& pool, fs::path dump_path)
+{
+    m_interrupt.reset();
+    m_thread = std::thread(&util::TraceThread, "mempjrnl", [this, &pool, dump_path = std::move(dump_path)] {
+        while (m_interrupt.sleep_for(MEMPOOL_JOURNAL_FLUSH_INTERVAL)) {
+            Flush();
+            MaybeCompact(pool, dump_path);
+        }
+    });
+}
+
+void MempoolJournal::StopBackgroundThread()
+{
+    m_interrupt();
+    if (m_thread.joinable()) m_thread.join();
+}
+
 } // namespace node
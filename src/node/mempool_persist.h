@@ -5,13 +5,31 @@
 #ifndef BITCOIN_NODE_MEMPOOL_PERSIST_H
 #define BITCOIN_NODE_MEMPOOL_PERSIST_H
 
+#include <consensus/amount.h>
+#include <span.h>
+#include <sync.h>
 #include <util/fs.h>
+#include <util/threadinterrupt.h>
+#include <validationinterface.h>
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class AutoFile;
 class Chainstate;
 class CTxMemPool;
+class uint256;
 
 namespace node {
 
+/** Interval at which the mempool journal is written to disk and checked for compaction */
+static constexpr std::chrono::seconds MEMPOOL_JOURNAL_FLUSH_INTERVAL{10};
+/** Size below which the mempool journal is not compacted, however small the mempool */
+static constexpr uint64_t MEMPOOL_JOURNAL_MIN_COMPACT_SIZE{10 << 20};
+
 /** Dump the mempool to a file. */
 bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path,
                  fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen,
@@ -28,6 +46,84 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path,
                  Chainstate& active_chainstate,
                  ImportMempoolOptions&& opts);
 
+/**
+ * Append-only journal of the changes made to the mempool since it was last
+ * dumped, so that the mempool of a node that did not shut down cleanly can be
+ * restored from mempool.dat and the journal.
+ *
+ * The journal is a sequence of numbered files. Compact() starts a new file,
+ * dumps the mempool and then deletes the older files, as the dump contains
+ * everything they record. Replaying a record that is also reflected in the
+ * dump is harmless: transactions already in the mempool are not added twice,
+ * removed ones are not there to remove, and prioritisations record the total
+ * fee delta of a transaction.
+ */
+class MempoolJournal final : public CValidationInterface
+{
+public:
+    explicit MempoolJournal(fs::path dir, fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen);
+    ~MempoolJournal();
+
+    /**
+     * Apply the changes recorded in the journal files on disk to the mempool
+     * loaded from the dump: add the transactions still there after the last
+     * record and remove those that were removed since.
+     */
+    bool Replay(CTxMemPool& pool, Chainstate& active_chainstate, ImportMempoolOptions&& opts) const;
+
+    /** Start a new journal file, which subsequent changes are appended to. */
+    bool Open() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Record the total fee delta of a transaction after it was prioritised. */
+    void Prioritise(const uint256& txid, CAmount total_delta) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Write the records appended so far to disk. */
+    void Flush() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Dump the mempool and delete the journal files made redundant by the dump. */
+    bool Compact(const CTxMemPool& pool, const fs::path& dump_path) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Compact the journal once replaying it would take longer than loading the mempool dump. */
+    bool MaybeCompact(const CTxMemPool& pool, const fs::path& dump_path) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Size of the journal files on disk. */
+    uint64_t GetSize() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Flush the journal every MEMPOOL_JOURNAL_FLUSH_INTERVAL and compact it
+     * when needed, on a thread of its own because compacting dumps the whole
+     * mempool.
+     */
+    void StartBackgroundThread(const CTxMemPool& pool, fs::path dump_path);
+
+    /** Stop the thread started by StartBackgroundThread(). */
+    void StopBackgroundThread();
+
+protected:
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    const fs::path m_dir;
+    const fsbridge::FopenFn m_fopen;
+
+    mutable Mutex m_mutex;
+    //! The journal file records are appended to, null until Open() is called
+    std::unique_ptr<AutoFile> m_file GUARDED_BY(m_mutex);
+    uint32_t m_file_number GUARDED_BY(m_mutex){0};
+    uint64_t m_size GUARDED_BY(m_mutex){0};
+
+    CThreadInterrupt m_interrupt;
+    std::thread m_thread;
+
+    fs::path FilePath(uint32_t file_number) const;
+    /** Numbers of the journal files on disk, in ascending order. */
+    std::vector<uint32_t> ListFiles() const;
+    bool OpenNext() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Append(Span<const std::byte> record) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
 } // namespace node
 
 
@@ -20,4 +20,14 @@ fs::path MempoolPath(const ArgsManager& argsman)
     return argsman.GetDataDirNet() / "mempool.dat";
 }
 
+bool ShouldJournalMempool(const ArgsManager& argsman)
+{
+    return ShouldPersistMempool(argsman) && argsman.GetBoolArg("-mempooljournal", DEFAULT_MEMPOOL_JOURNAL);
+}
+
+fs::path MempoolJournalPath(const ArgsManager& argsman)
+{
+    return argsman.GetDataDirNet() / "mempool_journal";
+}
+
 } // namespace node
@@ -17,8 +17,17 @@ namespace node {
  */
 static constexpr bool DEFAULT_PERSIST_MEMPOOL{true};
 
+/**
+ * Default for -mempooljournal, indicating whether changes to a persisted
+ * mempool should also be appended to a journal, so that they survive an
+ * unclean shutdown
+ */
+static constexpr bool DEFAULT_MEMPOOL_JOURNAL{false};
+
 bool ShouldPersistMempool(const ArgsManager& argsman);
 fs::path MempoolPath(const ArgsManager& argsman);
+bool ShouldJournalMempool(const ArgsManager& argsman);
+fs::path MempoolJournalPath(const ArgsManager& argsman);
 
 } // namespace node
 
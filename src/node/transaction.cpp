@@ -45,6 +45,11 @@ TransactionError BroadcastTransaction(NodeContext& node, const CTransactionRef t
     uint256 wtxid = tx->GetWitnessHash();
     bool callback_set = false;
 
+    // Run the checks that do not need cs_main before taking it, unless the
+    // transaction is already in the mempool and will only be reannounced.
+    TxValidationState precheck_state;
+    const bool prechecked{node.mempool->exists(GenTxid::Txid(txid)) || node.chainman->PreCheckTransaction(tx, precheck_state)};
+
     {
         LOCK(cs_main);
 
@@ -69,6 +74,7 @@ TransactionError BroadcastTransaction(NodeContext& node, const CTransactionRef t
             wtxid = mempool_tx->GetWitnessHash();
         } else {
             // Transaction is not already in the mempool.
+            if (!prechecked) return HandleATMPError(precheck_state, err_string);
             if (max_tx_fee > 0) {
                 // First, call ATMP with test_accept and check the fee. If ATMP
                 // fails here, return error immediately.
@@ -5,10 +5,16 @@
 #include <node/txreconciliation.h>
 
 #include <common/system.h>
+#include <crypto/siphash.h>
 #include <logging.h>
+#include <node/minisketchwrapper.h>
 #include <util/check.h>
 
+#include <algorithm>
+#include <limits>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 
@@ -29,6 +35,29 @@ uint256 ComputeSalt(uint64_t salt1, uint64_t salt2)
     return (HashWriter(RECON_SALT_HASHER) << std::min(salt1, salt2) << std::max(salt1, salt2)).GetSHA256();
 }
 
+/**
+ * Size of the sketch capacity to respond to a reconciliation request with: the expected
+ * set difference (see BIP-330), plus one.
+ */
+size_t EstimateSketchCapacity(size_t local_set_size, size_t remote_set_size, uint16_t remote_q)
+{
+    const size_t set_size_diff{local_set_size > remote_set_size ? local_set_size - remote_set_size : remote_set_size - local_set_size};
+    const size_t weighted_min_size{std::min(local_set_size, remote_set_size) * remote_q / Q_PRECISION};
+    const size_t estimated_diff{set_size_diff + weighted_min_size + 1};
+    return std::min(Minisketch::ComputeCapacity(32, estimated_diff, RECON_FALSE_POSITIVE_COEF), MAX_SKETCH_CAPACITY);
+}
+
+/** Steps of a reconciliation round, from the point of view of either role. */
+enum class ReconciliationPhase {
+    NONE,
+    /** Initiator: reqrecon sent, awaiting sketch. Responder: reqrecon received, sketch not sent yet. */
+    REQUESTED,
+    /** Initiator: no sketch arrived in time, the set was announced and new transactions are flooded. */
+    REQUEST_EXPIRED,
+    /** Responder: sketch sent, awaiting reconcildiff. */
+    SKETCH_SENT,
+};
+
 /**
  * Keeps track of txreconciliation-related per-peer state.
  */
@@ -36,9 +65,6 @@ class TxReconciliationState
 {
 public:
     /**
-     * TODO: This field is public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * Reconciliation protocol assumes using one role consistently: either a reconciliation
      * initiator (requesting sketches), or responder (sending sketches). This defines our role,
      * based on the direction of the p2p connection.
@@ -47,14 +73,49 @@ public:
     bool m_we_initiate;
 
     /**
-     * TODO: These fields are public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * These values are used to salt short IDs, which is necessary for transaction reconciliations.
      */
     uint64_t m_k0, m_k1;
 
+    /** Transactions we will reconcile with the peer in the next round. */
+    std::set<Wtxid> m_local_set;
+
+    /**
+     * Responder: the set the sketch we sent was computed over, kept until the initiator
+     * tells us which of these transactions to announce.
+     */
+    std::vector<Wtxid> m_local_set_snapshot;
+
+    ReconciliationPhase m_phase{ReconciliationPhase::NONE};
+
+    /** Initiator: when to send the next reconciliation request. */
+    std::chrono::microseconds m_next_request{0};
+
+    /** Initiator: when to stop waiting for the sketch answering our pending request. */
+    std::chrono::microseconds m_request_deadline{0};
+
+    /** Responder: set size and q coefficient from the pending reconciliation request. */
+    uint16_t m_remote_set_size{0};
+    uint16_t m_remote_q{0};
+
     TxReconciliationState(bool we_initiate, uint64_t k0, uint64_t k1) : m_we_initiate(we_initiate), m_k0(k0), m_k1(k1) {}
+
+    /**
+     * Short ID of a transaction, the element added to sketches (BIP-330):
+     * 1 + (SipHash-2-4(salt, wtxid) mod 0xFFFFFFFF).
+     */
+    uint32_t ComputeShortID(const Wtxid& wtxid) const
+    {
+        const uint64_t s{SipHashUint256(m_k0, m_k1, wtxid.ToUint256())};
+        return 1 + static_cast<uint32_t>(s % 0xFFFFFFFF);
+    }
+
+    Minisketch ComputeSketch(const std::vector<Wtxid>& wtxids, size_t capacity) const
+    {
+        Minisketch sketch{node::MakeMinisketch32(capacity)};
+        for (const Wtxid& wtxid : wtxids) sketch.Add(ComputeShortID(wtxid));
+        return sketch;
+    }
 };
 
 } // namespace
@@ -76,6 +137,29 @@ private:
      */
     std::unordered_map<NodeId, std::variant<uint64_t, TxReconciliationState>> m_states GUARDED_BY(m_txreconciliation_mutex);
 
+    /** Number of registered peers we initiate reconciliations with, i.e. outbound peers. */
+    size_t m_num_initiating_peers GUARDED_BY(m_txreconciliation_mutex){0};
+
+    /** Salt for choosing which peers a transaction is flooded to. */
+    const uint64_t m_fanout_k0{FastRandomContext().rand64()};
+    const uint64_t m_fanout_k1{FastRandomContext().rand64()};
+
+    TxReconciliationStats m_stats GUARDED_BY(m_txreconciliation_mutex);
+
+    TxReconciliationState* GetRegisteredState(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
+
+    const TxReconciliationState* GetRegisteredState(NodeId peer_id) const EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
+
 public:
     explicit Impl(uint32_t recon_version) : m_recon_version(recon_version) {}
 
@@ -122,6 +206,7 @@ public:
 
         const uint256 full_salt{ComputeSalt(local_salt, remote_salt)};
         recon_state->second = TxReconciliationState(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        if (!is_peer_inbound) ++m_num_initiating_peers;
         return ReconciliationRegisterResult::SUCCESS;
     }
 
@@ -129,6 +214,7 @@ public:
     {
         AssertLockNotHeld(m_txreconciliation_mutex);
         LOCK(m_txreconciliation_mutex);
+        if (const auto* state{GetRegisteredState(peer_id)}; state && state->m_we_initiate) --m_num_initiating_peers;
         if (m_states.erase(peer_id)) {
             LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Forget txreconciliation state of peer=%d\n", peer_id);
         }
@@ -142,6 +228,202 @@ public:
         return (recon_state != m_states.end() &&
                 std::holds_alternative<TxReconciliationState>(recon_state->second));
     }
+
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        const auto* state{GetRegisteredState(peer_id)};
+        if (!state) return true;
+
+        // Pick the peers deterministically per transaction, so a transaction that is
+        // relayed again is flooded to the same peers.
+        const uint64_t hash{CSipHasher(m_fanout_k0, m_fanout_k1).Write(wtxid.ToUint256()).Write(peer_id).Finalize()};
+        if (state->m_we_initiate) return hash % m_num_initiating_peers < OUTBOUND_FANOUT_DESTINATIONS;
+        return hash % 100 < INBOUND_FANOUT_PERCENT;
+    }
+
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || state->m_local_set.size() >= MAX_RECONSET_SIZE) return false;
+        if (state->m_phase == ReconciliationPhase::REQUEST_EXPIRED) return false;
+        state->m_local_set.insert(wtxid);
+        return true;
+    }
+
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        return state && state->m_local_set.erase(wtxid) > 0;
+    }
+
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || !state->m_we_initiate) return std::nullopt;
+        if (state->m_phase != ReconciliationPhase::NONE || now < state->m_next_request) return std::nullopt;
+
+        state->m_phase = ReconciliationPhase::REQUESTED;
+        state->m_next_request = now + RECON_REQUEST_INTERVAL;
+        state->m_request_deadline = now + RECON_RESPONSE_TIMEOUT;
+        m_stats.bytes_sent += 2 * sizeof(uint16_t);
+        const size_t set_size{std::min<size_t>(state->m_local_set.size(), std::numeric_limits<uint16_t>::max())};
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Request reconciliation from peer=%d (set size %d)\n", peer_id, set_size);
+        return std::make_pair(static_cast<uint16_t>(set_size), static_cast<uint16_t>(RECON_Q * Q_PRECISION));
+    }
+
+    std::vector<Wtxid> ExpireReconciliationRequest(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || !state->m_we_initiate) return {};
+        if (state->m_phase != ReconciliationPhase::REQUESTED || now < state->m_request_deadline) return {};
+
+        // The sketch may still arrive and is handled then, but the transactions waiting
+        // for it are announced now.
+        std::vector<Wtxid> txs_to_announce(state->m_local_set.begin(), state->m_local_set.end());
+        state->m_local_set.clear();
+        state->m_phase = ReconciliationPhase::REQUEST_EXPIRED;
+        ++m_stats.reconciliations_failed;
+        m_stats.txs_announced += txs_to_announce.size();
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation request to peer=%d timed out: announcing %d\n",
+                      peer_id, txs_to_announce.size());
+        return txs_to_announce;
+    }
+
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_set_size, uint16_t peer_q) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        // Only the initiator may request sketches, and only one reconciliation can be ongoing.
+        if (!state || state->m_we_initiate || state->m_phase != ReconciliationPhase::NONE) return false;
+        if (peer_q > Q_PRECISION) return false;
+
+        state->m_phase = ReconciliationPhase::REQUESTED;
+        state->m_remote_set_size = peer_set_size;
+        state->m_remote_q = peer_q;
+        return true;
+    }
+
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || state->m_we_initiate || state->m_phase != ReconciliationPhase::REQUESTED) return std::nullopt;
+
+        // Transactions added from now on are reconciled in the next round.
+        state->m_local_set_snapshot.assign(state->m_local_set.begin(), state->m_local_set.end());
+        state->m_local_set.clear();
+        state->m_phase = ReconciliationPhase::SKETCH_SENT;
+
+        const size_t capacity{EstimateSketchCapacity(state->m_local_set_snapshot.size(), state->m_remote_set_size, state->m_remote_q)};
+        std::vector<uint8_t> skdata{state->ComputeSketch(state->m_local_set_snapshot, capacity).Serialize()};
+        m_stats.bytes_sent += skdata.size();
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Send sketch of capacity %d to peer=%d (set size %d)\n",
+                      capacity, peer_id, state->m_local_set_snapshot.size());
+        return skdata;
+    }
+
+    bool HandleSketch(NodeId peer_id, Span<const uint8_t> skdata, bool& success, std::vector<uint32_t>& ask_short_ids,
+                      std::vector<Wtxid>& txs_to_announce) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || !state->m_we_initiate) return false;
+        if (state->m_phase != ReconciliationPhase::REQUESTED && state->m_phase != ReconciliationPhase::REQUEST_EXPIRED) return false;
+        if (skdata.size() % sizeof(uint32_t) != 0 || skdata.size() / sizeof(uint32_t) > MAX_SKETCH_CAPACITY) return false;
+
+        std::vector<Wtxid> local_set(state->m_local_set.begin(), state->m_local_set.end());
+        state->m_local_set.clear();
+        state->m_phase = ReconciliationPhase::NONE;
+
+        std::optional<std::vector<uint64_t>> differences;
+        const size_t capacity{skdata.size() / sizeof(uint32_t)};
+        if (capacity > 0) {
+            Minisketch remote_sketch{node::MakeMinisketch32(capacity)};
+            remote_sketch.Deserialize(skdata);
+            // Decoding more elements than the false positive protection allows for would
+            // accept bogus differences, so a larger difference counts as a failure.
+            const size_t max_elements{Minisketch::ComputeMaxElements(32, capacity, RECON_FALSE_POSITIVE_COEF)};
+            differences = state->ComputeSketch(local_set, capacity).Merge(remote_sketch).Decode(max_elements);
+        }
+
+        success = differences.has_value();
+        ask_short_ids.clear();
+        if (!success) {
+            // Fall back to announcing everything; the peer does the same with its set.
+            txs_to_announce = std::move(local_set);
+            ++m_stats.reconciliations_failed;
+            m_stats.txs_announced += txs_to_announce.size();
+        } else {
+            std::unordered_map<uint32_t, Wtxid> local_short_ids;
+            local_short_ids.reserve(local_set.size());
+            for (const Wtxid& wtxid : local_set) local_short_ids.emplace(state->ComputeShortID(wtxid), wtxid);
+            for (const uint64_t short_id : *differences) {
+                const auto it{local_short_ids.find(static_cast<uint32_t>(short_id))};
+                if (it != local_short_ids.end()) {
+                    txs_to_announce.push_back(it->second);
+                } else {
+                    ask_short_ids.push_back(static_cast<uint32_t>(short_id));
+                }
+            }
+            ++m_stats.reconciliations_succeeded;
+            m_stats.txs_announced += txs_to_announce.size();
+            m_stats.txs_not_announced += local_set.size() - txs_to_announce.size();
+        }
+        m_stats.bytes_sent += 1 + ask_short_ids.size() * sizeof(uint32_t);
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d %s: announcing %d, requesting %d\n",
+                      peer_id, success ? "succeeded" : "failed", txs_to_announce.size(), ask_short_ids.size());
+        return true;
+    }
+
+    bool HandleReconciliationDifference(NodeId peer_id, bool success, const std::vector<uint32_t>& ask_short_ids,
+                                        std::vector<Wtxid>& txs_to_announce) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || state->m_we_initiate || state->m_phase != ReconciliationPhase::SKETCH_SENT) return false;
+
+        std::vector<Wtxid> snapshot{std::move(state->m_local_set_snapshot)};
+        state->m_local_set_snapshot.clear();
+        state->m_phase = ReconciliationPhase::NONE;
+
+        if (!success) {
+            txs_to_announce = std::move(snapshot);
+            ++m_stats.reconciliations_failed;
+            m_stats.txs_announced += txs_to_announce.size();
+            return true;
+        }
+
+        const std::unordered_set<uint32_t> ask(ask_short_ids.begin(), ask_short_ids.end());
+        for (const Wtxid& wtxid : snapshot) {
+            if (ask.contains(state->ComputeShortID(wtxid))) txs_to_announce.push_back(wtxid);
+        }
+        ++m_stats.reconciliations_succeeded;
+        m_stats.txs_announced += txs_to_announce.size();
+        m_stats.txs_not_announced += snapshot.size() - txs_to_announce.size();
+        return true;
+    }
+
+    TxReconciliationStats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        return m_stats;
+    }
 };
 
 TxReconciliationTracker::TxReconciliationTracker(uint32_t recon_version) : m_impl{std::make_unique<TxReconciliationTracker::Impl>(recon_version)} {}
@@ -168,3 +450,55 @@ bool TxReconciliationTracker::IsPeerRegistered(NodeId peer_id) const
 {
     return m_impl->IsPeerRegistered(peer_id);
 }
+
+bool TxReconciliationTracker::ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const
+{
+    return m_impl->ShouldFanoutTo(wtxid, peer_id);
+}
+
+bool TxReconciliationTracker::AddToSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->AddToSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->TryRemovingFromSet(peer_id, wtxid);
+}
+
+std::optional<std::pair<uint16_t, uint16_t>> TxReconciliationTracker::InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->InitiateReconciliationRequest(peer_id, now);
+}
+
+std::vector<Wtxid> TxReconciliationTracker::ExpireReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->ExpireReconciliationRequest(peer_id, now);
+}
+
+bool TxReconciliationTracker::HandleReconciliationRequest(NodeId peer_id, uint16_t peer_set_size, uint16_t peer_q)
+{
+    return m_impl->HandleReconciliationRequest(peer_id, peer_set_size, peer_q);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::RespondToReconciliationRequest(NodeId peer_id)
+{
+    return m_impl->RespondToReconciliationRequest(peer_id);
+}
+
+bool TxReconciliationTracker::HandleSketch(NodeId peer_id, Span<const uint8_t> skdata, bool& success,
+                                           std::vector<uint32_t>& ask_short_ids, std::vector<Wtxid>& txs_to_announce)
+{
+    return m_impl->HandleSketch(peer_id, skdata, success, ask_short_ids, txs_to_announce);
+}
+
+bool TxReconciliationTracker::HandleReconciliationDifference(NodeId peer_id, bool success, const std::vector<uint32_t>& ask_short_ids,
+                                                             std::vector<Wtxid>& txs_to_announce)
+{
+    return m_impl->HandleReconciliationDifference(peer_id, success, ask_short_ids, txs_to_announce);
+}
+
+TxReconciliationStats TxReconciliationTracker::GetStats() const
+{
+    return m_impl->GetStats();
+}
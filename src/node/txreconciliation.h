@@ -6,13 +6,52 @@
 #define BITCOIN_NODE_TXRECONCILIATION_H
 
 #include <net.h>
+#include <primitives/transaction.h>
+#include <span.h>
 #include <sync.h>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 /** Supported transaction reconciliation protocol version */
 static constexpr uint32_t TXRECONCILIATION_VERSION{1};
+/** Interval between the reconciliation requests we send to each peer we initiate reconciliations with. */
+static constexpr std::chrono::seconds RECON_REQUEST_INTERVAL{8};
+/** Time an initiator waits for a sketch before it announces the set it requested reconciliation for. */
+static constexpr std::chrono::seconds RECON_RESPONSE_TIMEOUT{60};
+/** Coefficient used to estimate the set difference from the set sizes, see BIP-330. */
+static constexpr double RECON_Q{0.25};
+/** The q coefficient is sent in reqrecon as an integer scaled by this value. */
+static constexpr uint16_t Q_PRECISION{(2 << 14) - 1};
+/** Bits of false positive protection used when decoding sketches, see BIP-330. */
+static constexpr uint32_t RECON_FALSE_POSITIVE_COEF{16};
+/** Limits the size of the sketches we send and accept, and the cost of decoding them. */
+static constexpr size_t MAX_SKETCH_CAPACITY{2 << 12};
+/** Transactions are flooded rather than reconciled once a peer's set holds this many. */
+static constexpr size_t MAX_RECONSET_SIZE{3000};
+/** Expected number of outbound reconciling peers each transaction is flooded to. */
+static constexpr uint64_t OUTBOUND_FANOUT_DESTINATIONS{1};
+/** Percentage of inbound reconciling peers each transaction is flooded to. */
+static constexpr uint64_t INBOUND_FANOUT_PERCENT{10};
+
+/** Counters of completed reconciliations, used to tell how much bandwidth they saved. */
+struct TxReconciliationStats {
+    /** Reconciliation rounds in which the set difference was found. */
+    uint64_t reconciliations_succeeded{0};
+    /** Reconciliation rounds that fell back to announcing the whole set. */
+    uint64_t reconciliations_failed{0};
+    /** Transactions from our sets that reconciliation found the peer to be missing, and were announced. */
+    uint64_t txs_announced{0};
+    /** Transactions from our sets that the peer already had, so were never announced. */
+    uint64_t txs_not_announced{0};
+    /** Payload bytes of the reqrecon, sketch and reconcildiff messages we sent. */
+    uint64_t bytes_sent{0};
+};
 
 enum class ReconciliationRegisterResult {
     NOT_FOUND,
@@ -84,6 +123,72 @@ public:
      * Check if a peer is registered to reconcile transactions with us.
      */
     bool IsPeerRegistered(NodeId peer_id) const;
+
+    /**
+     * Step 1. Whether a transaction should be flooded to a registered peer rather than
+     * reconciled. A small share of the peers is flooded to so that transactions still
+     * propagate quickly; the rest learn about them through reconciliation. Returns true
+     * for peers that are not registered.
+     */
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const;
+
+    /**
+     * Step 1. Add a transaction to the set we reconcile with the peer. Returns false if the
+     * peer is not registered or its set is full, in which case the transaction has to be
+     * flooded.
+     */
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Remove a transaction from the set we reconcile with the peer, e.g. because the peer
+     * announced it to us. Returns whether it was in the set.
+     */
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Step 2 (initiator). If it is time to reconcile with the peer, return the size of
+     * our set and the q coefficient to request a sketch with (reqrecon).
+     */
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2 (initiator). If the peer has not sent a sketch for our request within
+     * RECON_RESPONSE_TIMEOUT, return our set to be announced instead. Until the sketch
+     * arrives, AddToSet refuses new transactions so they are flooded to the peer.
+     */
+    std::vector<Wtxid> ExpireReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2 (responder). Record a sketch request (reqrecon) from the peer, to be answered
+     * by RespondToReconciliationRequest. Returns false on a protocol violation.
+     */
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_set_size, uint16_t peer_q);
+
+    /**
+     * Step 2 (responder). If the peer requested a sketch, snapshot our set and return the
+     * serialized sketch of it (sketch).
+     */
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id);
+
+    /**
+     * Steps 3-4 (initiator). Combine the peer's sketch with one of our set to find the set
+     * difference. On success, ask_short_ids holds the short IDs of the transactions we are
+     * missing and txs_to_announce the transactions the peer is missing; on failure,
+     * txs_to_announce holds our whole set. success and ask_short_ids are to be sent to the
+     * peer (reconcildiff). Returns false on a protocol violation.
+     */
+    bool HandleSketch(NodeId peer_id, Span<const uint8_t> skdata, bool& success,
+                      std::vector<uint32_t>& ask_short_ids, std::vector<Wtxid>& txs_to_announce);
+
+    /**
+     * Step 4 (responder). Handle the outcome of the reconciliation (reconcildiff): fills
+     * txs_to_announce with the transactions from the snapshot the peer asked for, or with
+     * the whole snapshot if reconciliation failed. Returns false on a protocol violation.
+     */
+    bool HandleReconciliationDifference(NodeId peer_id, bool success, const std::vector<uint32_t>& ask_short_ids,
+                                        std::vector<Wtxid>& txs_to_announce);
+
+    TxReconciliationStats GetStats() const;
 };
 
 #endif // BITCOIN_NODE_TXRECONCILIATION_H
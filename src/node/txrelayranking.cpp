@@ -0,0 +1,69 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/txrelayranking.h>
+
+#include <kernel/mempool_entry.h>
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace node {
+TxRelayRanking::TxRelayRanking(const CTxMemPool& pool, const Hashes& txids, const Hashes& wtxids)
+{
+    LOCK(pool.cs);
+    Rank(pool, txids, /*wtxid=*/false, m_txids);
+    Rank(pool, wtxids, /*wtxid=*/true, m_wtxids);
+}
+
+void TxRelayRanking::Rank(const CTxMemPool& pool, const Hashes& hashes, bool wtxid, Ranking& ranking)
+{
+    AssertLockHeld(pool.cs);
+    std::vector<std::pair<CTxMemPool::txiter, uint256>> entries;
+    entries.reserve(hashes.size());
+    for (const uint256& hash : hashes) {
+        const auto it{wtxid ? pool.mapTx.project<0>(pool.mapTx.get<index_by_wtxid>().find(hash)) : pool.mapTx.find(hash)};
+        if (it != pool.mapTx.end()) entries.emplace_back(it, hash);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        const uint64_t count_a{a.first->GetCountWithAncestors()};
+        const uint64_t count_b{b.first->GetCountWithAncestors()};
+        if (count_a != count_b) return count_a < count_b;
+        return CompareTxMemPoolEntryByScore()(*a.first, *b.first);
+    });
+
+    ranking.hashes.reserve(entries.size());
+    ranking.positions.reserve(entries.size());
+    for (const auto& [_, hash] : entries) {
+        ranking.positions.emplace(hash, ranking.hashes.size());
+        ranking.hashes.push_back(hash);
+    }
+}
+
+void TxRelayRanking::Order(const std::set<uint256>& pending, bool wtxid, std::vector<uint256>& ranked, std::vector<uint256>& unranked) const
+{
+    const Ranking& ranking{wtxid ? m_wtxids : m_txids};
+
+    std::vector<uint64_t> selected((ranking.hashes.size() + 63) / 64);
+    size_t num_selected{0};
+    for (const uint256& hash : pending) {
+        const auto it{ranking.positions.find(hash)};
+        if (it == ranking.positions.end()) {
+            unranked.push_back(hash);
+            continue;
+        }
+        selected[it->second / 64] |= uint64_t{1} << (it->second % 64);
+        ++num_selected;
+    }
+
+    ranked.reserve(ranked.size() + num_selected);
+    for (size_t word = 0; word < selected.size() && num_selected > 0; ++word) {
+        for (uint64_t bits{selected[word]}; bits != 0; bits &= bits - 1) {
+            ranked.push_back(ranking.hashes[word * 64 + std::countr_zero(bits)]);
+            --num_selected;
+        }
+    }
+}
+} // namespace node
@@ -0,0 +1,68 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_TXRELAYRANKING_H
+#define BITCOIN_NODE_TXRELAYRANKING_H
+
+#include <sync.h>
+#include <txmempool.h>
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace node {
+/** Minimum time between two rebuilds of the shared transaction announcement ranking. */
+static constexpr auto TX_RELAY_RANKING_MIN_INTERVAL{std::chrono::seconds{1}};
+
+/**
+ * The transactions pending announcement to any peer, in the order in which
+ * they are announced: fewest in-mempool ancestors first, then highest ancestor
+ * score (see CTxMemPool::CompareDepthAndScore).
+ *
+ * Only the union of the peers' pending announcements is ranked, not the whole
+ * mempool, and the ranking is shared by all peers whose inventory trickle fires
+ * before the next rebuild. Ordering a peer's pending announcements then costs a
+ * hash lookup per announcement and a linear scan over a bitset of the ranking,
+ * without taking the mempool lock.
+ */
+class TxRelayRanking
+{
+public:
+    using Hashes = std::unordered_set<uint256, SaltedTxidHasher>;
+
+    /** Rank those of txids and wtxids that are in the mempool. */
+    TxRelayRanking(const CTxMemPool& pool, const Hashes& txids, const Hashes& wtxids);
+
+    /** Number of ranked txids or wtxids. */
+    size_t Size(bool wtxid) const { return (wtxid ? m_wtxids : m_txids).hashes.size(); }
+
+    /**
+     * Split the (w)txids in pending into those known to the ranking, appended
+     * to ranked in announcement order, and the others (transactions queued for
+     * announcement after the ranking was computed), appended to unranked in no
+     * particular order. Transactions that left the mempool since the ranking
+     * was computed keep their position; the caller skips them when it looks
+     * them up to announce them.
+     */
+    void Order(const std::set<uint256>& pending, bool wtxid, std::vector<uint256>& ranked, std::vector<uint256>& unranked) const;
+
+private:
+    struct Ranking {
+        std::vector<uint256> hashes;
+        std::unordered_map<uint256, uint32_t, SaltedTxidHasher> positions;
+    };
+    static void Rank(const CTxMemPool& pool, const Hashes& hashes, bool wtxid, Ranking& ranking) EXCLUSIVE_LOCKS_REQUIRED(pool.cs);
+
+    Ranking m_txids;
+    Ranking m_wtxids;
+};
+} // namespace node
+
+#endif // BITCOIN_NODE_TXRELAYRANKING_H
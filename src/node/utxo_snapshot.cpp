@@ -4,19 +4,28 @@
 
 #include <node/utxo_snapshot.h>
 
+#include <coins.h>
 #include <logging.h>
+#include <serialize.h>
 #include <streams.h>
 #include <sync.h>
 #include <tinyformat.h>
 #include <txdb.h>
 #include <uint256.h>
 #include <util/fs.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <deque>
+#include <future>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace node {
 
@@ -92,4 +101,101 @@ std::optional<fs::path> FindSnapshotChainstateDir(const fs::path& data_dir)
     return std::nullopt;
 }
 
+//! Serialize the coins of a cursor in the snapshot format.
+template <typename Stream>
+static uint64_t WriteCoins(Stream& s, CCoinsViewCursor& cursor, const std::function<void()>& interruption_point)
+{
+    COutPoint key;
+    Txid last_hash;
+    Coin coin;
+    unsigned int iter{0};
+    uint64_t written_coins_count{0};
+    std::vector<std::pair<uint32_t, Coin>> coins;
+
+    // To reduce space the serialization format of the snapshot avoids
+    // duplication of tx hashes. The code takes advantage of the guarantee by
+    // leveldb that keys are lexicographically sorted.
+    // In the coins vector we collect all coins that belong to a certain tx hash
+    // (key.hash) and when we have them all (key.hash != last_hash) we write
+    // them to file using the below lambda function.
+    // See also https://github.com/bitcoin/bitcoin/issues/25675
+    auto write_coins = [&](const Txid& last_hash, const std::vector<std::pair<uint32_t, Coin>>& coins) {
+        s << last_hash;
+        WriteCompactSize(s, coins.size());
+        for (const auto& [n, coin] : coins) {
+            WriteCompactSize(s, n);
+            s << coin;
+            ++written_coins_count;
+        }
+    };
+
+    cursor.GetKey(key);
+    last_hash = key.hash;
+    while (cursor.Valid()) {
+        if (iter % 5000 == 0 && interruption_point) interruption_point();
+        ++iter;
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
+            if (key.hash != last_hash) {
+                write_coins(last_hash, coins);
+                last_hash = key.hash;
+                coins.clear();
+            }
+            coins.emplace_back(key.n, coin);
+        }
+        cursor.Next();
+    }
+
+    if (!coins.empty()) {
+        write_coins(last_hash, coins);
+    }
+    return written_coins_count;
+}
+
+uint64_t WriteSnapshotCoins(AutoFile& afile, const CCoinsViewSnapshot& snapshot, ThreadPool* thread_pool,
+                            const std::function<void()>& interruption_point)
+{
+    if (!thread_pool || thread_pool->WorkersCount() == 0) {
+        const auto cursor{snapshot.Cursor(0, CCoinsViewSnapshot::NUM_PREFIXES)};
+        return WriteCoins(afile, *cursor, interruption_point);
+    }
+
+    // Coins of a transaction are never split across ranges, so the serialized
+    // ranges can simply be concatenated.
+    constexpr uint32_t num_ranges{CCoinsViewSnapshot::NUM_SCAN_RANGES};
+    constexpr uint32_t range_size{CCoinsViewSnapshot::NUM_PREFIXES / num_ranges};
+    // Bound the number of serialized ranges held in memory
+    const size_t max_in_flight{2 * thread_pool->WorkersCount()};
+
+    std::atomic<bool> stop{false};
+    const std::function<void()> worker_interruption_point{[&stop] {
+        if (stop) throw std::runtime_error("UTXO snapshot write stopped");
+    }};
+    std::deque<std::future<std::pair<DataStream, uint64_t>>> in_flight;
+    uint32_t next_range{0};
+    uint64_t written_coins_count{0};
+    try {
+        for (uint32_t range{0}; range < num_ranges; ++range) {
+            while (next_range < num_ranges && in_flight.size() < max_in_flight) {
+                in_flight.push_back(thread_pool->Submit([&, prefix_begin = next_range * range_size] {
+                    std::pair<DataStream, uint64_t> result;
+                    const auto cursor{snapshot.Cursor(prefix_begin, prefix_begin + range_size)};
+                    result.second = WriteCoins(result.first, *cursor, worker_interruption_point);
+                    return result;
+                }));
+                ++next_range;
+            }
+            const auto [chunk, coins_count]{in_flight.front().get()};
+            in_flight.pop_front();
+            afile.write(chunk);
+            written_coins_count += coins_count;
+            if (interruption_point) interruption_point();
+        }
+    } catch (...) {
+        // Tasks still in flight reference local state, wait for them to stop.
+        stop = true;
+        for (auto& future : in_flight) future.wait();
+        throw;
+    }
+    return written_coins_count;
+}
 } // namespace node
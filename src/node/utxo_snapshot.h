@@ -17,13 +17,17 @@
 #include <util/fs.h>
 
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <string_view>
 
 // UTXO set snapshot magic bytes
 static constexpr std::array<uint8_t, 5> SNAPSHOT_MAGIC_BYTES = {'u', 't', 'x', 'o', 0xff};
 
+class AutoFile;
+class CCoinsViewSnapshot;
 class Chainstate;
+class ThreadPool;
 
 namespace node {
 //! Metadata describing a serialized version of a UTXO set from which an
@@ -127,6 +131,14 @@ constexpr std::string_view SNAPSHOT_CHAINSTATE_SUFFIX = "_snapshot";
 //! Return a path to the snapshot-based chainstate dir, if one exists.
 std::optional<fs::path> FindSnapshotChainstateDir(const fs::path& data_dir);
 
+//! Write the coins of a UTXO set snapshot, following its SnapshotMetadata.
+//! If a running thread pool is given, ranges of the UTXO set are serialized
+//! concurrently and written in order, so the output is the same either way.
+//!
+//! @returns the number of coins written
+uint64_t WriteSnapshotCoins(AutoFile& afile, const CCoinsViewSnapshot& snapshot, ThreadPool* thread_pool = nullptr,
+                            const std::function<void()>& interruption_point = {});
+
 } // namespace node
 
 #endif // BITCOIN_NODE_UTXO_SNAPSHOT_H
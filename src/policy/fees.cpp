@@ -28,6 +28,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 
@@ -712,6 +713,8 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
 
     trackedTxs = 0;
     untrackedTxs = 0;
+
+    ResetSmartFeeTable();
 }
 
 CFeeRate CBlockPolicyEstimator::estimateFee(int confTarget) const
@@ -869,7 +872,68 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
-    LOCK(m_cs_fee_estimator);
+    SmartFeeTable::Estimate estimate;
+    const bool found{WITH_LOCK(m_smart_fee_table_mutex, return m_smart_fee_table && m_smart_fee_table->Get(confTarget, conservative, estimate))};
+    if (!found) {
+        LOCK(m_cs_fee_estimator);
+        // The table is only reset under m_cs_fee_estimator, so what is computed
+        // now is still current when it is stored.
+        const int target{WITH_LOCK(m_smart_fee_table_mutex, return m_smart_fee_table ? m_smart_fee_table->Target(confTarget) : confTarget)};
+        estimate.first = estimateSmartFeeLocked(target, &estimate.second, conservative);
+        LOCK(m_smart_fee_table_mutex);
+        if (m_smart_fee_table) m_smart_fee_table->Put(confTarget, conservative, estimate);
+    }
+    if (feeCalc) {
+        *feeCalc = estimate.second;
+        feeCalc->desiredTarget = confTarget;
+    }
+    return estimate.first;
+}
+
+int CBlockPolicyEstimator::SmartFeeTable::Target(int confTarget) const
+{
+    // Targets outside of the tracked range fail regardless
+    if (confTarget <= 0 || (unsigned int)confTarget > max_confirms) return confTarget;
+    return std::min<int>(confTarget, estimates[0].size() - 1);
+}
+
+bool CBlockPolicyEstimator::SmartFeeTable::Get(int confTarget, bool conservative, Estimate& estimate) const
+{
+    if (confTarget <= 0 || (unsigned int)confTarget > max_confirms) {
+        // Return failure if trying to analyze a target we're not tracking
+        estimate.first = CFeeRate(0);
+        estimate.second = FeeCalculation{};
+        estimate.second.returnedTarget = confTarget;
+        return true;
+    }
+    const auto& slot{estimates[conservative ? 1 : 0][Target(confTarget)]};
+    if (!slot) return false;
+    estimate = *slot;
+    return true;
+}
+
+void CBlockPolicyEstimator::SmartFeeTable::Put(int confTarget, bool conservative, const Estimate& estimate)
+{
+    if (confTarget <= 0 || (unsigned int)confTarget > max_confirms) return;
+    estimates[conservative ? 1 : 0][Target(confTarget)] = estimate;
+}
+
+void CBlockPolicyEstimator::ResetSmartFeeTable()
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    SmartFeeTable table;
+    table.max_confirms = longStats->GetMaxConfirms();
+    // Targets above the highest usable one are answered like it, and targets 1
+    // and 2 are both answered at 2, so this covers all distinct answers.
+    const unsigned int max_target{std::max(MaxUsableEstimate(), 2U)};
+    for (auto& estimates : table.estimates) estimates.resize(max_target + 1);
+    LOCK(m_smart_fee_table_mutex);
+    m_smart_fee_table = std::move(table);
+}
+
+CFeeRate CBlockPolicyEstimator::estimateSmartFeeLocked(int confTarget, FeeCalculation *feeCalc, bool conservative) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
 
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
@@ -1038,6 +1102,7 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            ResetSmartFeeTable();
         }
     }
     catch (const std::exception& e) {
@@ -1057,6 +1122,7 @@ void CBlockPolicyEstimator::FlushUnconfirmed()
         auto mi = mapMemPoolTxs.begin();
         _removeTx(mi->first, false); // this calls erase() on mapMemPoolTxs
     }
+    ResetSmartFeeTable();
     const auto endclear{SteadyClock::now()};
     LogDebug(BCLog::ESTIMATEFEE, "Recorded %u unconfirmed txs from mempool in %.3fs\n", num_entries, Ticks<SecondsDouble>(endclear - startclear));
 }
@@ -18,8 +18,10 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -205,7 +207,7 @@ public:
     /** Process all the transactions that have been included in a block */
     void processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block,
                       unsigned int nBlockHeight)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_smart_fee_table_mutex);
 
     /** Process a transaction accepted to the mempool*/
     void processTransaction(const NewMempoolTransactionInfo& tx)
@@ -223,9 +225,13 @@ public:
      *  blocks. If no answer can be given at confTarget, return an estimate at
      *  the closest target where one can be given.  'conservative' estimates are
      *  valid over longer time horizons also.
+     *
+     *  Estimates are kept in a table until the next block, so an estimate
+     *  reflects the unconfirmed transactions tracked when it was first asked
+     *  for since that block.
      */
     CFeeRate estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_smart_fee_table_mutex);
 
     /** Return a specific fee estimate calculation with a given success
      * threshold and time horizon, and optionally return detailed data about
@@ -241,11 +247,11 @@ public:
 
     /** Read estimation data from a file */
     bool Read(AutoFile& filein)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_smart_fee_table_mutex);
 
     /** Empty mempool transactions on shutdown to record failure to confirm for txs still in mempool */
     void FlushUnconfirmed()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_smart_fee_table_mutex);
 
     /** Calculation of highest target that estimates are tracked for */
     unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const
@@ -253,7 +259,7 @@ public:
 
     /** Drop still unconfirmed transactions and record current estimations, if the fee estimation file is present. */
     void Flush()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_smart_fee_table_mutex);
 
     /** Record current fee estimations. */
     void FlushFeeEstimates()
@@ -269,7 +275,7 @@ protected:
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
     void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_smart_fee_table_mutex);
 
 private:
     mutable Mutex m_cs_fee_estimator;
@@ -317,6 +323,38 @@ private:
     /** A non-thread-safe helper for the removeTx function */
     bool _removeTx(const uint256& hash, bool inBlock)
         EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+
+    /** estimateSmartFee as computed from the current state */
+    CFeeRate estimateSmartFeeLocked(int confTarget, FeeCalculation* feeCalc, bool conservative) const
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+
+    /** Smart fee estimates for every confirmation target, computed on first use */
+    struct SmartFeeTable {
+        using Estimate = std::pair<CFeeRate, FeeCalculation>;
+
+        unsigned int max_confirms{0};
+        //! Economical and conservative estimates, indexed by target. Higher
+        //! targets are answered like the last one.
+        std::array<std::vector<std::optional<Estimate>>, 2> estimates;
+
+        /** Target whose estimate answers confTarget */
+        int Target(int confTarget) const;
+        /** Look up the estimate for confTarget, false if it was not computed yet */
+        bool Get(int confTarget, bool conservative, Estimate& estimate) const;
+        void Put(int confTarget, bool conservative, const Estimate& estimate);
+    };
+
+    /** Drop the smart fee estimates, as they change with every block */
+    void ResetSmartFeeTable()
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_smart_fee_table_mutex);
+
+    //! Only held to look up or store estimates in m_smart_fee_table, so that
+    //! estimateSmartFee does not wait for block processing once an estimate is known
+    mutable Mutex m_smart_fee_table_mutex;
+    //! Only reset while m_cs_fee_estimator is held too, unset until the first block
+    mutable std::optional<SmartFeeTable> m_smart_fee_table GUARDED_BY(m_smart_fee_table_mutex);
+
+    friend class BlockPolicyEstimatorTester;
 };
 
 class FeeFilterRounder
@@ -9,6 +9,14 @@
 #include <script/signingprovider.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+
+//! Number of inputs a task of SignPSBTInputs signs
+static constexpr size_t PSBT_SIGN_CHUNK_SIZE{32};
 
 PartiallySignedTransaction::PartiallySignedTransaction(const CMutableTransaction& tx) : tx(tx)
 {
@@ -295,7 +303,7 @@ bool PSBTInputSigned(const PSBTInput& input)
     return !input.final_script_sig.empty() || !input.final_script_witness.IsNull();
 }
 
-bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned int input_index, const PrecomputedTransactionData* txdata)
+bool PSBTInputSignedAndVerified(const PartiallySignedTransaction& psbt, unsigned int input_index, const PrecomputedTransactionData* txdata)
 {
     CTxOut utxo;
     assert(psbt.inputs.size() >= input_index);
@@ -445,6 +453,39 @@ bool SignPSBTInput(const SigningProvider& provider, PartiallySignedTransaction&
     return sig_complete;
 }
 
+bool SignPSBTInputs(const std::vector<std::pair<int, const SigningProvider*>>& inputs, PartiallySignedTransaction& psbt, const PrecomputedTransactionData& txdata, int sighash, bool finalize, ThreadPool* thread_pool)
+{
+    const auto sign_range{[&](size_t begin, size_t end) {
+        bool complete{true};
+        for (size_t i = begin; i < end; ++i) {
+            const auto& [index, provider] = inputs[i];
+            complete &= SignPSBTInput(*provider, psbt, index, &txdata, sighash, nullptr, finalize);
+        }
+        return complete;
+    }};
+    if (!thread_pool || inputs.size() <= PSBT_SIGN_CHUNK_SIZE) {
+        return sign_range(0, inputs.size());
+    }
+
+    std::vector<std::future<bool>> chunks;
+    for (size_t begin = 0; begin < inputs.size(); begin += PSBT_SIGN_CHUNK_SIZE) {
+        const size_t end{std::min(inputs.size(), begin + PSBT_SIGN_CHUNK_SIZE)};
+        chunks.push_back(thread_pool->Submit([&sign_range, begin, end] { return sign_range(begin, end); }));
+    }
+    // Wait for all chunks even if one fails, as they reference psbt
+    bool complete{true};
+    std::exception_ptr error;
+    for (auto& chunk : chunks) {
+        try {
+            complete &= chunk.get();
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    return complete;
+}
+
 void RemoveUnnecessaryTransactions(PartiallySignedTransaction& psbtx, const int& sighash_type)
 {
     // Only drop non_witness_utxos if sighash_type != SIGHASH_ANYONECANPAY
@@ -477,19 +518,20 @@ void RemoveUnnecessaryTransactions(PartiallySignedTransaction& psbtx, const int&
     }
 }
 
-bool FinalizePSBT(PartiallySignedTransaction& psbtx)
+bool FinalizePSBT(PartiallySignedTransaction& psbtx, ThreadPool* thread_pool)
 {
     // Finalize input signatures -- in case we have partial signatures that add up to a complete
     //   signature, but have not combined them yet (e.g. because the combiner that created this
     //   PartiallySignedTransaction did not understand them), this will combine them into a final
     //   script.
-    bool complete = true;
     const PrecomputedTransactionData txdata = PrecomputePSBTData(psbtx);
+    std::vector<std::pair<int, const SigningProvider*>> inputs;
+    inputs.reserve(psbtx.tx->vin.size());
     for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
-        complete &= SignPSBTInput(DUMMY_SIGNING_PROVIDER, psbtx, i, &txdata, SIGHASH_ALL, nullptr, true);
+        inputs.emplace_back(i, &DUMMY_SIGNING_PROVIDER);
     }
 
-    return complete;
+    return SignPSBTInputs(inputs, psbtx, txdata, SIGHASH_ALL, /*finalize=*/true, thread_pool);
 }
 
 bool FinalizeAndExtractPSBT(PartiallySignedTransaction& psbtx, CMutableTransaction& result)
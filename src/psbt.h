@@ -16,7 +16,10 @@
 #include <streams.h>
 
 #include <optional>
+#include <utility>
+#include <vector>
 
+class ThreadPool;
 namespace node {
 enum class TransactionError;
 } // namespace node
@@ -1229,7 +1232,7 @@ PrecomputedTransactionData PrecomputePSBTData(const PartiallySignedTransaction&
 bool PSBTInputSigned(const PSBTInput& input);
 
 /** Checks whether a PSBTInput is already signed by doing script verification using final fields. */
-bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned int input_index, const PrecomputedTransactionData* txdata);
+bool PSBTInputSignedAndVerified(const PartiallySignedTransaction& psbt, unsigned int input_index, const PrecomputedTransactionData* txdata);
 
 /** Signs a PSBTInput, verifying that all provided data matches what is being signed.
  *
@@ -1238,6 +1241,14 @@ bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned
  **/
 bool SignPSBTInput(const SigningProvider& provider, PartiallySignedTransaction& psbt, int index, const PrecomputedTransactionData* txdata, int sighash = SIGHASH_ALL, SignatureData* out_sigdata = nullptr, bool finalize = true);
 
+/** Signs multiple PSBTInputs, each with its own provider, as SignPSBTInput does.
+ *
+ * Signing an input only modifies that input, so if thread_pool is not nullptr (and has workers)
+ * the signatures are created on it in chunks of inputs. The indices of inputs must be distinct.
+ * Returns true if all of the inputs are complete.
+ **/
+bool SignPSBTInputs(const std::vector<std::pair<int, const SigningProvider*>>& inputs, PartiallySignedTransaction& psbt, const PrecomputedTransactionData& txdata, int sighash = SIGHASH_ALL, bool finalize = true, ThreadPool* thread_pool = nullptr);
+
 /**  Reduces the size of the PSBT by dropping unnecessary `non_witness_utxos` (i.e. complete previous transactions) from a psbt when all inputs are segwit v1. */
 void RemoveUnnecessaryTransactions(PartiallySignedTransaction& psbtx, const int& sighash_type);
 
@@ -1254,9 +1265,10 @@ void UpdatePSBTOutput(const SigningProvider& provider, PartiallySignedTransactio
  * Finalizes a PSBT if possible, combining partial signatures.
  *
  * @param[in,out] psbtx PartiallySignedTransaction to finalize
+ * @param[in] thread_pool Optional thread pool to verify and finalize the inputs on
  * return True if the PSBT is now complete, false otherwise
  */
-bool FinalizePSBT(PartiallySignedTransaction& psbtx);
+bool FinalizePSBT(PartiallySignedTransaction& psbtx, ThreadPool* thread_pool = nullptr);
 
 /**
  * Finalizes a PSBT if possible, and extracts it to a CMutableTransaction if it could be finalized.
@@ -13,8 +13,10 @@
 #include <core_io.h>
 #include <flatfile.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
+#include <key_io.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <primitives/block.h>
@@ -33,6 +35,8 @@
 #include <validation.h>
 
 #include <any>
+#include <limits>
+#include <optional>
 #include <vector>
 
 #include <univalue.h>
@@ -646,6 +650,147 @@ static bool rest_deploymentinfo(const std::any& context, HTTPRequest* req, const
 
 }
 
+RPCHelpMan getaddresshistory();
+RPCHelpMan getaddressbalance();
+RPCHelpMan getaddressutxos();
+
+/** Checks the address and index state up front, so that the RPC handler does not fail on user input. */
+static bool CheckAddressIndexRequest(HTTPRequest* req, const std::string& address)
+{
+    if (!g_address_index) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Address index is not enabled");
+    }
+    if (!IsValidDestination(DecodeDestination(address))) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid address: " + address);
+    }
+    if (!g_address_index->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Address index is still syncing");
+    }
+    return true;
+}
+
+static bool rest_address_history(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string address;
+    const RESTResponseFormat rf = ParseDataFormat(address, str_uri_part);
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        if (!CheckAddressIndexRequest(req, address)) return false;
+
+        JSONRPCRequest jsonRequest;
+        jsonRequest.context = context;
+        jsonRequest.params = UniValue(UniValue::VARR);
+        jsonRequest.params.push_back(address);
+
+        std::optional<std::string> raw_start, raw_end;
+        try {
+            raw_start = req->GetQueryParameter("start_height");
+            raw_end = req->GetQueryParameter("end_height");
+        } catch (const std::runtime_error& e) {
+            return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+        }
+        const auto start_height{ToIntegral<int>(raw_start.value_or("0"))};
+        const auto end_height{raw_end ? ToIntegral<int>(*raw_end) : std::numeric_limits<int>::max()};
+        if (!start_height || !end_height || *start_height < 0 || *end_height < *start_height) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height range");
+        }
+        jsonRequest.params.push_back(*start_height);
+        jsonRequest.params.push_back(*end_height);
+
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, getaddresshistory().HandleRequest(jsonRequest).write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
+static bool rest_address_balance(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string address;
+    const RESTResponseFormat rf = ParseDataFormat(address, str_uri_part);
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        if (!CheckAddressIndexRequest(req, address)) return false;
+
+        JSONRPCRequest jsonRequest;
+        jsonRequest.context = context;
+        jsonRequest.params = UniValue(UniValue::VARR);
+        jsonRequest.params.push_back(address);
+
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, getaddressbalance().HandleRequest(jsonRequest).write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
+static bool rest_address_utxos(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string address;
+    const RESTResponseFormat rf = ParseDataFormat(address, str_uri_part);
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        if (!CheckAddressIndexRequest(req, address)) return false;
+
+        JSONRPCRequest jsonRequest;
+        jsonRequest.context = context;
+        jsonRequest.params = UniValue(UniValue::VARR);
+        jsonRequest.params.push_back(address);
+
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, getaddressutxos().HandleRequest(jsonRequest).write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
+/** Reply with snapshots of all mempool entries, formatted one batch at a time
+ *  and without building the whole document first. */
+static void WriteMempoolContents(const CTxMemPool& mempool, HTTPRequest* req, RESTResponseFormat rf)
+{
+    if (rf == RESTResponseFormat::JSON) {
+        req->WriteReplyParts([parts = MempoolToJSONParts(mempool), done = false]() mutable -> std::optional<std::string> {
+            if (done) return std::nullopt;
+            if (auto part{parts()}) return part;
+            done = true;
+            return "\n";
+        });
+        return;
+    }
+
+    req->WriteReplyParts([snapshots = MempoolEntrySnapshots{mempool, MEMPOOL_STREAM_CHUNK_SIZE}, rf, done = false]() mutable -> std::optional<std::string> {
+        if (done) return std::nullopt;
+        const std::vector<MempoolEntrySnapshot> entries{snapshots.Next()};
+        if (entries.empty()) {
+            done = true;
+            return rf == RESTResponseFormat::HEX ? "\n" : "";
+        }
+        DataStream ss_entries{};
+        for (const MempoolEntrySnapshot& entry : entries) {
+            ss_entries << entry;
+        }
+        return rf == RESTResponseFormat::HEX ? HexStr(ss_entries) : ss_entries.str();
+    });
+}
+
 static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
 {
     if (!CheckWarmup(req))
@@ -661,6 +806,16 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
     if (!mempool) return false;
 
     switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX: {
+        if (param != "contents") {
+            return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+        }
+        req->WriteHeader("Content-Type", rf == RESTResponseFormat::HEX ? "text/plain" : "application/octet-stream");
+        WriteMempoolContents(*mempool, req, rf);
+        return true;
+    }
+
     case RESTResponseFormat::JSON: {
         std::string str_json;
         if (param == "contents") {
@@ -687,6 +842,11 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
             if (verbose && mempool_sequence) {
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
+            if (verbose) {
+                req->WriteHeader("Content-Type", "application/json");
+                WriteMempoolContents(*mempool, req, rf);
+                return true;
+            }
             str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
         } else {
             str_json = MempoolInfoToJSON(*mempool).write() + "\n";
@@ -697,7 +857,7 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
         return true;
     }
     default: {
-        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
     }
     }
 }
@@ -1021,6 +1181,9 @@ static const struct {
       {"/rest/deploymentinfo/", rest_deploymentinfo},
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/addresshistory/", rest_address_history},
+      {"/rest/addressbalance/", rest_address_balance},
+      {"/rest/addressutxos/", rest_address_utxos},
 };
 
 void StartREST(const std::any& context)
@@ -12,6 +12,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
@@ -20,10 +21,12 @@
 #include <deploymentstatus.h>
 #include <flatfile.h>
 #include <hash.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <interfaces/mining.h>
 #include <kernel/coinstats.h>
+#include <key_io.h>
 #include <logging/timer.h>
 #include <net.h>
 #include <net_processing.h>
@@ -47,6 +50,7 @@
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -54,8 +58,11 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <condition_variable>
+#include <future>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -70,7 +77,7 @@ using node::NodeContext;
 using node::SnapshotMetadata;
 using util::MakeUnorderedList;
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
+std::tuple<std::unique_ptr<CCoinsViewSnapshot>, CCoinsStats, const CBlockIndex*>
 PrepareUTXOSnapshot(
     Chainstate& chainstate,
     const std::function<void()>& interruption_point = {})
@@ -78,12 +85,13 @@ PrepareUTXOSnapshot(
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
-    CCoinsViewCursor* pcursor,
+    const CCoinsViewSnapshot& snapshot,
     CCoinsStats* maybe_stats,
     const CBlockIndex* tip,
     AutoFile& afile,
     const fs::path& path,
     const fs::path& temppath,
+    ThreadPool* thread_pool,
     const std::function<void()>& interruption_point = {});
 
 /* Calculate the difficulty for a given block index.
@@ -912,12 +920,14 @@ CoinStatsHashType ParseHashType(const std::string& hash_type_input)
  * Calculate statistics about the unspent transaction output set
  *
  * @param[in] index_requested Signals if the coinstatsindex should be used (when available).
+ * @param[in] thread_pool Workers computing the statistics in parallel, nullptr to compute them sequentially.
  */
 static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::BlockManager& blockman,
                                                        kernel::CoinStatsHashType hash_type,
                                                        const std::function<void()>& interruption_point = {},
                                                        const CBlockIndex* pindex = nullptr,
-                                                       bool index_requested = true)
+                                                       bool index_requested = true,
+                                                       ThreadPool* thread_pool = nullptr)
 {
     // Use CoinStatsIndex if it is requested and available and a hash_type of Muhash or None was requested
     if ((hash_type == kernel::CoinStatsHashType::MUHASH || hash_type == kernel::CoinStatsHashType::NONE) && g_coin_stats_index && index_requested) {
@@ -935,7 +945,19 @@ static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::B
     // best block.
     CHECK_NONFATAL(!pindex || pindex->GetBlockHash() == view->GetBestBlock());
 
-    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point);
+    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point, thread_pool);
+}
+
+/** The thread pool shared by the RPCs scanning the UTXO set, with its workers started by the first scan, or nullptr to scan sequentially */
+static ThreadPool* GetUTXOScanThreadPool(NodeContext& node)
+{
+    if (!node.utxo_scan_threadpool) return nullptr;
+    static Mutex start_mutex;
+    LOCK(start_mutex);
+    if (node.utxo_scan_threadpool->WorkersCount() == 0) {
+        node.utxo_scan_threadpool->Start(std::min(GetNumCores(), MAX_UTXO_SCAN_WORKERS));
+    }
+    return node.utxo_scan_threadpool.get();
 }
 
 static RPCHelpMan gettxoutsetinfo()
@@ -1040,7 +1062,7 @@ static RPCHelpMan gettxoutsetinfo()
         }
     }
 
-    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested);
+    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested, GetUTXOScanThreadPool(node));
     if (maybe_stats.has_value()) {
         const CCoinsStats& stats = maybe_stats.value();
         ret.pushKV("height", (int64_t)stats.nHeight);
@@ -1063,7 +1085,7 @@ static RPCHelpMan gettxoutsetinfo()
 
             CCoinsStats prev_stats{};
             if (pindex->nHeight > 0) {
-                const std::optional<CCoinsStats> maybe_prev_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex->pprev, index_requested);
+                const std::optional<CCoinsStats> maybe_prev_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex->pprev, index_requested, GetUTXOScanThreadPool(node));
                 if (!maybe_prev_stats) {
                     throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
                 }
@@ -2136,6 +2158,57 @@ bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>&
     scan_progress = 100;
     return true;
 }
+
+//! Search for a given set of pubkey scripts, scanning ranges of the snapshot concurrently on the thread pool
+bool FindScriptPubKey(ThreadPool& thread_pool, std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, const CCoinsViewSnapshot& snapshot, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+{
+    struct RangeScan {
+        bool success{false};
+        int64_t count{0};
+        std::map<COutPoint, Coin> results;
+    };
+    constexpr uint32_t num_ranges{CCoinsViewSnapshot::NUM_SCAN_RANGES};
+    constexpr uint32_t range_size{CCoinsViewSnapshot::NUM_PREFIXES / num_ranges};
+
+    scan_progress = 0;
+    count = 0;
+    // Ranges that have not started yet are skipped once the scan failed
+    std::atomic<bool> stop{false};
+    std::vector<std::future<RangeScan>> futures;
+    futures.reserve(num_ranges);
+    for (uint32_t range{0}; range < num_ranges; ++range) {
+        futures.push_back(thread_pool.Submit([&, prefix_begin = range * range_size] {
+            RangeScan scan;
+            if (stop || should_abort) return scan;
+            std::atomic<int> range_progress;
+            const auto cursor{snapshot.Cursor(prefix_begin, prefix_begin + range_size)};
+            scan.success = FindScriptPubKey(range_progress, should_abort, scan.count, cursor.get(), needles, scan.results, interruption_point);
+            return scan;
+        }));
+    }
+
+    bool success{true};
+    for (uint32_t range{0}; range < num_ranges; ++range) {
+        try {
+            RangeScan scan{futures[range].get()};
+            if (success && !scan.success) {
+                success = false;
+                stop = true;
+            }
+            if (!success) continue;
+            count += scan.count;
+            out_results.merge(scan.results);
+            scan_progress = (int)((range + 1) * 100.0 / num_ranges + 0.5);
+        } catch (...) {
+            // Tasks still in flight reference local state, wait for them to finish.
+            stop = true;
+            for (uint32_t i{range + 1}; i < num_ranges; ++i) futures[i].wait();
+            throw;
+        }
+    }
+    if (success) scan_progress = 100;
+    return success;
+}
 } // namespace
 
 /** RAII object to prevent concurrency issue when scanning the txout set */
@@ -2315,17 +2388,24 @@ static RPCHelpMan scantxoutset()
         g_should_abort_scan = false;
         int64_t count = 0;
         std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::unique_ptr<CCoinsViewSnapshot> snapshot;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
+        ThreadPool* const thread_pool{GetUTXOScanThreadPool(node)};
         {
             ChainstateManager& chainman = EnsureChainman(node);
             LOCK(cs_main);
             Chainstate& active_chainstate = chainman.ActiveChainstate();
             active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
+            if (thread_pool) {
+                snapshot = CHECK_NONFATAL(active_chainstate.CoinsDB().Snapshot());
+            } else {
+                pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
+            }
             tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = snapshot ? FindScriptPubKey(*thread_pool, g_scan_progress, g_should_abort_scan, count, *snapshot, needles, coins, node.rpc_interruption_point) :
+                              FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -2911,6 +2991,162 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+static CScript ParseAddressIndexScript(const UniValue& address)
+{
+    if (!g_address_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index is not enabled. Start with -addressindex to enable it.");
+    }
+
+    const CTxDestination dest{DecodeDestination(address.get_str())};
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    if (!g_address_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because addressindex is still syncing. Current height: %d", g_address_index->GetSummary().best_block_height));
+    }
+    return GetScriptForDestination(dest);
+}
+
+RPCHelpMan getaddresshistory()
+{
+    return RPCHelpMan{"getaddresshistory",
+                "\nReturns the outputs paying to an address and the inputs spending them, in order of block height.\n"
+                "Requires -addressindex.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address to look up"},
+                    {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "The first block height to include"},
+                    {"end_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the tip"}, "The last block height to include"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "The transaction creating or spending the output"},
+                            {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                            {RPCResult::Type::NUM, "index", "The output index for received amounts, the input index for spent amounts"},
+                            {RPCResult::Type::BOOL, "spent", "Whether this entry spends a previous output"},
+                            {RPCResult::Type::STR_AMOUNT, "amount", "The amount received (positive) or spent (negative) in " + CURRENCY_UNIT},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 100000 200000") +
+                    HelpExampleRpc("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseAddressIndexScript(request.params[0])};
+    const int start_height{request.params[1].isNull() ? 0 : request.params[1].getInt<int>()};
+    const int end_height{request.params[2].isNull() ? std::numeric_limits<int>::max() : request.params[2].getInt<int>()};
+    if (start_height < 0 || end_height < start_height) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid height range");
+    }
+
+    std::vector<AddressHistoryEntry> entries;
+    if (!g_address_index->LookUpHistory(script, start_height, end_height, entries)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read address index");
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (const auto& entry : entries) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.txid.GetHex());
+        obj.pushKV("height", entry.height);
+        obj.pushKV("index", entry.index);
+        obj.pushKV("spent", entry.spent);
+        obj.pushKV("amount", ValueFromAmount(entry.amount));
+        ret.push_back(std::move(obj));
+    }
+    return ret;
+},
+    };
+}
+
+RPCHelpMan getaddressbalance()
+{
+    return RPCHelpMan{"getaddressbalance",
+                "\nReturns the confirmed balance of an address and the total amount it has received.\n"
+                "Requires -addressindex.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address to look up"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_AMOUNT, "balance", "The sum of the unspent outputs paying to the address in " + CURRENCY_UNIT},
+                        {RPCResult::Type::STR_AMOUNT, "received", "The sum of all outputs ever paying to the address in " + CURRENCY_UNIT},
+                        {RPCResult::Type::NUM, "unspent", "The number of unspent outputs paying to the address"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getaddressbalance", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleRpc("getaddressbalance", "\"" + EXAMPLE_ADDRESS[0] + "\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseAddressIndexScript(request.params[0])};
+
+    AddressBalance balance;
+    if (!g_address_index->LookUpBalance(script, balance)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read address index");
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("balance", ValueFromAmount(balance.balance));
+    ret.pushKV("received", ValueFromAmount(balance.received));
+    ret.pushKV("unspent", balance.unspent);
+    return ret;
+},
+    };
+}
+
+RPCHelpMan getaddressutxos()
+{
+    return RPCHelpMan{"getaddressutxos",
+                "\nReturns the unspent outputs paying to an address as of the best block of the address index.\n"
+                "Requires -addressindex.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address to look up"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                            {RPCResult::Type::NUM, "vout", "The output index"},
+                            {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                            {RPCResult::Type::STR_AMOUNT, "amount", "The amount of the output in " + CURRENCY_UNIT},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getaddressutxos", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleRpc("getaddressutxos", "\"" + EXAMPLE_ADDRESS[0] + "\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseAddressIndexScript(request.params[0])};
+
+    std::vector<AddressUnspentEntry> entries;
+    if (!g_address_index->LookUpUnspent(script, entries)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read address index");
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (const auto& entry : entries) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.outpoint.hash.GetHex());
+        obj.pushKV("vout", entry.outpoint.n);
+        obj.pushKV("height", entry.height);
+        obj.pushKV("amount", ValueFromAmount(entry.amount));
+        ret.push_back(std::move(obj));
+    }
+    return ret;
+},
+    };
+}
+
 /**
  * RAII class that disables the network in its constructor and enables it in its
  * destructor.
@@ -3067,13 +3303,13 @@ static RPCHelpMan dumptxoutset()
     }
 
     Chainstate* chainstate;
-    std::unique_ptr<CCoinsViewCursor> cursor;
+    std::unique_ptr<CCoinsViewSnapshot> snapshot;
     CCoinsStats stats;
     {
         // Lock the chainstate before calling PrepareUtxoSnapshot, to be able
-        // to get a UTXO database cursor while the chain is pointing at the
+        // to get a UTXO database snapshot while the chain is pointing at the
         // target block. After that, release the lock while calling
-        // WriteUTXOSnapshot. The cursor will remain valid and be used by
+        // WriteUTXOSnapshot. The snapshot will remain valid and be used by
         // WriteUTXOSnapshot to write a consistent snapshot even if the
         // chainstate changes.
         LOCK(node.chainman->GetMutex());
@@ -3088,11 +3324,11 @@ static RPCHelpMan dumptxoutset()
             LogWarning("dumptxoutset failed to roll back to requested height, reverting to tip.\n");
             throw JSONRPCError(RPC_MISC_ERROR, "Could not roll back to requested height.");
         } else {
-            std::tie(cursor, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point);
+            std::tie(snapshot, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point);
         }
     }
 
-    UniValue result = WriteUTXOSnapshot(*chainstate, cursor.get(), &stats, tip, afile, path, temppath, node.rpc_interruption_point);
+    UniValue result = WriteUTXOSnapshot(*chainstate, *snapshot, &stats, tip, afile, path, temppath, GetUTXOScanThreadPool(node), node.rpc_interruption_point);
     fs::rename(temppath, path);
 
     result.pushKV("path", path.utf8string());
@@ -3101,12 +3337,12 @@ static RPCHelpMan dumptxoutset()
     };
 }
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
+std::tuple<std::unique_ptr<CCoinsViewSnapshot>, CCoinsStats, const CBlockIndex*>
 PrepareUTXOSnapshot(
     Chainstate& chainstate,
     const std::function<void()>& interruption_point)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor;
+    std::unique_ptr<CCoinsViewSnapshot> snapshot;
     std::optional<CCoinsStats> maybe_stats;
     const CBlockIndex* tip;
 
@@ -3116,9 +3352,8 @@ PrepareUTXOSnapshot(
         // based upon the coinsdb, and (iii) constructing a cursor to the
         // coinsdb for use in WriteUTXOSnapshot.
         //
-        // Cursors returned by leveldb iterate over snapshots, so the contents
-        // of the pcursor will not be affected by simultaneous writes during
-        // use below this block.
+        // The contents of the leveldb snapshot will not be affected by
+        // simultaneous writes during use below this block.
         //
         // See discussion here:
         //   https://github.com/bitcoin/bitcoin/pull/15606#discussion_r274479369
@@ -3132,21 +3367,22 @@ PrepareUTXOSnapshot(
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
         }
 
-        pcursor = chainstate.CoinsDB().Cursor();
+        snapshot = CHECK_NONFATAL(chainstate.CoinsDB().Snapshot());
         tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(maybe_stats->hashBlock));
     }
 
-    return {std::move(pcursor), *CHECK_NONFATAL(maybe_stats), tip};
+    return {std::move(snapshot), *CHECK_NONFATAL(maybe_stats), tip};
 }
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
-    CCoinsViewCursor* pcursor,
+    const CCoinsViewSnapshot& snapshot,
     CCoinsStats* maybe_stats,
     const CBlockIndex* tip,
     AutoFile& afile,
     const fs::path& path,
     const fs::path& temppath,
+    ThreadPool* thread_pool,
     const std::function<void()>& interruption_point)
 {
     LOG_TIME_SECONDS(strprintf("writing UTXO snapshot at height %s (%s) to file %s (via %s)",
@@ -3157,49 +3393,7 @@ UniValue WriteUTXOSnapshot(
 
     afile << metadata;
 
-    COutPoint key;
-    Txid last_hash;
-    Coin coin;
-    unsigned int iter{0};
-    size_t written_coins_count{0};
-    std::vector<std::pair<uint32_t, Coin>> coins;
-
-    // To reduce space the serialization format of the snapshot avoids
-    // duplication of tx hashes. The code takes advantage of the guarantee by
-    // leveldb that keys are lexicographically sorted.
-    // In the coins vector we collect all coins that belong to a certain tx hash
-    // (key.hash) and when we have them all (key.hash != last_hash) we write
-    // them to file using the below lambda function.
-    // See also https://github.com/bitcoin/bitcoin/issues/25675
-    auto write_coins_to_file = [&](AutoFile& afile, const Txid& last_hash, const std::vector<std::pair<uint32_t, Coin>>& coins, size_t& written_coins_count) {
-        afile << last_hash;
-        WriteCompactSize(afile, coins.size());
-        for (const auto& [n, coin] : coins) {
-            WriteCompactSize(afile, n);
-            afile << coin;
-            ++written_coins_count;
-        }
-    };
-
-    pcursor->GetKey(key);
-    last_hash = key.hash;
-    while (pcursor->Valid()) {
-        if (iter % 5000 == 0) interruption_point();
-        ++iter;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
-            if (key.hash != last_hash) {
-                write_coins_to_file(afile, last_hash, coins, written_coins_count);
-                last_hash = key.hash;
-                coins.clear();
-            }
-            coins.emplace_back(key.n, coin);
-        }
-        pcursor->Next();
-    }
-
-    if (!coins.empty()) {
-        write_coins_to_file(afile, last_hash, coins, written_coins_count);
-    }
+    const uint64_t written_coins_count{node::WriteSnapshotCoins(afile, snapshot, thread_pool, interruption_point)};
 
     CHECK_NONFATAL(written_coins_count == maybe_stats->coins_count);
 
@@ -3222,8 +3416,8 @@ UniValue CreateUTXOSnapshot(
     const fs::path& path,
     const fs::path& tmppath)
 {
-    auto [cursor, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point))};
-    return WriteUTXOSnapshot(chainstate, cursor.get(), &stats, tip, afile, path, tmppath, node.rpc_interruption_point);
+    auto [snapshot, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point))};
+    return WriteUTXOSnapshot(chainstate, *snapshot, &stats, tip, afile, path, tmppath, GetUTXOScanThreadPool(node), node.rpc_interruption_point);
 }
 
 static RPCHelpMan loadtxoutset()
@@ -3405,6 +3599,9 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scanblocks},
         {"blockchain", &getdescriptoractivity},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getaddresshistory},
+        {"blockchain", &getaddressbalance},
+        {"blockchain", &getaddressutxos},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
@@ -26,6 +26,8 @@ struct NodeContext;
 } // namespace node
 
 static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
+//! Maximum number of threads used to scan the UTXO set in gettxoutsetinfo, scantxoutset and dumptxoutset
+static constexpr int MAX_UTXO_SCAN_WORKERS{8};
 
 /**
  * Get the difficulty of the net wrt to the given block index.
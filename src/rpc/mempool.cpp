@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <rpc/blockchain.h>
+#include <rpc/mempool.h>
 
 #include <node/mempool_persist.h>
 
@@ -284,33 +285,72 @@ static std::vector<RPCResult> MempoolEntryDescription()
     };
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+static MempoolEntrySnapshot SnapshotEntry(const CTxMemPool& pool, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
 {
     AssertLockHeld(pool.cs);
 
-    info.pushKV("vsize", (int)e.GetTxSize());
-    info.pushKV("weight", (int)e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", (int)e.GetHeight());
-    info.pushKV("descendantcount", e.GetCountWithDescendants());
-    info.pushKV("descendantsize", e.GetSizeWithDescendants());
-    info.pushKV("ancestorcount", e.GetCountWithAncestors());
-    info.pushKV("ancestorsize", e.GetSizeWithAncestors());
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
+    const CTransaction& tx = e.GetTx();
+    MempoolEntrySnapshot entry;
+    entry.txid = tx.GetHash();
+    entry.wtxid = tx.GetWitnessHash();
+    entry.vsize = e.GetTxSize();
+    entry.weight = e.GetTxWeight();
+    entry.time = count_seconds(e.GetTime());
+    entry.height = e.GetHeight();
+    entry.descendant_count = e.GetCountWithDescendants();
+    entry.descendant_size = e.GetSizeWithDescendants();
+    entry.ancestor_count = e.GetCountWithAncestors();
+    entry.ancestor_size = e.GetSizeWithAncestors();
+    entry.fee = e.GetFee();
+    entry.modified_fee = e.GetModifiedFee();
+    entry.ancestor_fees = e.GetModFeesWithAncestors();
+    entry.descendant_fees = e.GetModFeesWithDescendants();
+
+    for (const CTxIn& txin : tx.vin) {
+        if (pool.exists(GenTxid::Txid(txin.prevout.hash))) {
+            entry.depends.push_back(txin.prevout.hash);
+        }
+    }
+    std::sort(entry.depends.begin(), entry.depends.end());
+    entry.depends.erase(std::unique(entry.depends.begin(), entry.depends.end()), entry.depends.end());
+
+    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
+        entry.spent_by.push_back(child.GetTx().GetHash());
+    }
+
+    // Add opt-in RBF status
+    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
+    if (rbfState == RBFTransactionState::UNKNOWN) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
+    }
+    entry.bip125_replaceable = rbfState == RBFTransactionState::REPLACEABLE_BIP125;
+    entry.unbroadcast = pool.IsUnbroadcastTx(tx.GetHash());
+    return entry;
+}
+
+UniValue MempoolEntryToJSON(const MempoolEntrySnapshot& entry)
+{
+    UniValue info(UniValue::VOBJ);
+    info.pushKV("vsize", entry.vsize);
+    info.pushKV("weight", entry.weight);
+    info.pushKV("time", entry.time);
+    info.pushKV("height", (int)entry.height);
+    info.pushKV("descendantcount", entry.descendant_count);
+    info.pushKV("descendantsize", entry.descendant_size);
+    info.pushKV("ancestorcount", entry.ancestor_count);
+    info.pushKV("ancestorsize", entry.ancestor_size);
+    info.pushKV("wtxid", entry.wtxid.ToString());
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(e.GetModFeesWithAncestors()));
-    fees.pushKV("descendant", ValueFromAmount(e.GetModFeesWithDescendants()));
+    fees.pushKV("base", ValueFromAmount(entry.fee));
+    fees.pushKV("modified", ValueFromAmount(entry.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(entry.ancestor_fees));
+    fees.pushKV("descendant", ValueFromAmount(entry.descendant_fees));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(GenTxid::Txid(txin.prevout.hash)))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& parent : entry.depends) {
+        setDepends.insert(parent.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -322,23 +362,80 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : entry.spent_by) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
 
-    // Add opt-in RBF status
-    bool rbfStatus = false;
-    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-    if (rbfState == RBFTransactionState::UNKNOWN) {
-        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-        rbfStatus = true;
+    info.pushKV("bip125-replaceable", entry.bip125_replaceable);
+    info.pushKV("unbroadcast", entry.unbroadcast);
+    return info;
+}
+
+static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+{
+    info = MempoolEntryToJSON(SnapshotEntry(pool, e));
+}
+
+namespace {
+/** Compare entries of the entry_time index with an entry time */
+struct CompareEntryTimeWith {
+    bool operator()(const CTxMemPoolEntry& a, std::chrono::seconds b) const { return a.GetTime() < b; }
+    bool operator()(std::chrono::seconds a, const CTxMemPoolEntry& b) const { return a < b.GetTime(); }
+};
+} // namespace
+
+MempoolEntrySnapshots::MempoolEntrySnapshots(const CTxMemPool& pool, size_t batch_size)
+    : m_pool{pool}, m_batch_size{batch_size}
+{
+    assert(m_batch_size > 0);
+}
+
+std::vector<MempoolEntrySnapshot> MempoolEntrySnapshots::Next()
+{
+    std::vector<MempoolEntrySnapshot> batch;
+    LOCK(m_pool.cs);
+    if (!m_sequence) m_sequence = m_pool.GetSequence();
+    const auto& index{m_pool.mapTx.get<entry_time>()};
+    // Continue after the last entry returned, or from its entry time if it was
+    // removed in the meantime.
+    std::optional<CTxMemPool::txiter> last;
+    if (m_last) last = m_pool.GetIter(*m_last);
+    auto it{last ? std::next(m_pool.mapTx.project<entry_time>(*last)) : index.lower_bound(m_time, CompareEntryTimeWith{})};
+    for (; it != index.end() && batch.size() < m_batch_size; ++it) {
+        if (it->GetSequence() >= *m_sequence) continue;
+        const Txid& txid{it->GetTx().GetHash()};
+        if (it->GetTime() != m_time) {
+            m_time = it->GetTime();
+            m_returned_at_time.clear();
+        } else if (m_returned_at_time.contains(txid)) {
+            continue;
+        }
+        m_returned_at_time.insert(txid);
+        m_last = txid;
+        batch.push_back(SnapshotEntry(m_pool, *it));
     }
+    return batch;
+}
 
-    info.pushKV("bip125-replaceable", rbfStatus);
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+std::function<std::optional<std::string>()> MempoolToJSONParts(const CTxMemPool& pool)
+{
+    return [snapshots = MempoolEntrySnapshots{pool, MEMPOOL_STREAM_CHUNK_SIZE}, empty = true, done = false]() mutable -> std::optional<std::string> {
+        if (done) return std::nullopt;
+        const std::vector<MempoolEntrySnapshot> batch{snapshots.Next()};
+        std::string part;
+        for (const MempoolEntrySnapshot& entry : batch) {
+            part += empty ? '{' : ',';
+            empty = false;
+            part += '"' + entry.txid.ToString() + "\":" + MempoolEntryToJSON(entry).write();
+        }
+        if (batch.empty()) {
+            done = true;
+            part = empty ? "{}" : "}";
+        }
+        return part;
+    };
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
@@ -347,15 +444,17 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
         if (include_mempool_sequence) {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
         }
-        LOCK(pool.cs);
+        // Only hold the lock while a batch of entries is copied, so that
+        // mempool acceptance is not blocked while the JSON objects are built.
+        MempoolEntrySnapshots snapshots{pool, MEMPOOL_STREAM_CHUNK_SIZE};
         UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.entryAll()) {
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
-            // Mempool has unique entries so there is no advantage in using
-            // UniValue::pushKV, which checks if the key already exists in O(N).
-            // UniValue::pushKVEnd is used instead which currently is O(1).
-            o.pushKVEnd(e.GetTx().GetHash().ToString(), std::move(info));
+        for (auto batch{snapshots.Next()}; !batch.empty(); batch = snapshots.Next()) {
+            for (const MempoolEntrySnapshot& entry : batch) {
+                // Mempool has unique entries so there is no advantage in using
+                // UniValue::pushKV, which checks if the key already exists in O(N).
+                // UniValue::pushKVEnd is used instead which currently is O(1).
+                o.pushKVEnd(entry.txid.ToString(), MempoolEntryToJSON(entry));
+            }
         }
         return o;
     } else {
@@ -424,7 +523,12 @@ static RPCHelpMan getrawmempool()
         include_mempool_sequence = request.params[1].get_bool();
     }
 
-    return MempoolToJSON(EnsureAnyMemPool(request.context), fVerbose, include_mempool_sequence);
+    const CTxMemPool& mempool{EnsureAnyMemPool(request.context)};
+    if (fVerbose && !include_mempool_sequence && request.m_result_parts) {
+        *request.m_result_parts = MempoolToJSONParts(mempool);
+        return NullUniValue;
+    }
+    return MempoolToJSON(mempool, fVerbose, include_mempool_sequence);
 },
     };
 }
@@ -677,7 +781,9 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("loaded", pool.GetLoadTried());
     ret.pushKV("size", (int64_t)pool.size());
     ret.pushKV("bytes", (int64_t)pool.GetTotalTxSize());
-    ret.pushKV("usage", (int64_t)pool.DynamicMemoryUsage());
+    const size_t usage{pool.DynamicMemoryUsage()};
+    ret.pushKV("usage", (int64_t)usage);
+    ret.pushKV("usage_per_tx", (int64_t)(pool.size() ? usage / pool.size() : 0));
     ret.pushKV("total_fee", ValueFromAmount(pool.GetTotalFee()));
     ret.pushKV("maxmempool", pool.m_opts.max_size_bytes);
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(pool.GetMinFee(), pool.m_opts.min_relay_feerate).GetFeePerK()));
@@ -700,6 +806,7 @@ static RPCHelpMan getmempoolinfo()
                 {RPCResult::Type::NUM, "size", "Current tx count"},
                 {RPCResult::Type::NUM, "bytes", "Sum of all virtual transaction sizes as defined in BIP 141. Differs from actual serialized size because witness data is discounted"},
                 {RPCResult::Type::NUM, "usage", "Total memory usage for the mempool"},
+                {RPCResult::Type::NUM, "usage_per_tx", "Average memory usage per transaction in the mempool, in bytes"},
                 {RPCResult::Type::STR_AMOUNT, "total_fee", "Total fees for the mempool in " + CURRENCY_UNIT + ", ignoring modified fees through prioritisetransaction"},
                 {RPCResult::Type::NUM, "maxmempool", "Maximum memory usage for the mempool"},
                 {RPCResult::Type::STR_AMOUNT, "mempoolminfee", "Minimum fee rate in " + CURRENCY_UNIT + "/kvB for tx to be accepted. Is the maximum of minrelaytxfee and minimum mempool fee"},
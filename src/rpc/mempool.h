@@ -5,13 +5,100 @@
 #ifndef BITCOIN_RPC_MEMPOOL_H
 #define BITCOIN_RPC_MEMPOOL_H
 
+#include <consensus/amount.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
 class CTxMemPool;
 class UniValue;
 
+/** Number of entries copied per mempool lock hold when streaming the mempool contents */
+static constexpr size_t MEMPOOL_STREAM_CHUNK_SIZE{1000};
+
+/** Copy of the data shown for a mempool entry by the verbose mempool RPCs, so
+ *  that it can be formatted without holding the mempool lock. The serialized
+ *  form is the compact binary format of /rest/mempool/contents. */
+struct MempoolEntrySnapshot {
+    Txid txid;
+    Wtxid wtxid;
+    int32_t vsize{0};
+    int32_t weight{0};
+    int64_t time{0};
+    uint32_t height{0};
+    uint64_t descendant_count{0};
+    int64_t descendant_size{0};
+    uint64_t ancestor_count{0};
+    int64_t ancestor_size{0};
+    CAmount fee{0};
+    CAmount modified_fee{0};
+    CAmount ancestor_fees{0};
+    CAmount descendant_fees{0};
+    std::vector<Txid> depends;
+    std::vector<Txid> spent_by;
+    bool bip125_replaceable{false};
+    bool unbroadcast{false};
+
+    SERIALIZE_METHODS(MempoolEntrySnapshot, obj)
+    {
+        READWRITE(obj.txid, obj.wtxid);
+        READWRITE(VARINT_MODE(obj.vsize, VarIntMode::NONNEGATIVE_SIGNED), VARINT_MODE(obj.weight, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(obj.time, VARINT(obj.height));
+        READWRITE(VARINT(obj.descendant_count), VARINT_MODE(obj.descendant_size, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(VARINT(obj.ancestor_count), VARINT_MODE(obj.ancestor_size, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(obj.fee, obj.modified_fee, obj.ancestor_fees, obj.descendant_fees);
+        READWRITE(obj.depends, obj.spent_by, obj.bip125_replaceable, obj.unbroadcast);
+    }
+};
+
 /** Mempool information to JSON */
 UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 
 /** Mempool to JSON */
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose = false, bool include_mempool_sequence = false);
 
+/** Mempool entry to the JSON object used by the verbose mempool RPCs */
+UniValue MempoolEntryToJSON(const MempoolEntrySnapshot& entry);
+
+/**
+ * Snapshots of all mempool entries in the order they entered the mempool,
+ * taken in batches. The mempool lock is only held while a batch is copied, so
+ * transactions may be added or removed between batches: entries removed in the
+ * meantime are skipped and entries accepted after the first batch are not
+ * included.
+ */
+class MempoolEntrySnapshots
+{
+    const CTxMemPool& m_pool;
+    const size_t m_batch_size;
+    //! Mempool sequence when the first batch was taken
+    std::optional<uint64_t> m_sequence;
+    //! Entry time of the last entry returned
+    std::chrono::seconds m_time{std::chrono::seconds::min()};
+    //! Entries returned that entered the mempool at m_time, the last one returned first
+    std::optional<Txid> m_last;
+    std::set<Txid> m_returned_at_time;
+
+public:
+    MempoolEntrySnapshots(const CTxMemPool& pool, size_t batch_size);
+
+    /** The next batch of at most batch_size snapshots, empty once all entries were returned. */
+    std::vector<MempoolEntrySnapshot> Next();
+};
+
+/**
+ * The verbose getrawmempool result, written as JSON in parts of
+ * MEMPOOL_STREAM_CHUNK_SIZE entries so that it is never held in memory as a
+ * whole. Returns std::nullopt after the last part.
+ */
+std::function<std::optional<std::string>()> MempoolToJSONParts(const CTxMemPool& pool);
+
 #endif // BITCOIN_RPC_MEMPOOL_H
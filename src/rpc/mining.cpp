@@ -21,6 +21,7 @@
 #include <key_io.h>
 #include <net.h>
 #include <node/context.h>
+#include <node/mempool_persist.h>
 #include <node/miner.h>
 #include <node/warnings.h>
 #include <policy/ephemeral_policy.h>
@@ -532,6 +533,11 @@ static RPCHelpMan prioritisetransaction()
     }
 
     mempool.PrioritiseTransaction(hash, nAmount);
+    if (auto& journal{EnsureAnyNodeContext(request.context).mempool_journal}) {
+        CAmount total_delta{0};
+        WITH_LOCK(mempool.cs, mempool.ApplyDelta(hash, total_delta));
+        journal->Prioritise(hash, total_delta);
+    }
     return true;
 },
     };
@@ -633,6 +633,15 @@ static RPCHelpMan getnetworkinfo()
                         }},
                         {RPCResult::Type::BOOL, "localrelay", "true if transaction relay is requested from peers"},
                         {RPCResult::Type::NUM, "timeoffset", "the time offset"},
+                        {RPCResult::Type::OBJ, "txreconciliation", /*optional=*/true, "transaction reconciliation (BIP 330) statistics, only present with -txreconciliation",
+                        {
+                            {RPCResult::Type::NUM, "succeeded", "number of reconciliations in which the set difference was found"},
+                            {RPCResult::Type::NUM, "failed", "number of reconciliations that fell back to announcing the whole set"},
+                            {RPCResult::Type::NUM, "announced", "number of transactions announced because a reconciliation found the peer to be missing them"},
+                            {RPCResult::Type::NUM, "not_announced", "number of transactions not announced because a reconciliation found the peer to have them"},
+                            {RPCResult::Type::NUM, "bytes_sent", "payload bytes of the reconciliation messages sent"},
+                            {RPCResult::Type::NUM, "bytes_saved", "estimated bandwidth saved, in bytes: the size of the inventory entries not announced minus the reconciliation messages sent"},
+                        }},
                         {RPCResult::Type::NUM, "connections", "the total number of connections"},
                         {RPCResult::Type::NUM, "connections_in", "the number of inbound connections"},
                         {RPCResult::Type::NUM, "connections_out", "the number of outbound connections"},
@@ -690,6 +699,17 @@ static RPCHelpMan getnetworkinfo()
         auto peerman_info{node.peerman->GetInfo()};
         obj.pushKV("localrelay", !peerman_info.ignores_incoming_txs);
         obj.pushKV("timeoffset", Ticks<std::chrono::seconds>(peerman_info.median_outbound_time_offset));
+        if (const auto& stats{peerman_info.txreconciliation}) {
+            UniValue recon(UniValue::VOBJ);
+            recon.pushKV("succeeded", stats->reconciliations_succeeded);
+            recon.pushKV("failed", stats->reconciliations_failed);
+            recon.pushKV("announced", stats->txs_announced);
+            recon.pushKV("not_announced", stats->txs_not_announced);
+            recon.pushKV("bytes_sent", stats->bytes_sent);
+            const int64_t inv_bytes{static_cast<int64_t>(stats->txs_not_announced * GetSerializeSize(CInv{}))};
+            recon.pushKV("bytes_saved", inv_bytes - static_cast<int64_t>(stats->bytes_sent));
+            obj.pushKV("txreconciliation", std::move(recon));
+        }
     }
     if (node.connman) {
         obj.pushKV("networkactive", node.connman->GetNetworkActive());
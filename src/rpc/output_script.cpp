@@ -225,13 +225,13 @@ static UniValue DeriveAddresses(const Descriptor* desc, int64_t range_begin, int
 {
     UniValue addresses(UniValue::VARR);
 
-    for (int64_t i = range_begin; i <= range_end; ++i) {
-        FlatSigningProvider provider;
-        std::vector<CScript> scripts;
-        if (!desc->Expand(i, key_provider, scripts, provider)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Cannot derive script without private keys");
-        }
+    FlatSigningProvider provider;
+    std::vector<std::vector<CScript>> range_scripts;
+    if (!ExpandDescriptorRange(*desc, {range_begin, range_end}, key_provider, range_scripts, provider)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Cannot derive script without private keys");
+    }
 
+    for (const auto& scripts : range_scripts) {
         for (const CScript& script : scripts) {
             CTxDestination dest;
             if (!ExtractDestination(script, dest)) {
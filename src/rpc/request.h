@@ -7,6 +7,7 @@
 #define BITCOIN_RPC_REQUEST_H
 
 #include <any>
+#include <functional>
 #include <optional>
 #include <string>
 
@@ -44,6 +45,13 @@ public:
     std::string peerAddr;
     std::any context;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
+    /**
+     * Set by the HTTP server if the result may be sent in parts. A method can
+     * then return null and set the JSON of its result here instead, produced
+     * in parts until std::nullopt is returned, so that a large result is never
+     * held in memory as a whole.
+     */
+    std::function<std::optional<std::string>()>* m_result_parts{nullptr};
 
     void parse(const UniValue& valRequest);
     [[nodiscard]] bool IsNotification() const { return !id.has_value() && m_json_version == JSONRPCVersion::V2; };
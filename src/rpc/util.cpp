@@ -8,6 +8,7 @@
 #include <clientversion.h>
 #include <common/args.h>
 #include <common/messages.h>
+#include <common/system.h>
 #include <common/types.h>
 #include <consensus/amount.h>
 #include <core_io.h>
@@ -27,10 +28,12 @@
 #include <util/result.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 
 #include <algorithm>
 #include <iterator>
+#include <mutex>
 #include <string_view>
 #include <tuple>
 #include <utility>
@@ -683,7 +686,9 @@ UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
     m_req = &request;
     UniValue ret = m_fun(*this, request);
     m_req = nullptr;
-    if (gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
+    // A result sent in parts is not held in memory to be checked.
+    const bool sent_in_parts{request.m_result_parts && *request.m_result_parts};
+    if (!sent_in_parts && gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
         UniValue mismatch{UniValue::VARR};
         for (const auto& res : m_results.m_results) {
             UniValue match{res.MatchesType(ret)};
@@ -1344,6 +1349,21 @@ std::pair<int64_t, int64_t> ParseDescriptorRange(const UniValue& value)
     return {low, high};
 }
 
+//! Workers expanding large descriptor ranges, shared by all RPC calls and started on first use
+static ThreadPool& GetDescriptorExpandThreadPool()
+{
+    static ThreadPool thread_pool{"descexpand"};
+    static std::once_flag started;
+    std::call_once(started, [] { thread_pool.Start(std::clamp(GetNumCores(), 1, MAX_DESCRIPTOR_EXPAND_WORKERS)); });
+    return thread_pool;
+}
+
+bool ExpandDescriptorRange(const Descriptor& desc, std::pair<int64_t, int64_t> range, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, FlatSigningProvider& out)
+{
+    const bool parallel{range.second - range.first + 1 >= PARALLEL_DESCRIPTOR_EXPAND_MIN_POSITIONS};
+    return ExpandRange(desc, range.first, range.second + 1, provider, output_scripts, out, parallel ? &GetDescriptorExpandThreadPool() : nullptr);
+}
+
 std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, FlatSigningProvider& provider, const bool expand_priv)
 {
     std::string desc_str;
@@ -1371,16 +1391,19 @@ std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, Fl
         range.first = 0;
         range.second = 0;
     }
+    std::vector<std::vector<std::vector<CScript>>> desc_scripts(descs.size());
+    for (size_t j = 0; j < descs.size(); ++j) {
+        if (!ExpandDescriptorRange(*descs[j], range, provider, desc_scripts[j], provider)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys: '%s'", desc_str));
+        }
+    }
     std::vector<CScript> ret;
     for (int i = range.first; i <= range.second; ++i) {
-        for (const auto& desc : descs) {
-            std::vector<CScript> scripts;
-            if (!desc->Expand(i, provider, scripts, provider)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys: '%s'", desc_str));
-            }
+        for (size_t j = 0; j < descs.size(); ++j) {
             if (expand_priv) {
-                desc->ExpandPrivate(/*pos=*/i, provider, /*out=*/provider);
+                descs[j]->ExpandPrivate(/*pos=*/i, provider, /*out=*/provider);
             }
+            auto& scripts{desc_scripts[j][i - range.first]};
             std::move(scripts.begin(), scripts.end(), std::back_inserter(ret));
         }
     }
@@ -34,6 +34,7 @@
 class JSONRPCRequest;
 enum ServiceFlags : uint64_t;
 enum class OutputType;
+struct Descriptor;
 struct FlatSigningProvider;
 struct bilingual_str;
 namespace common {
@@ -43,6 +44,11 @@ namespace node {
 enum class TransactionError;
 } // namespace node
 
+//! Minimum number of positions for descriptor ranges to be expanded on a thread pool
+static constexpr int64_t PARALLEL_DESCRIPTOR_EXPAND_MIN_POSITIONS{1000};
+//! Maximum number of threads descriptor ranges are expanded on
+static constexpr int MAX_DESCRIPTOR_EXPAND_WORKERS{8};
+
 static constexpr bool DEFAULT_RPC_DOC_CHECK{
 #ifdef RPC_DOC_CHECK
     true
@@ -150,6 +156,9 @@ UniValue JSONRPCTransactionError(node::TransactionError terr, const std::string&
 //! Parse a JSON range specified as int64, or [int64, int64]
 std::pair<int64_t, int64_t> ParseDescriptorRange(const UniValue& value);
 
+/** Expand a descriptor at all positions of the inclusive range with ExpandRange, on a shared thread pool started on first use for large ranges. */
+bool ExpandDescriptorRange(const Descriptor& desc, std::pair<int64_t, int64_t> range, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, FlatSigningProvider& out);
+
 /** Evaluate a descriptor given as a string, or as a {"desc":...,"range":...} object, with default range of 1000. */
 std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, FlatSigningProvider& provider, const bool expand_priv = false);
 
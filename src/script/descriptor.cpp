@@ -16,16 +16,23 @@
 
 #include <common/args.h>
 #include <span.h>
+#include <sync.h>
 #include <util/bip32.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <util/vector.h>
 
 #include <algorithm>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <list>
 #include <memory>
 #include <numeric>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using util::Split;
@@ -157,6 +164,87 @@ std::string AddChecksum(const std::string& str) { return str + "#" + DescriptorC
 
 typedef std::vector<uint32_t> KeyPath;
 
+/** Process-wide least recently used cache of BIP32 derivations done while expanding descriptors.
+ *
+ * Entries are keyed by the root extended pubkey and the derivation path, so the same derivation done
+ * by different descriptors or RPC calls is only computed once. Derivations whose caller collects them
+ * in its own DescriptorCache are not stored. Only public derivation results are stored, never private
+ * keys.
+ */
+class DerivationCache
+{
+public:
+    struct Entry {
+        //! Extended pubkey at the end of the path
+        CExtPubKey extkey;
+        //! Extended pubkey at the last hardened step of the path, if any
+        CExtPubKey last_hardened;
+    };
+
+private:
+    struct KeyHasher {
+        size_t operator()(const uint256& key) const { return ReadLE64(key.begin()); }
+    };
+    using LruList = std::list<std::pair<uint256, Entry>>;
+
+    mutable Mutex m_mutex;
+    size_t m_max_entries GUARDED_BY(m_mutex){DEFAULT_DERIVATION_CACHE_SIZE};
+    //! Entries, most recently used first
+    LruList m_entries GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, LruList::iterator, KeyHasher> m_index GUARDED_BY(m_mutex);
+
+public:
+    /** Key of the derivation of path from root. The derivation of a range position is keyed separately
+     * from the derivation of its parent path, as their entries hold different data. */
+    static uint256 Key(const CExtPubKey& root, const KeyPath& path, bool range_position)
+    {
+        unsigned char code[BIP32_EXTKEY_SIZE];
+        root.Encode(code);
+        return (HashWriter{} << code << path << range_position).GetSHA256();
+    }
+
+    bool Get(const uint256& key, Entry& entry) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        const auto it{m_index.find(key)};
+        if (it == m_index.end()) return false;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        entry = it->second->second;
+        return true;
+    }
+
+    void Put(const uint256& key, const Entry& entry) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        if (m_max_entries == 0 || m_index.contains(key)) return;
+        m_entries.emplace_front(key, entry);
+        m_index.emplace(key, m_entries.begin());
+        Evict();
+    }
+
+    void Resize(size_t max_entries) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        m_max_entries = max_entries;
+        Evict();
+    }
+
+private:
+    void Evict() EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        while (m_entries.size() > m_max_entries) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+};
+
+DerivationCache& GetDerivationCache()
+{
+    static DerivationCache cache;
+    return cache;
+}
+
 /** Interface for public key objects in descriptors. */
 struct PubkeyProvider
 {
@@ -420,24 +508,57 @@ public:
                 final_extkey = parent_extkey;
                 if (m_derive == DeriveType::UNHARDENED) der = parent_extkey.Derive(final_extkey, pos);
             }
-        } else if (IsHardened()) {
-            CExtKey xprv;
-            CExtKey lh_xprv;
-            if (!GetDerivedExtKey(arg, xprv, lh_xprv)) return false;
-            parent_extkey = xprv.Neuter();
-            if (m_derive == DeriveType::UNHARDENED) der = xprv.Derive(xprv, pos);
-            if (m_derive == DeriveType::HARDENED) der = xprv.Derive(xprv, pos | 0x80000000UL);
-            final_extkey = xprv.Neuter();
-            if (lh_xprv.key.IsValid()) {
-                last_hardened_extkey = lh_xprv.Neuter();
-            }
         } else {
-            for (auto entry : m_path) {
-                if (!parent_extkey.Derive(parent_extkey, entry)) return false;
+            // Derivations are memoized in the process-wide derivation cache, unless the caller collects
+            // them in write_cache (as wallets do when topping up), where putting them in the shared
+            // cache as well would only evict the entries of other callers. Hardened derivation needs
+            // the private key, so the cache is only consulted once the key is known to be available.
+            // This way the cache never lets a derivation succeed that would fail without it.
+            DerivationCache* const derivation_cache{write_cache ? nullptr : &GetDerivationCache()};
+            if (derivation_cache && IsHardened()) {
+                CKey root_key;
+                if (!arg.GetKey(m_root_extkey.pubkey.GetID(), root_key)) return false;
+            }
+            const uint256 parent_cache_key{derivation_cache ? DerivationCache::Key(m_root_extkey, m_path, /*range_position=*/false) : uint256{}};
+            const uint256 final_cache_key{derivation_cache ? DerivationCache::Key(m_root_extkey, final_info_out_tmp.path, /*range_position=*/true) : uint256{}};
+            DerivationCache::Entry parent_entry;
+            DerivationCache::Entry final_entry;
+            const bool have_parent{derivation_cache && derivation_cache->Get(parent_cache_key, parent_entry)};
+            const bool have_final{m_derive == DeriveType::NO || (have_parent && derivation_cache->Get(final_cache_key, final_entry))};
+            if (have_parent) {
+                parent_extkey = parent_entry.extkey;
+                last_hardened_extkey = parent_entry.last_hardened;
+            }
+            if (have_parent && have_final) {
+                final_extkey = m_derive == DeriveType::NO ? parent_extkey : final_entry.extkey;
+            } else if (have_parent && m_derive == DeriveType::UNHARDENED) {
+                der = parent_extkey.Derive(final_extkey, pos);
+                if (der) derivation_cache->Put(final_cache_key, {final_extkey, {}});
+            } else {
+                if (IsHardened()) {
+                    CExtKey xprv;
+                    CExtKey lh_xprv;
+                    if (!GetDerivedExtKey(arg, xprv, lh_xprv)) return false;
+                    parent_extkey = xprv.Neuter();
+                    if (m_derive == DeriveType::UNHARDENED) der = xprv.Derive(xprv, pos);
+                    if (m_derive == DeriveType::HARDENED) der = xprv.Derive(xprv, pos | 0x80000000UL);
+                    final_extkey = xprv.Neuter();
+                    if (lh_xprv.key.IsValid()) {
+                        last_hardened_extkey = lh_xprv.Neuter();
+                    }
+                } else {
+                    for (auto entry : m_path) {
+                        if (!parent_extkey.Derive(parent_extkey, entry)) return false;
+                    }
+                    final_extkey = parent_extkey;
+                    if (m_derive == DeriveType::UNHARDENED) der = parent_extkey.Derive(final_extkey, pos);
+                    assert(m_derive != DeriveType::HARDENED);
+                }
+                if (der && derivation_cache) {
+                    derivation_cache->Put(parent_cache_key, {parent_extkey, last_hardened_extkey});
+                    if (m_derive != DeriveType::NO) derivation_cache->Put(final_cache_key, {final_extkey, {}});
+                }
             }
-            final_extkey = parent_extkey;
-            if (m_derive == DeriveType::UNHARDENED) der = parent_extkey.Derive(final_extkey, pos);
-            assert(m_derive != DeriveType::HARDENED);
         }
         if (!der) return false;
 
@@ -2393,6 +2514,59 @@ uint256 DescriptorID(const Descriptor& desc)
     return id;
 }
 
+bool ExpandRange(const Descriptor& desc, int64_t begin, int64_t end, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, FlatSigningProvider& out, ThreadPool* thread_pool)
+{
+    struct Chunk {
+        std::vector<std::vector<CScript>> scripts;
+        FlatSigningProvider out;
+        bool success{true};
+    };
+    const auto expand_chunk{[&desc, &provider](int64_t chunk_begin, int64_t chunk_end) {
+        Chunk chunk;
+        chunk.scripts.resize(chunk_end - chunk_begin);
+        for (int64_t pos = chunk_begin; pos < chunk_end && chunk.success; ++pos) {
+            chunk.success = desc.Expand(pos, provider, chunk.scripts[pos - chunk_begin], chunk.out);
+        }
+        return chunk;
+    }};
+
+    // All chunks are expanded before anything is written to out, which may be the same object as provider
+    std::vector<Chunk> chunks;
+    if (thread_pool && end - begin > DESCRIPTOR_EXPAND_RANGE_CHUNK_SIZE) {
+        std::vector<std::future<Chunk>> futures;
+        for (int64_t chunk_begin = begin; chunk_begin < end; chunk_begin += DESCRIPTOR_EXPAND_RANGE_CHUNK_SIZE) {
+            const int64_t chunk_end{std::min(end, chunk_begin + DESCRIPTOR_EXPAND_RANGE_CHUNK_SIZE)};
+            futures.push_back(thread_pool->Submit([&expand_chunk, chunk_begin, chunk_end] { return expand_chunk(chunk_begin, chunk_end); }));
+        }
+        // Wait for all chunks even if one fails, as they reference desc and provider
+        std::exception_ptr error;
+        for (auto& future : futures) {
+            try {
+                chunks.push_back(future.get());
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    } else if (begin < end) {
+        chunks.push_back(expand_chunk(begin, end));
+    }
+
+    output_scripts.clear();
+    output_scripts.reserve(std::max<int64_t>(end - begin, 0));
+    for (auto& chunk : chunks) {
+        if (!chunk.success) return false;
+        out.Merge(std::move(chunk.out));
+        std::move(chunk.scripts.begin(), chunk.scripts.end(), std::back_inserter(output_scripts));
+    }
+    return true;
+}
+
+void SetDescriptorDerivationCacheSize(size_t max_entries)
+{
+    GetDerivationCache().Resize(max_entries);
+}
+
 void DescriptorCache::CacheParentExtPubKey(uint32_t key_exp_pos, const CExtPubKey& xpub)
 {
     m_parent_xpubs[key_exp_pos] = xpub;
@@ -10,9 +10,13 @@
 #include <script/sign.h>
 #include <script/signingprovider.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
+class ThreadPool;
+
 using ExtPubKeyMap = std::unordered_map<uint32_t, CExtPubKey>;
 
 /** Cache for single descriptor's derived extended pubkeys */
@@ -206,4 +210,26 @@ std::unique_ptr<Descriptor> InferDescriptor(const CScript& script, const Signing
 */
 uint256 DescriptorID(const Descriptor& desc);
 
+//! Number of positions ExpandRange expands per thread pool task
+static constexpr int64_t DESCRIPTOR_EXPAND_RANGE_CHUNK_SIZE{250};
+
+/** Expand a descriptor at all positions in [begin, end).
+ *
+ * If thread_pool is not nullptr (and has workers), the positions are expanded in chunks on it, so
+ * provider must not be modified concurrently. Nothing is written to out before all positions are
+ * expanded, so it may be equal to `provider`.
+ *
+ * @param[out] output_scripts The expanded scriptPubKeys of every position, in order.
+ * @param[out] out Scripts and public keys necessary for solving the expanded scriptPubKeys.
+ * @return false if the descriptor could not be expanded at any of the positions
+ */
+bool ExpandRange(const Descriptor& desc, int64_t begin, int64_t end, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, FlatSigningProvider& out, ThreadPool* thread_pool = nullptr);
+
+//! Default maximum number of derivations kept by the process-wide descriptor derivation cache
+static constexpr size_t DEFAULT_DERIVATION_CACHE_SIZE{16384};
+
+/** Set the maximum number of derivations kept by the process-wide cache of BIP32 derivations that
+ * descriptors use when they are expanded without a DescriptorCache to read from. 0 disables it. */
+void SetDescriptorDerivationCacheSize(size_t max_entries);
+
 #endif // BITCOIN_SCRIPT_DESCRIPTOR_H
@@ -0,0 +1,240 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <consensus/validation.h>
+#include <index/addressindex.h>
+#include <interfaces/chain.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <util/threadpool.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+namespace {
+struct AddressIndexSetup : public TestChain100Setup {
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const CScript dest_script{GetScriptForDestination(WitnessV0KeyHash(GenerateRandomKey().GetPubKey()))};
+
+    /** Mine a block spending the first coinbase output to dest_script. */
+    CMutableTransaction SpendToDest(size_t coinbase_index)
+    {
+        CMutableTransaction tx{CreateValidMempoolTransaction(m_coinbase_txns[coinbase_index], /*input_vout=*/0, /*input_height=*/coinbase_index + 1,
+                                                             coinbaseKey, dest_script, /*output_amount=*/10 * COIN, /*submit=*/false)};
+        CreateAndProcessBlock({tx}, coinbase_script);
+        return tx;
+    }
+};
+
+bool HasUnspent(const std::vector<AddressUnspentEntry>& entries, const COutPoint& outpoint)
+{
+    return std::any_of(entries.begin(), entries.end(), [&](const auto& entry) { return entry.outpoint == outpoint; });
+}
+
+/** Check the running totals of a script against its history and unspent outputs. */
+void CheckBalance(const AddressIndex& index, const CScript& script)
+{
+    std::vector<AddressHistoryEntry> history;
+    std::vector<AddressUnspentEntry> unspent;
+    AddressBalance balance;
+    BOOST_REQUIRE(index.LookUpHistory(script, history));
+    BOOST_REQUIRE(index.LookUpUnspent(script, unspent));
+    BOOST_REQUIRE(index.LookUpBalance(script, balance));
+
+    CAmount expected_balance{0};
+    for (const auto& entry : unspent) expected_balance += entry.amount;
+    CAmount expected_received{0};
+    for (const auto& entry : history) {
+        if (!entry.spent) expected_received += entry.amount;
+    }
+    BOOST_CHECK_EQUAL(balance.balance, expected_balance);
+    BOOST_CHECK_EQUAL(balance.received, expected_received);
+    BOOST_CHECK_EQUAL(balance.unspent, static_cast<int64_t>(unspent.size()));
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(addressindex_tests, AddressIndexSetup)
+
+BOOST_AUTO_TEST_CASE(addressindex_initial_sync)
+{
+    const CMutableTransaction spend{SpendToDest(0)};
+    const COutPoint spent_outpoint{m_coinbase_txns[0]->GetHash(), 0};
+
+    AddressIndex address_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(address_index.Init());
+
+    // BlockUntilSyncedToCurrentChain should return false before the index is started.
+    BOOST_CHECK(!address_index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(address_index.StartBackgroundSync());
+    IndexWaitSynced(address_index, *Assert(m_node.shutdown_signal));
+
+    std::vector<AddressHistoryEntry> history;
+    std::vector<AddressUnspentEntry> unspent;
+    BOOST_REQUIRE(address_index.LookUpHistory(dest_script, history));
+    BOOST_REQUIRE(address_index.LookUpUnspent(dest_script, unspent));
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].height, 101);
+    BOOST_CHECK(history[0].txid == spend.GetHash());
+    BOOST_CHECK(!history[0].spent);
+    BOOST_CHECK_EQUAL(history[0].amount, 10 * COIN);
+    BOOST_REQUIRE_EQUAL(unspent.size(), 1U);
+    BOOST_CHECK(unspent[0].outpoint == COutPoint(spend.GetHash(), 0));
+    BOOST_CHECK_EQUAL(unspent[0].amount, 10 * COIN);
+
+    // 101 coinbase outputs paid to the coinbase script and one was spent
+    history.clear();
+    unspent.clear();
+    BOOST_REQUIRE(address_index.LookUpHistory(coinbase_script, history));
+    BOOST_REQUIRE(address_index.LookUpUnspent(coinbase_script, unspent));
+    BOOST_CHECK_EQUAL(history.size(), 102U);
+    BOOST_CHECK_EQUAL(unspent.size(), 100U);
+    BOOST_CHECK(!HasUnspent(unspent, spent_outpoint));
+    BOOST_CHECK(std::is_sorted(history.begin(), history.end(), [](const auto& a, const auto& b) { return a.height < b.height; }));
+    const auto debit{std::find_if(history.begin(), history.end(), [](const auto& entry) { return entry.spent; })};
+    BOOST_REQUIRE(debit != history.end());
+    BOOST_CHECK_EQUAL(debit->height, 101);
+    BOOST_CHECK(debit->txid == spend.GetHash());
+    BOOST_CHECK_EQUAL(debit->amount, -m_coinbase_txns[0]->vout[0].nValue);
+
+    // Height range lookups
+    history.clear();
+    BOOST_REQUIRE(address_index.LookUpHistory(coinbase_script, 10, 19, history));
+    BOOST_CHECK_EQUAL(history.size(), 10U);
+    BOOST_CHECK(std::all_of(history.begin(), history.end(), [](const auto& entry) { return entry.height >= 10 && entry.height <= 19; }));
+
+    // New blocks make it into the index
+    const CBlock block{CreateAndProcessBlock({}, dest_script)};
+    BOOST_CHECK(address_index.BlockUntilSyncedToCurrentChain());
+    unspent.clear();
+    BOOST_REQUIRE(address_index.LookUpUnspent(dest_script, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), 2U);
+    BOOST_CHECK(HasUnspent(unspent, COutPoint(block.vtx[0]->GetHash(), 0)));
+
+    AddressBalance balance;
+    BOOST_REQUIRE(address_index.LookUpBalance(dest_script, balance));
+    BOOST_CHECK_EQUAL(balance.unspent, 2);
+    BOOST_CHECK_EQUAL(balance.received, balance.balance);
+    CheckBalance(address_index, dest_script);
+    CheckBalance(address_index, coinbase_script);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    address_index.Stop();
+}
+
+BOOST_AUTO_TEST_CASE(addressindex_parallel_initial_sync)
+{
+    for (size_t i = 0; i < 5; ++i) SpendToDest(i);
+
+    ThreadPool thread_pool{"test_index"};
+    thread_pool.Start(3);
+
+    AddressIndex sequential_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    AddressIndex parallel_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(sequential_index.Init());
+    BOOST_REQUIRE(parallel_index.Init());
+    parallel_index.SetThreadPool(thread_pool, /*batch_size=*/8);
+    BOOST_REQUIRE(sequential_index.StartBackgroundSync());
+    BOOST_REQUIRE(parallel_index.StartBackgroundSync());
+    IndexWaitSynced(sequential_index, *Assert(m_node.shutdown_signal));
+    IndexWaitSynced(parallel_index, *Assert(m_node.shutdown_signal));
+
+    for (const CScript& script : {coinbase_script, dest_script}) {
+        std::vector<AddressHistoryEntry> expected_history, history;
+        BOOST_REQUIRE(sequential_index.LookUpHistory(script, expected_history));
+        BOOST_REQUIRE(parallel_index.LookUpHistory(script, history));
+        BOOST_REQUIRE_EQUAL(history.size(), expected_history.size());
+        for (size_t i = 0; i < history.size(); ++i) {
+            BOOST_CHECK_EQUAL(history[i].height, expected_history[i].height);
+            BOOST_CHECK(history[i].txid == expected_history[i].txid);
+            BOOST_CHECK_EQUAL(history[i].index, expected_history[i].index);
+            BOOST_CHECK_EQUAL(history[i].spent, expected_history[i].spent);
+            BOOST_CHECK_EQUAL(history[i].amount, expected_history[i].amount);
+        }
+
+        std::vector<AddressUnspentEntry> expected_unspent, unspent;
+        BOOST_REQUIRE(sequential_index.LookUpUnspent(script, expected_unspent));
+        BOOST_REQUIRE(parallel_index.LookUpUnspent(script, unspent));
+        BOOST_REQUIRE_EQUAL(unspent.size(), expected_unspent.size());
+        for (size_t i = 0; i < unspent.size(); ++i) {
+            BOOST_CHECK(unspent[i].outpoint == expected_unspent[i].outpoint);
+            BOOST_CHECK_EQUAL(unspent[i].height, expected_unspent[i].height);
+            BOOST_CHECK_EQUAL(unspent[i].amount, expected_unspent[i].amount);
+        }
+
+        CheckBalance(sequential_index, script);
+        CheckBalance(parallel_index, script);
+    }
+
+    std::vector<AddressUnspentEntry> unspent;
+    BOOST_REQUIRE(parallel_index.LookUpUnspent(dest_script, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), 5U);
+
+    sequential_index.Interrupt();
+    parallel_index.Interrupt();
+    sequential_index.Stop();
+    parallel_index.Stop();
+}
+
+BOOST_AUTO_TEST_CASE(addressindex_reorg)
+{
+    AddressIndex address_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(address_index.Init());
+    BOOST_REQUIRE(address_index.StartBackgroundSync());
+    IndexWaitSynced(address_index, *Assert(m_node.shutdown_signal));
+
+    const COutPoint spent_outpoint{m_coinbase_txns[0]->GetHash(), 0};
+    SpendToDest(0);
+    BOOST_CHECK(address_index.BlockUntilSyncedToCurrentChain());
+
+    std::vector<AddressHistoryEntry> history;
+    std::vector<AddressUnspentEntry> unspent;
+    BOOST_REQUIRE(address_index.LookUpUnspent(dest_script, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), 1U);
+    unspent.clear();
+    BOOST_REQUIRE(address_index.LookUpUnspent(coinbase_script, unspent));
+    BOOST_CHECK(!HasUnspent(unspent, spent_outpoint));
+    CheckBalance(address_index, dest_script);
+    CheckBalance(address_index, coinbase_script);
+
+    // Replace the block containing the spend with one that does not include it
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_CHECK(address_index.BlockUntilSyncedToCurrentChain());
+
+    unspent.clear();
+    BOOST_REQUIRE(address_index.LookUpHistory(dest_script, history));
+    BOOST_REQUIRE(address_index.LookUpUnspent(dest_script, unspent));
+    BOOST_CHECK(history.empty());
+    BOOST_CHECK(unspent.empty());
+
+    history.clear();
+    unspent.clear();
+    BOOST_REQUIRE(address_index.LookUpHistory(coinbase_script, history));
+    BOOST_REQUIRE(address_index.LookUpUnspent(coinbase_script, unspent));
+    BOOST_CHECK(HasUnspent(unspent, spent_outpoint));
+    BOOST_CHECK_EQUAL(unspent.size(), 102U);
+    BOOST_CHECK_EQUAL(history.size(), 102U);
+    BOOST_CHECK(std::none_of(history.begin(), history.end(), [](const auto& entry) { return entry.spent; }));
+
+    // The totals of the disconnected block are reverted too
+    AddressBalance balance;
+    BOOST_REQUIRE(address_index.LookUpBalance(dest_script, balance));
+    BOOST_CHECK_EQUAL(balance.received, 0);
+    CheckBalance(address_index, dest_script);
+    CheckBalance(address_index, coinbase_script);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    address_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
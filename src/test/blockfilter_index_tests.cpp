@@ -14,6 +14,7 @@
 #include <test/util/blockfilter.h>
 #include <test/util/index.h>
 #include <test/util/setup_common.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -271,6 +272,41 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_parallel_initial_sync, BuildChainTestingSetup)
+{
+    // Extend the chain so that the sync runs over several batches.
+    const CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+    CScript coinbase_script_pub_key{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+    std::vector<std::shared_ptr<CBlock>> chain;
+    BOOST_REQUIRE(BuildChain(tip, coinbase_script_pub_key, 50, chain));
+    for (const auto& block : chain) {
+        BOOST_REQUIRE(Assert(m_node.chainman)->ProcessNewBlock(block, true, true, nullptr));
+    }
+
+    ThreadPool thread_pool{"test_index"};
+    thread_pool.Start(3);
+
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.SetThreadPool(thread_pool, /*batch_size=*/16);
+    BOOST_REQUIRE(filter_index.StartBackgroundSync());
+    IndexWaitSynced(filter_index, *Assert(m_node.shutdown_signal));
+
+    // Filters and the chained filter headers must match a sequential computation.
+    {
+        LOCK(cs_main);
+        uint256 last_header;
+        for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+             block_index != nullptr;
+             block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+            CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+        }
+    }
+
+    filter_index.Interrupt();
+    filter_index.Stop();
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
@@ -5,6 +5,7 @@
 #include <addresstype.h>
 #include <clientversion.h>
 #include <coins.h>
+#include <consensus/amount.h>
 #include <streams.h>
 #include <test/util/poolresourcetester.h>
 #include <test/util/random.h>
@@ -14,6 +15,7 @@
 #include <undo.h>
 #include <util/strencodings.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <variant>
@@ -1049,6 +1051,65 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_db_snapshot_ranges)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    {
+        CCoinsViewCache cache{&base};
+        cache.SetBestBlock(m_rng.rand256());
+        for (int i = 0; i < 2000; ++i) {
+            uint256 txid{m_rng.rand256()};
+            // Cover the boundaries of the key space
+            if (i == 0) std::fill(txid.begin(), txid.begin() + 2, 0x00);
+            if (i == 1) std::fill(txid.begin(), txid.begin() + 2, 0xff);
+            const uint32_t num_outputs{1 + static_cast<uint32_t>(m_rng.randrange(3))};
+            for (uint32_t n = 0; n < num_outputs; ++n) {
+                Coin coin{CTxOut{m_rng.randrange(MAX_MONEY), CScript() << m_rng.randbytes(20)}, 1, false};
+                cache.AddCoin(COutPoint{Txid::FromUint256(txid), n}, std::move(coin), /*possible_overwrite=*/false);
+            }
+        }
+        BOOST_REQUIRE(cache.Flush());
+    }
+
+    std::vector<COutPoint> expected;
+    for (auto cursor{base.Cursor()}; cursor->Valid(); cursor->Next()) {
+        COutPoint key;
+        BOOST_REQUIRE(cursor->GetKey(key));
+        expected.push_back(key);
+    }
+
+    const auto snapshot{base.Snapshot()};
+    BOOST_REQUIRE(snapshot);
+    BOOST_CHECK_EQUAL(snapshot->GetBestBlock(), base.GetBestBlock());
+
+    // Coins written after the snapshot was taken are not visible through it
+    {
+        CCoinsViewCache cache{&base};
+        cache.SetBestBlock(m_rng.rand256());
+        cache.AddCoin(COutPoint{Txid::FromUint256(m_rng.rand256()), 0}, Coin{CTxOut{1, CScript{}}, 1, false}, /*possible_overwrite=*/false);
+        BOOST_REQUIRE(cache.Flush());
+    }
+
+    // Concatenating the ranges yields the same coins, in the same order, as a full cursor
+    for (const uint32_t num_ranges : {1U, 7U, CCoinsViewSnapshot::NUM_SCAN_RANGES}) {
+        std::vector<COutPoint> keys;
+        for (uint32_t range = 0; range < num_ranges; ++range) {
+            const uint32_t prefix_begin{range * CCoinsViewSnapshot::NUM_PREFIXES / num_ranges};
+            const uint32_t prefix_end{(range + 1) * CCoinsViewSnapshot::NUM_PREFIXES / num_ranges};
+            for (auto cursor{snapshot->Cursor(prefix_begin, prefix_end)}; cursor->Valid(); cursor->Next()) {
+                COutPoint key;
+                Coin coin;
+                BOOST_REQUIRE(cursor->GetKey(key));
+                BOOST_REQUIRE(cursor->GetValue(coin));
+                BOOST_CHECK(CCoinsViewSnapshot::Prefix(key) >= prefix_begin && CCoinsViewSnapshot::Prefix(key) < prefix_end);
+                keys.push_back(key);
+            }
+        }
+        BOOST_CHECK(keys == expected);
+    }
+    BOOST_CHECK(!snapshot->Cursor(5, 5)->Valid());
+}
+
 BOOST_AUTO_TEST_CASE(coins_resource_is_used)
 {
     CCoinsMapMemoryResource resource;
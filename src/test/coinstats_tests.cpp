@@ -0,0 +1,80 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <kernel/coinstats.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <util/threadpool.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <stdexcept>
+
+using kernel::CoinStatsHashType;
+
+namespace {
+/** A view over the coins database that cannot be scanned in parallel */
+class CoinsViewWithoutSnapshot : public CCoinsViewBacked
+{
+public:
+    using CCoinsViewBacked::CCoinsViewBacked;
+    std::unique_ptr<CCoinsViewSnapshot> Snapshot() const override { return nullptr; }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(coinstats_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(coinstats_parallel_compute)
+{
+    ThreadPool thread_pool{"coinstats"};
+    thread_pool.Start(3);
+
+    LOCK(cs_main);
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    chainstate.ForceFlushStateToDisk();
+
+    for (const auto hash_type : {CoinStatsHashType::HASH_SERIALIZED, CoinStatsHashType::MUHASH, CoinStatsHashType::NONE}) {
+        const auto sequential{kernel::ComputeUTXOStats(hash_type, &chainstate.CoinsDB(), chainstate.m_blockman)};
+        const auto parallel{kernel::ComputeUTXOStats(hash_type, &chainstate.CoinsDB(), chainstate.m_blockman, {}, &thread_pool)};
+        BOOST_REQUIRE(sequential && parallel);
+        BOOST_CHECK_EQUAL(parallel->hashBlock, sequential->hashBlock);
+        BOOST_CHECK_EQUAL(parallel->hashSerialized, sequential->hashSerialized);
+        BOOST_CHECK_EQUAL(parallel->nTransactions, sequential->nTransactions);
+        BOOST_CHECK_EQUAL(parallel->nTransactionOutputs, sequential->nTransactionOutputs);
+        BOOST_CHECK_EQUAL(parallel->nBogoSize, sequential->nBogoSize);
+        BOOST_CHECK_EQUAL(parallel->coins_count, sequential->coins_count);
+        BOOST_CHECK(parallel->total_amount == sequential->total_amount);
+    }
+
+    // Interrupting the parallel computation propagates the exception
+    BOOST_CHECK_THROW(kernel::ComputeUTXOStats(CoinStatsHashType::MUHASH, &chainstate.CoinsDB(), chainstate.m_blockman,
+                                               [] { throw std::runtime_error("interrupted"); }, &thread_pool),
+                      std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(coinstats_sequential_fallback)
+{
+    ThreadPool thread_pool{"coinstats"};
+    thread_pool.Start(2);
+
+    LOCK(cs_main);
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    chainstate.ForceFlushStateToDisk();
+
+    // A cache cannot hand out a snapshot, since it would miss the cached changes
+    BOOST_CHECK(!CCoinsViewCache{&chainstate.CoinsDB()}.Snapshot());
+
+    // Views without snapshots are scanned sequentially even when a thread pool is given
+    CoinsViewWithoutSnapshot view{&chainstate.CoinsDB()};
+    const auto expected{kernel::ComputeUTXOStats(CoinStatsHashType::MUHASH, &chainstate.CoinsDB(), chainstate.m_blockman)};
+    const auto stats{kernel::ComputeUTXOStats(CoinStatsHashType::MUHASH, &view, chainstate.m_blockman, {}, &thread_pool)};
+    BOOST_REQUIRE(expected && stats);
+    BOOST_CHECK_EQUAL(stats->hashSerialized, expected->hashSerialized);
+    BOOST_CHECK_EQUAL(stats->coins_count, expected->coins_count);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,7 @@
 #include <test/util/index.h>
 #include <test/util/setup_common.h>
 #include <test/util/validation.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -76,6 +77,47 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_initial_sync, TestChain100Setup)
     coin_stats_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(coinstatsindex_parallel_initial_sync, TestChain100Setup)
+{
+    // Add blocks that spend coins, so the per-block MuHash deltas have both a
+    // numerator and a denominator.
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    for (int i = 0; i < 5; ++i) {
+        CMutableTransaction tx{CreateValidMempoolTransaction(m_coinbase_txns[i], /*input_vout=*/0, /*input_height=*/i + 1,
+                                                             coinbaseKey, script_pub_key, /*output_amount=*/10 * COIN, /*submit=*/false)};
+        CreateAndProcessBlock({tx}, script_pub_key);
+    }
+
+    ThreadPool thread_pool{"test_index"};
+    thread_pool.Start(3);
+
+    CoinStatsIndex sequential_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    CoinStatsIndex parallel_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(sequential_index.Init());
+    BOOST_REQUIRE(parallel_index.Init());
+    parallel_index.SetThreadPool(thread_pool, /*batch_size=*/8);
+    BOOST_REQUIRE(sequential_index.StartBackgroundSync());
+    BOOST_REQUIRE(parallel_index.StartBackgroundSync());
+    IndexWaitSynced(sequential_index, *Assert(m_node.shutdown_signal));
+    IndexWaitSynced(parallel_index, *Assert(m_node.shutdown_signal));
+
+    LOCK(cs_main);
+    for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+         block_index != nullptr;
+         block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+        const auto expected{sequential_index.LookUpStats(*block_index)};
+        const auto stats{parallel_index.LookUpStats(*block_index)};
+        BOOST_REQUIRE(expected && stats);
+        BOOST_CHECK_EQUAL(stats->hashSerialized, expected->hashSerialized);
+        BOOST_CHECK_EQUAL(stats->nTransactionOutputs, expected->nTransactionOutputs);
+        BOOST_CHECK_EQUAL(stats->nBogoSize, expected->nBogoSize);
+        BOOST_CHECK_EQUAL(*stats->total_amount, *expected->total_amount);
+        BOOST_CHECK_EQUAL(stats->total_prevout_spent_amount, expected->total_prevout_spent_amount);
+        BOOST_CHECK_EQUAL(stats->total_unspendable_amount, expected->total_unspendable_amount);
+        BOOST_CHECK_EQUAL(stats->total_unspendables_unclaimed_rewards, expected->total_unspendables_unclaimed_rewards);
+    }
+}
+
 // Test shutdown between BlockConnected and ChainStateFlushed notifications,
 // make sure index is not corrupted and is able to reload.
 BOOST_FIXTURE_TEST_CASE(coinstatsindex_unclean_shutdown, TestChain100Setup)
@@ -202,6 +202,40 @@ BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_snapshot)
+{
+    for (const bool obfuscate : {false, true}) {
+        fs::path ph = m_args.GetDataDirBase() / (obfuscate ? "dbwrapper_snapshot_obfuscate_true" : "dbwrapper_snapshot_obfuscate_false");
+        CDBWrapper dbw({.path = ph, .cache_bytes = 1 << 20, .memory_only = true, .wipe_data = false, .obfuscate = obfuscate});
+
+        uint8_t key{'j'};
+        uint256 in = m_rng.rand256();
+        BOOST_CHECK(dbw.Write(key, in));
+
+        const std::unique_ptr<CDBSnapshot> snapshot{dbw.NewSnapshot()};
+
+        // Writes after the snapshot was taken are not visible through it
+        BOOST_CHECK(dbw.Write(key, m_rng.rand256()));
+        uint8_t key2{'k'};
+        BOOST_CHECK(dbw.Write(key2, m_rng.rand256()));
+
+        for (int i = 0; i < 2; ++i) {
+            std::unique_ptr<CDBIterator> it(snapshot->NewIterator());
+            it->Seek(key);
+
+            uint8_t key_res;
+            uint256 val_res;
+            BOOST_REQUIRE(it->GetKey(key_res));
+            BOOST_REQUIRE(it->GetValue(val_res));
+            BOOST_CHECK_EQUAL(key_res, key);
+            BOOST_CHECK_EQUAL(val_res.ToString(), in.ToString());
+
+            it->Next();
+            BOOST_CHECK_EQUAL(it->Valid(), false);
+        }
+    }
+}
+
 // Test that we do not obfuscation if there is existing data.
 BOOST_AUTO_TEST_CASE(existing_data_no_obfuscate)
 {
@@ -8,6 +8,7 @@
 #include <test/util/setup_common.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -1073,4 +1074,65 @@ BOOST_AUTO_TEST_CASE(descriptor_test)
     CheckInferDescriptor("4104032540df1d3c7070a8ab3a9cdd304dfc7fd1e6541369c53c4c3310b2537d91059afc8b8e7673eb812a32978dabb78c40f2e423f7757dca61d11838c7aeeb5220ac", "pk(04032540df1d3c7070a8ab3a9cdd304dfc7fd1e6541369c53c4c3310b2537d91059afc8b8e7673eb812a32978dabb78c40f2e423f7757dca61d11838c7aeeb5220)", {}, {{"04032540df1d3c7070a8ab3a9cdd304dfc7fd1e6541369c53c4c3310b2537d91059afc8b8e7673eb812a32978dabb78c40f2e423f7757dca61d11838c7aeeb5220", ""}});
 }
 
+BOOST_AUTO_TEST_CASE(descriptor_derivation_cache_and_expand_range)
+{
+    constexpr int64_t RANGE_END{300};
+    const std::string prv{"wpkh(xprv9s21ZrQH143K31xYSDQpPDxsXRTUcvj2iNHm5NUtrGiGG5e2DtALGdso3pGz6ssrdK4PFmM8NSpSBHNqPqm55Qn3LqFtT2emdEXVYsCzC2U/84h/1h/0/*)"};
+    const std::string pub{"wpkh(xpub661MyMwAqRbcFW31YEwpkMuc5THy2PSt5bDMsktWQcFF8syAmRUapSCGu8ED9W6oDMSgv6Zz8idoc4a6mr8BDzTJY47LJhkJ8UB7WEGuduB/84h/1h/0/*)"};
+    FlatSigningProvider keys_priv, keys_pub;
+    std::string error;
+    const auto desc_priv{Parse(prv, keys_priv, error)};
+    const auto desc_pub{Parse(pub, keys_pub, error)};
+    BOOST_REQUIRE_EQUAL(desc_priv.size(), 1U);
+    BOOST_REQUIRE_EQUAL(desc_pub.size(), 1U);
+
+    const auto expand{[&](int64_t pos, std::vector<CScript>& scripts, DescriptorCache* cache) {
+        FlatSigningProvider out;
+        return desc_priv[0]->Expand(pos, keys_priv, scripts, out, cache);
+    }};
+
+    // Reference expansion without the derivation cache
+    SetDescriptorDerivationCacheSize(0);
+    std::vector<std::vector<CScript>> expected(RANGE_END);
+    DescriptorCache expected_cache;
+    for (int64_t pos = 0; pos < RANGE_END; ++pos) BOOST_CHECK(expand(pos, expected[pos], &expected_cache));
+
+    // Cold and warm derivation cache give the same scripts
+    SetDescriptorDerivationCacheSize(DEFAULT_DERIVATION_CACHE_SIZE);
+    for (int round = 0; round < 2; ++round) {
+        for (int64_t pos = 0; pos < RANGE_END; ++pos) {
+            std::vector<CScript> scripts;
+            BOOST_CHECK(expand(pos, scripts, /*cache=*/nullptr));
+            BOOST_CHECK(scripts == expected[pos]);
+        }
+    }
+
+    // Expanding into a descriptor cache bypasses the derivation cache and fills the descriptor cache as before
+    DescriptorCache cache;
+    for (int64_t pos = 0; pos < RANGE_END; ++pos) {
+        std::vector<CScript> scripts;
+        BOOST_CHECK(expand(pos, scripts, &cache));
+        BOOST_CHECK(scripts == expected[pos]);
+    }
+    BOOST_CHECK(cache.GetCachedParentExtPubKeys() == expected_cache.GetCachedParentExtPubKeys());
+    BOOST_CHECK(cache.GetCachedLastHardenedExtPubKeys() == expected_cache.GetCachedLastHardenedExtPubKeys());
+
+    // Cached hardened derivations are not used without the private key
+    std::vector<CScript> scripts;
+    FlatSigningProvider out;
+    BOOST_CHECK(!desc_pub[0]->Expand(0, keys_pub, scripts, out));
+
+    // Range expansion gives the same results with and without a thread pool, and fails without the private key
+    ThreadPool thread_pool{"descexpand"};
+    thread_pool.Start(2);
+    for (ThreadPool* pool : {static_cast<ThreadPool*>(nullptr), &thread_pool}) {
+        std::vector<std::vector<CScript>> range_scripts;
+        FlatSigningProvider range_out;
+        BOOST_CHECK(ExpandRange(*desc_priv[0], 0, RANGE_END, keys_priv, range_scripts, range_out, pool));
+        BOOST_CHECK(range_scripts == expected);
+        BOOST_CHECK_EQUAL(range_out.pubkeys.size(), size_t{RANGE_END});
+        BOOST_CHECK(!ExpandRange(*desc_pub[0], 0, RANGE_END, keys_pub, range_scripts, range_out, pool));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
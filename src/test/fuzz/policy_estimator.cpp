@@ -52,7 +52,8 @@ FUZZ_TARGET(policy_estimator, .init = initialize_policy_estimator)
                                                                /*mempool_limit_bypassed=*/false,
                                                                tx_submitted_in_package,
                                                                /*chainstate_is_current=*/true,
-                                                               tx_has_mempool_parents);
+                                                               tx_has_mempool_parents,
+                                                               entry.GetTime());
                 block_policy_estimator.processTransaction(tx_info);
                 if (fuzzed_data_provider.ConsumeBool()) {
                     (void)block_policy_estimator.removeTx(tx.GetHash());
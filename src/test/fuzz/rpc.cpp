@@ -114,6 +114,9 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "generate",
     "generateblock",
     "getaddednodeinfo",
+    "getaddressbalance",
+    "getaddresshistory",
+    "getaddressutxos",
     "getaddrmaninfo",
     "getbestblockhash",
     "getblock",
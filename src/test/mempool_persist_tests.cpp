@@ -0,0 +1,145 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/mempool_persist.h>
+#include <node/mempool_persist_args.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <boost/test/unit_test.hpp>
+
+using node::ImportMempoolOptions;
+using node::MempoolJournal;
+
+namespace {
+struct MempoolJournalSetup : public TestChain100Setup {
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const fs::path journal_dir{m_args.GetDataDirNet() / "mempool_journal"};
+    const fs::path dump_path{m_args.GetDataDirNet() / "mempool.dat"};
+
+    // Mature the second coinbase output too, so that the tests can spend two of them
+    MempoolJournalSetup() { mineBlocks(1); }
+
+    CTransactionRef SpendCoinbase(size_t coinbase_index)
+    {
+        return MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[coinbase_index], /*input_vout=*/0, /*input_height=*/coinbase_index + 1,
+                                                                coinbaseKey, coinbase_script, /*output_amount=*/49 * COIN, /*submit=*/true));
+    }
+
+    void ClearMempool()
+    {
+        LOCK2(cs_main, m_node.mempool->cs);
+        for (const auto& info : m_node.mempool->infoAll()) m_node.mempool->removeRecursive(*info.tx, MemPoolRemovalReason::EXPIRY);
+    }
+
+    CAmount GetDelta(const uint256& txid)
+    {
+        CAmount delta{0};
+        WITH_LOCK(m_node.mempool->cs, m_node.mempool->ApplyDelta(txid, delta));
+        return delta;
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(mempool_persist_tests, MempoolJournalSetup)
+
+BOOST_AUTO_TEST_CASE(mempool_journal_replay)
+{
+    MempoolJournal journal{journal_dir};
+    BOOST_REQUIRE(journal.Open());
+    m_node.validation_signals->RegisterValidationInterface(&journal);
+
+    const auto entry_time{GetTime<std::chrono::seconds>()};
+    SetMockTime(entry_time);
+    const CTransactionRef mined{SpendCoinbase(0)};
+    const CTransactionRef kept{SpendCoinbase(1)};
+    const CTransactionRef child{MakeTransactionRef(CreateValidMempoolTransaction(kept, /*input_vout=*/0, /*input_height=*/101,
+                                                                                 coinbaseKey, coinbase_script, /*output_amount=*/48 * COIN))};
+    m_node.mempool->PrioritiseTransaction(child->GetHash(), 1000);
+    journal.Prioritise(child->GetHash(), 1000);
+    CreateAndProcessBlock({CMutableTransaction{*mined}}, coinbase_script);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 2U);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    m_node.validation_signals->UnregisterValidationInterface(&journal);
+    journal.Flush();
+    BOOST_CHECK_GT(journal.GetSize(), 0U);
+
+    // Simulate an unclean shutdown, after which the mempool is restored from the journal only
+    SetMockTime(entry_time + 1h);
+    ClearMempool();
+    WITH_LOCK(m_node.mempool->cs, m_node.mempool->ClearPrioritisation(child->GetHash()));
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 0U);
+    MempoolJournal{journal_dir}.Replay(*m_node.mempool, m_node.chainman->ActiveChainstate(), {});
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 2U);
+    BOOST_CHECK(m_node.mempool->exists(GenTxid::Txid(kept->GetHash())));
+    BOOST_CHECK(m_node.mempool->exists(GenTxid::Txid(child->GetHash())));
+    BOOST_CHECK_EQUAL(GetDelta(child->GetHash()), 1000);
+    // The entries keep the time they first entered the mempool
+    BOOST_CHECK(m_node.mempool->info(GenTxid::Txid(kept->GetHash())).m_time == entry_time);
+
+    // Replaying again leaves the mempool and the prioritisation unchanged
+    MempoolJournal{journal_dir}.Replay(*m_node.mempool, m_node.chainman->ActiveChainstate(), {});
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 2U);
+    BOOST_CHECK_EQUAL(GetDelta(child->GetHash()), 1000);
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(mempool_journal_replay_removal_from_dump)
+{
+    MempoolJournal journal{journal_dir};
+    BOOST_REQUIRE(journal.Open());
+    m_node.validation_signals->RegisterValidationInterface(&journal);
+
+    const CTransactionRef evicted{SpendCoinbase(0)};
+    const CTransactionRef kept{SpendCoinbase(1)};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_REQUIRE(journal.Compact(*m_node.mempool, dump_path));
+
+    // Remove a transaction that the dump holds
+    WITH_LOCK(m_node.mempool->cs, m_node.mempool->removeRecursive(*evicted, MemPoolRemovalReason::SIZELIMIT));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    m_node.validation_signals->UnregisterValidationInterface(&journal);
+    journal.Flush();
+
+    ClearMempool();
+    BOOST_REQUIRE(node::LoadMempool(*m_node.mempool, dump_path, m_node.chainman->ActiveChainstate(), {}));
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 2U);
+    MempoolJournal{journal_dir}.Replay(*m_node.mempool, m_node.chainman->ActiveChainstate(), {});
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 1U);
+    BOOST_CHECK(!m_node.mempool->exists(GenTxid::Txid(evicted->GetHash())));
+    BOOST_CHECK(m_node.mempool->exists(GenTxid::Txid(kept->GetHash())));
+}
+
+BOOST_AUTO_TEST_CASE(mempool_journal_compact)
+{
+    MempoolJournal journal{journal_dir};
+    BOOST_REQUIRE(journal.Open());
+    m_node.validation_signals->RegisterValidationInterface(&journal);
+
+    const CTransactionRef before_dump{SpendCoinbase(0)};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_REQUIRE(journal.Compact(*m_node.mempool, dump_path));
+
+    const CTransactionRef after_dump{SpendCoinbase(1)};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    m_node.validation_signals->UnregisterValidationInterface(&journal);
+    journal.Flush();
+
+    // The dump holds the transactions added before the compaction and the
+    // journal only those added after it.
+    ClearMempool();
+    MempoolJournal{journal_dir}.Replay(*m_node.mempool, m_node.chainman->ActiveChainstate(), {});
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 1U);
+    BOOST_CHECK(m_node.mempool->exists(GenTxid::Txid(after_dump->GetHash())));
+
+    ClearMempool();
+    BOOST_REQUIRE(node::LoadMempool(*m_node.mempool, dump_path, m_node.chainman->ActiveChainstate(), {}));
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 1U);
+    BOOST_CHECK(m_node.mempool->exists(GenTxid::Txid(before_dump->GetHash())));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
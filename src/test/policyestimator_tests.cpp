@@ -15,6 +15,18 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <list>
+
+class BlockPolicyEstimatorTester
+{
+public:
+    static CFeeRate EstimateSmartFeeLocked(const CBlockPolicyEstimator& estimator, int confTarget, FeeCalculation* feeCalc, bool conservative)
+    {
+        LOCK(estimator.m_cs_fee_estimator);
+        return estimator.estimateSmartFeeLocked(confTarget, feeCalc, conservative);
+    }
+};
+
 BOOST_FIXTURE_TEST_SUITE(policyestimator_tests, ChainTestingSetup)
 
 BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
@@ -74,7 +86,8 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
                                                                                       /*mempool_limit_bypassed=*/false,
                                                                                       /*submitted_in_package=*/false,
                                                                                       /*chainstate_is_current=*/true,
-                                                                                      /*has_no_mempool_parents=*/true)};
+                                                                                      /*has_no_mempool_parents=*/true,
+                                                                                      /*entry_time=*/entry.time.time_since_epoch())};
                     m_node.validation_signals->TransactionAddedToMempool(tx_info, mpool.GetAndIncrementSequence());
                 }
                 uint256 hash = tx.GetHash();
@@ -175,7 +188,8 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
                                                                                       /*mempool_limit_bypassed=*/false,
                                                                                       /*submitted_in_package=*/false,
                                                                                       /*chainstate_is_current=*/true,
-                                                                                      /*has_no_mempool_parents=*/true)};
+                                                                                      /*has_no_mempool_parents=*/true,
+                                                                                      /*entry_time=*/entry.time.time_since_epoch())};
                     m_node.validation_signals->TransactionAddedToMempool(tx_info, mpool.GetAndIncrementSequence());
                 }
                 uint256 hash = tx.GetHash();
@@ -239,7 +253,8 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
                                                                                       /*mempool_limit_bypassed=*/false,
                                                                                       /*submitted_in_package=*/false,
                                                                                       /*chainstate_is_current=*/true,
-                                                                                      /*has_no_mempool_parents=*/true)};
+                                                                                      /*has_no_mempool_parents=*/true,
+                                                                                      /*entry_time=*/entry.time.time_since_epoch())};
                     m_node.validation_signals->TransactionAddedToMempool(tx_info, mpool.GetAndIncrementSequence());
                 }
                 uint256 hash = tx.GetHash();
@@ -265,4 +280,56 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     }
 }
 
+BOOST_AUTO_TEST_CASE(SmartFeeTable)
+{
+    CBlockPolicyEstimator fee_est{FeeestPath(*m_node.args), DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::list<CTxMemPoolEntry> mempool;
+    for (unsigned int height = 1; height <= 100; ++height) {
+        for (int i = 0; i < 20; ++i) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(COutPoint{Txid::FromUint256(rng.rand256()), 0});
+            mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+            const CTransactionRef tx{MakeTransactionRef(mtx)};
+            const CAmount fee{static_cast<CAmount>(1000 + rng.randrange(100'000))};
+            mempool.emplace_back(CTxMemPoolEntry::ExplicitCopy, TestMemPoolEntryHelper{}.Fee(fee).Height(height - 1).FromTx(tx));
+            fee_est.processTransaction(NewMempoolTransactionInfo{tx, fee, mempool.back().GetTxSize(), height - 1,
+                                                                 /*mempool_limit_bypassed=*/false, /*submitted_in_package=*/false,
+                                                                 /*chainstate_is_current=*/true, /*has_no_mempool_parents=*/true,
+                                                                 mempool.back().GetTime()});
+        }
+        // Higher fee transactions are more likely to be confirmed
+        std::vector<RemovedMempoolTransactionInfo> confirmed;
+        for (auto it = mempool.begin(); it != mempool.end();) {
+            if (static_cast<CAmount>(rng.randrange(101'000)) < it->GetFee()) {
+                confirmed.emplace_back(*it);
+                it = mempool.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        fee_est.processBlock(confirmed, height);
+
+        // Every target, including untracked ones, is answered from the table as
+        // computed from the estimator's state, whether it is computed or looked up.
+        if (height % 10 != 0) continue;
+        for (const bool conservative : {false, true}) {
+            for (int target = -1; target <= 1010; ++target) {
+                FeeCalculation expected_calc;
+                const CFeeRate expected{BlockPolicyEstimatorTester::EstimateSmartFeeLocked(fee_est, target, &expected_calc, conservative)};
+                for (int lookup = 0; lookup < 2; ++lookup) {
+                    FeeCalculation fee_calc;
+                    BOOST_CHECK(fee_est.estimateSmartFee(target, &fee_calc, conservative) == expected);
+                    BOOST_CHECK_EQUAL(fee_calc.desiredTarget, expected_calc.desiredTarget);
+                    BOOST_CHECK_EQUAL(fee_calc.returnedTarget, expected_calc.returnedTarget);
+                    BOOST_CHECK(fee_calc.reason == expected_calc.reason);
+                    BOOST_CHECK_EQUAL(fee_calc.est.decay, expected_calc.est.decay);
+                    BOOST_CHECK_EQUAL(fee_calc.est.pass.start, expected_calc.est.pass.start);
+                    BOOST_CHECK_EQUAL(fee_calc.est.fail.end, expected_calc.est.fail.end);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
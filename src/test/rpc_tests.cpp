@@ -7,9 +7,12 @@
 #include <node/context.h>
 #include <rpc/blockchain.h>
 #include <rpc/client.h>
+#include <rpc/mempool.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
 #include <univalue.h>
 #include <util/time.h>
 
@@ -639,4 +642,104 @@ BOOST_AUTO_TEST_CASE(rpc_arg_helper)
     CheckRpc(params, UniValue{JSON(R"([5, "hello", 4, "test", true, 1.23, "world"])")}, check_positional);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_mempool_entry_snapshots)
+{
+    CTxMemPool& pool{*Assert(m_node.mempool)};
+    TestMemPoolEntryHelper entry;
+
+    CMutableTransaction parent;
+    parent.vin.resize(1);
+    parent.vin[0].scriptSig = CScript() << OP_11;
+    parent.vout.resize(4);
+    for (auto& out : parent.vout) {
+        out.scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        out.nValue = 10000;
+    }
+    std::vector<CMutableTransaction> children(4);
+    for (uint32_t i = 0; i < children.size(); ++i) {
+        children[i].vin.resize(1);
+        children[i].vin[0].scriptSig = CScript() << OP_11;
+        children[i].vin[0].prevout = COutPoint{parent.GetHash(), i};
+        children[i].vout.resize(1);
+        children[i].vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        children[i].vout[0].nValue = 9000;
+    }
+    {
+        LOCK2(cs_main, pool.cs);
+        AddToMempool(pool, entry.Fee(1000).FromTx(parent));
+        for (const auto& child : children) AddToMempool(pool, entry.Fee(1000).FromTx(child));
+    }
+
+    // Snapshots are formatted like the verbose getrawmempool result
+    const UniValue expected{MempoolToJSON(pool, /*verbose=*/true)};
+    std::vector<MempoolEntrySnapshot> snapshots;
+    MempoolEntrySnapshots all{pool, /*batch_size=*/2};
+    for (auto batch{all.Next()}; !batch.empty(); batch = all.Next()) {
+        BOOST_CHECK_LE(batch.size(), 2U);
+        for (auto& snapshot : batch) snapshots.push_back(std::move(snapshot));
+    }
+    BOOST_REQUIRE_EQUAL(snapshots.size(), 5U);
+    for (const MempoolEntrySnapshot& snapshot : snapshots) {
+        BOOST_CHECK_EQUAL(MempoolEntryToJSON(snapshot).write(), expected[snapshot.txid.ToString()].write());
+    }
+    BOOST_CHECK(snapshots[0].txid == parent.GetHash());
+    BOOST_CHECK_EQUAL(snapshots[0].spent_by.size(), 4U);
+
+    // The parts of the verbose getrawmempool result add up to it
+    std::string json;
+    const auto parts{MempoolToJSONParts(pool)};
+    while (const auto part{parts()}) json += *part;
+    BOOST_CHECK_EQUAL(json, expected.write());
+
+    // The serialized form round-trips
+    DataStream ss{};
+    ss << snapshots[1];
+    MempoolEntrySnapshot deserialized;
+    ss >> deserialized;
+    BOOST_CHECK_EQUAL(MempoolEntryToJSON(deserialized).write(), MempoolEntryToJSON(snapshots[1]).write());
+
+    // Entries removed while the mempool lock is released are skipped, also
+    // when the last entry returned is one of them
+    snapshots.clear();
+    MempoolEntrySnapshots with_removals{pool, /*batch_size=*/2};
+    auto batch{with_removals.Next()};
+    BOOST_REQUIRE_EQUAL(batch.size(), 2U);
+    const Txid last_returned{batch.back().txid};
+    const auto not_returned{std::find_if(children.begin(), children.end(), [&](const auto& child) {
+        return std::none_of(batch.begin(), batch.end(), [&](const auto& s) { return s.txid == child.GetHash(); });
+    })};
+    BOOST_REQUIRE(not_returned != children.end() && last_returned != parent.GetHash());
+    const Txid removed{not_returned->GetHash()};
+    {
+        LOCK(pool.cs);
+        pool.removeRecursive(*Assert(pool.get(last_returned)), MemPoolRemovalReason::REPLACED);
+        pool.removeRecursive(CTransaction{*not_returned}, MemPoolRemovalReason::REPLACED);
+    }
+    for (; !batch.empty(); batch = with_removals.Next()) {
+        for (auto& snapshot : batch) snapshots.push_back(std::move(snapshot));
+    }
+    BOOST_CHECK_EQUAL(snapshots.size(), 4U);
+    BOOST_CHECK(std::none_of(snapshots.begin(), snapshots.end(), [&](const auto& s) { return s.txid == removed; }));
+
+    // Entries accepted after the first batch are not included
+    MempoolEntrySnapshots with_additions{pool, /*batch_size=*/2};
+    size_t count{with_additions.Next().size()};
+    CMutableTransaction late;
+    late.vin.resize(1);
+    late.vin[0].scriptSig = CScript() << OP_12;
+    late.vin[0].prevout = COutPoint{parent.GetHash(), 4};
+    late.vout.resize(1);
+    late.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    late.vout[0].nValue = 9000;
+    {
+        LOCK2(cs_main, pool.cs);
+        AddToMempool(pool, entry.Fee(1000).Sequence(pool.GetSequence()).FromTx(late));
+    }
+    for (batch = with_additions.Next(); !batch.empty(); batch = with_additions.Next()) {
+        count += batch.size();
+        BOOST_CHECK(std::none_of(batch.begin(), batch.end(), [&](const auto& s) { return s.txid == late.GetHash(); }));
+    }
+    BOOST_CHECK_EQUAL(count, 3U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/threadpool.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(threadpool_tests)
+
+BOOST_AUTO_TEST_CASE(threadpool_submit_results)
+{
+    ThreadPool pool{"test"};
+    pool.Start(4);
+    BOOST_CHECK_EQUAL(pool.WorkersCount(), 4);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.emplace_back(pool.Submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(futures[i].get(), i * i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(threadpool_exception)
+{
+    ThreadPool pool{"test"};
+    pool.Start(2);
+    auto future{pool.Submit([]() -> int { throw std::runtime_error("task failed"); })};
+    BOOST_CHECK_THROW(future.get(), std::runtime_error);
+
+    // The worker survives the exception.
+    BOOST_CHECK_EQUAL(pool.Submit([] { return 1; }).get(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(threadpool_stop_drains_queue)
+{
+    std::atomic<int> counter{0};
+    std::vector<std::future<void>> futures;
+    ThreadPool pool{"test"};
+    pool.Start(1);
+    for (int i = 0; i < 50; ++i) {
+        futures.emplace_back(pool.Submit([&counter] { ++counter; }));
+    }
+    pool.Stop();
+    BOOST_CHECK_EQUAL(counter.load(), 50);
+    BOOST_CHECK_EQUAL(pool.WorkersCount(), 0);
+    BOOST_CHECK_EQUAL(pool.WorkQueueSize(), 0);
+
+    // No new tasks once stopped, but the pool can be restarted.
+    BOOST_CHECK_THROW((void)pool.Submit([] {}), std::runtime_error);
+    pool.Start(1);
+    BOOST_CHECK_EQUAL(pool.Submit([] { return 2; }).get(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
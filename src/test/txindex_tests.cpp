@@ -8,6 +8,7 @@
 #include <interfaces/chain.h>
 #include <test/util/index.h>
 #include <test/util/setup_common.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -77,4 +78,30 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_parallel_initial_sync, TestChain100Setup)
+{
+    ThreadPool thread_pool{"test_index"};
+    thread_pool.Start(3);
+
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(txindex.Init());
+    txindex.SetThreadPool(thread_pool, /*batch_size=*/7);
+    BOOST_REQUIRE(txindex.StartBackgroundSync());
+    IndexWaitSynced(txindex, *Assert(m_node.shutdown_signal));
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    for (const auto& txn : m_coinbase_txns) {
+        if (!txindex.FindTx(txn->GetHash(), block_hash, tx_disk)) {
+            BOOST_ERROR("FindTx failed");
+        } else if (tx_disk->GetHash() != txn->GetHash()) {
+            BOOST_ERROR("Read incorrect tx");
+        }
+    }
+    BOOST_CHECK_EQUAL(txindex.GetSummary().best_block_hash, WITH_LOCK(cs_main, return m_node.chainman->ActiveTip()->GetBlockHash()));
+
+    txindex.Interrupt();
+    txindex.Stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(txreconciliation_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(RegisterPeerTest)
@@ -81,4 +84,159 @@ BOOST_AUTO_TEST_CASE(IsPeerRegisteredTest)
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
 }
 
+BOOST_AUTO_TEST_CASE(AddToSetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    NodeId peer_id0 = 0;
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Transactions are flooded to peers we don't reconcile with.
+    BOOST_CHECK(tracker.ShouldFanoutTo(wtxid, peer_id0));
+    BOOST_CHECK(!tracker.AddToSet(peer_id0, wtxid));
+
+    tracker.PreRegisterPeer(peer_id0);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id0, false, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    // The only outbound reconciling peer always gets transactions flooded.
+    BOOST_CHECK(tracker.ShouldFanoutTo(wtxid, peer_id0));
+
+    BOOST_CHECK(tracker.AddToSet(peer_id0, wtxid));
+    BOOST_CHECK(tracker.TryRemovingFromSet(peer_id0, wtxid));
+    BOOST_CHECK(!tracker.TryRemovingFromSet(peer_id0, wtxid));
+
+    for (size_t i = 0; i < MAX_RECONSET_SIZE; ++i) {
+        BOOST_CHECK(tracker.AddToSet(peer_id0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    BOOST_CHECK(!tracker.AddToSet(peer_id0, wtxid));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationTest)
+{
+    // Node A makes an outbound connection to node B, so A initiates reconciliations.
+    TxReconciliationTracker tracker_a(TXRECONCILIATION_VERSION);
+    TxReconciliationTracker tracker_b(TXRECONCILIATION_VERSION);
+    NodeId peer_b = 0, peer_a = 1;
+    const uint64_t salt_a{tracker_a.PreRegisterPeer(peer_b)};
+    const uint64_t salt_b{tracker_b.PreRegisterPeer(peer_a)};
+    BOOST_REQUIRE_EQUAL(tracker_a.RegisterPeer(peer_b, /*is_peer_inbound=*/false, 1, salt_b), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(tracker_b.RegisterPeer(peer_a, /*is_peer_inbound=*/true, 1, salt_a), ReconciliationRegisterResult::SUCCESS);
+
+    std::vector<Wtxid> only_a, only_b;
+    for (int i = 0; i < 20; ++i) {
+        const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+        BOOST_REQUIRE(tracker_a.AddToSet(peer_b, wtxid));
+        BOOST_REQUIRE(tracker_b.AddToSet(peer_a, wtxid));
+    }
+    for (int i = 0; i < 3; ++i) {
+        only_a.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_REQUIRE(tracker_a.AddToSet(peer_b, only_a.back()));
+    }
+    for (int i = 0; i < 4; ++i) {
+        only_b.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_REQUIRE(tracker_b.AddToSet(peer_a, only_b.back()));
+    }
+
+    // Only the initiator requests sketches, one reconciliation at a time.
+    BOOST_CHECK(!tracker_b.InitiateReconciliationRequest(peer_a, 0s));
+    const auto request{tracker_a.InitiateReconciliationRequest(peer_b, 0s)};
+    BOOST_REQUIRE(request);
+    BOOST_CHECK_EQUAL(request->first, 23);
+    BOOST_CHECK(!tracker_a.InitiateReconciliationRequest(peer_b, RECON_REQUEST_INTERVAL));
+    BOOST_CHECK(!tracker_a.HandleReconciliationRequest(peer_b, request->first, request->second));
+
+    BOOST_REQUIRE(tracker_b.HandleReconciliationRequest(peer_a, request->first, request->second));
+    BOOST_CHECK(!tracker_b.HandleReconciliationRequest(peer_a, request->first, request->second));
+    const auto skdata{tracker_b.RespondToReconciliationRequest(peer_a)};
+    BOOST_REQUIRE(skdata);
+    BOOST_CHECK(!tracker_b.RespondToReconciliationRequest(peer_a));
+
+    bool success{false};
+    std::vector<uint32_t> ask_short_ids;
+    std::vector<Wtxid> a_announces, b_announces;
+    BOOST_CHECK(!tracker_b.HandleSketch(peer_a, *skdata, success, ask_short_ids, a_announces));
+    BOOST_REQUIRE(tracker_a.HandleSketch(peer_b, *skdata, success, ask_short_ids, a_announces));
+    BOOST_CHECK(success);
+    BOOST_CHECK_EQUAL(ask_short_ids.size(), only_b.size());
+    std::sort(a_announces.begin(), a_announces.end());
+    std::sort(only_a.begin(), only_a.end());
+    BOOST_CHECK(a_announces == only_a);
+
+    BOOST_REQUIRE(tracker_b.HandleReconciliationDifference(peer_a, success, ask_short_ids, b_announces));
+    BOOST_CHECK(!tracker_b.HandleReconciliationDifference(peer_a, success, ask_short_ids, b_announces));
+    std::sort(b_announces.begin(), b_announces.end());
+    std::sort(only_b.begin(), only_b.end());
+    BOOST_CHECK(b_announces == only_b);
+
+    const TxReconciliationStats stats_a{tracker_a.GetStats()}, stats_b{tracker_b.GetStats()};
+    BOOST_CHECK_EQUAL(stats_a.reconciliations_succeeded, 1U);
+    BOOST_CHECK_EQUAL(stats_a.txs_announced, 3U);
+    BOOST_CHECK_EQUAL(stats_a.txs_not_announced, 20U);
+    BOOST_CHECK_EQUAL(stats_b.reconciliations_succeeded, 1U);
+    BOOST_CHECK_EQUAL(stats_b.txs_announced, 4U);
+    BOOST_CHECK_EQUAL(stats_b.txs_not_announced, 20U);
+    BOOST_CHECK_EQUAL(stats_b.bytes_sent, skdata->size());
+
+    // A sketch too small to decode the difference makes the initiator announce its whole set.
+    for (int i = 0; i < 3; ++i) BOOST_REQUIRE(tracker_a.AddToSet(peer_b, Wtxid::FromUint256(m_rng.rand256())));
+    BOOST_REQUIRE(tracker_a.InitiateReconciliationRequest(peer_b, RECON_REQUEST_INTERVAL));
+    a_announces.clear();
+    const std::vector<uint8_t> empty_sketch(2 * sizeof(uint32_t));
+    BOOST_REQUIRE(tracker_a.HandleSketch(peer_b, empty_sketch, success, ask_short_ids, a_announces));
+    BOOST_CHECK(!success);
+    BOOST_CHECK(ask_short_ids.empty());
+    BOOST_CHECK_EQUAL(a_announces.size(), 3U);
+    BOOST_CHECK_EQUAL(tracker_a.GetStats().reconciliations_failed, 1U);
+
+    // A capacity 1 sketch decodes any non-empty difference to a single element, which
+    // the false positive protection must reject.
+    BOOST_REQUIRE(tracker_a.AddToSet(peer_b, Wtxid::FromUint256(m_rng.rand256())));
+    BOOST_REQUIRE(tracker_a.InitiateReconciliationRequest(peer_b, 2 * RECON_REQUEST_INTERVAL));
+    a_announces.clear();
+    const std::vector<uint8_t> capacity_one_sketch(sizeof(uint32_t));
+    BOOST_REQUIRE(tracker_a.HandleSketch(peer_b, capacity_one_sketch, success, ask_short_ids, a_announces));
+    BOOST_CHECK(!success);
+    BOOST_CHECK(ask_short_ids.empty());
+    BOOST_CHECK_EQUAL(a_announces.size(), 1U);
+
+    // Oversized sketches are a protocol violation.
+    BOOST_REQUIRE(tracker_a.InitiateReconciliationRequest(peer_b, 3 * RECON_REQUEST_INTERVAL));
+    const std::vector<uint8_t> oversized_sketch((MAX_SKETCH_CAPACITY + 1) * sizeof(uint32_t));
+    BOOST_CHECK(!tracker_a.HandleSketch(peer_b, oversized_sketch, success, ask_short_ids, a_announces));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationTimeoutTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    NodeId peer_id0 = 0;
+    tracker.PreRegisterPeer(peer_id0);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id0, /*is_peer_inbound=*/false, 1, 1), ReconciliationRegisterResult::SUCCESS);
+
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+    BOOST_REQUIRE(tracker.AddToSet(peer_id0, wtxid));
+    BOOST_CHECK(tracker.ExpireReconciliationRequest(peer_id0, RECON_RESPONSE_TIMEOUT).empty());
+    BOOST_REQUIRE(tracker.InitiateReconciliationRequest(peer_id0, 0s));
+
+    // The set is kept until the deadline passes, then announced.
+    BOOST_CHECK(tracker.ExpireReconciliationRequest(peer_id0, RECON_RESPONSE_TIMEOUT - 1s).empty());
+    const std::vector<Wtxid> expired{tracker.ExpireReconciliationRequest(peer_id0, RECON_RESPONSE_TIMEOUT)};
+    BOOST_REQUIRE_EQUAL(expired.size(), 1U);
+    BOOST_CHECK(expired[0] == wtxid);
+    BOOST_CHECK(tracker.ExpireReconciliationRequest(peer_id0, 2 * RECON_RESPONSE_TIMEOUT).empty());
+    BOOST_CHECK_EQUAL(tracker.GetStats().reconciliations_failed, 1U);
+
+    // Until the sketch arrives, transactions are flooded and no new request is sent.
+    BOOST_CHECK(!tracker.AddToSet(peer_id0, Wtxid::FromUint256(m_rng.rand256())));
+    BOOST_CHECK(!tracker.InitiateReconciliationRequest(peer_id0, 2 * RECON_RESPONSE_TIMEOUT));
+
+    // A late sketch is still accepted and ends the round.
+    bool success{false};
+    std::vector<uint32_t> ask_short_ids;
+    std::vector<Wtxid> announces;
+    const std::vector<uint8_t> empty_sketch(2 * sizeof(uint32_t));
+    BOOST_REQUIRE(tracker.HandleSketch(peer_id0, empty_sketch, success, ask_short_ids, announces));
+    BOOST_CHECK(success);
+    BOOST_CHECK(announces.empty());
+    BOOST_CHECK(tracker.AddToSet(peer_id0, wtxid));
+    BOOST_CHECK(tracker.InitiateReconciliationRequest(peer_id0, 2 * RECON_RESPONSE_TIMEOUT));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
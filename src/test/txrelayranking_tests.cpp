@@ -0,0 +1,145 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/txrelayranking.h>
+
+#include <kernel/mempool_entry.h>
+#include <kernel/mempool_removal_reason.h>
+#include <random.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <uint256.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+using node::TxRelayRanking;
+
+namespace {
+/** The (w)txids of the mempool in the order of entryAll(), restricted to those in pending. */
+std::vector<uint256> ExpectedOrder(const CTxMemPool& pool, const std::set<uint256>& pending, bool wtxid) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+{
+    std::vector<uint256> order;
+    for (const CTxMemPoolEntry& entry : pool.entryAll()) {
+        const uint256 hash{wtxid ? entry.GetTx().GetWitnessHash().ToUint256() : entry.GetTx().GetHash().ToUint256()};
+        if (pending.count(hash)) order.push_back(hash);
+    }
+    return order;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(txrelayranking_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(ranking_order)
+{
+    CTxMemPool& pool{*Assert(m_node.mempool)};
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+    std::vector<CTransactionRef> txs;
+    {
+        LOCK2(cs_main, pool.cs);
+        txs = PopulateMempool(det_rand, /*num_transactions=*/200, /*submit=*/true);
+    }
+    BOOST_REQUIRE_EQUAL(pool.size(), txs.size());
+
+    TxRelayRanking::Hashes all_txids, all_wtxids, some_txids, some_wtxids;
+    for (size_t i = 0; i < txs.size(); ++i) {
+        all_txids.insert(txs[i]->GetHash().ToUint256());
+        all_wtxids.insert(txs[i]->GetWitnessHash().ToUint256());
+        if (i % 3 == 0) {
+            some_txids.insert(txs[i]->GetHash().ToUint256());
+            some_wtxids.insert(txs[i]->GetWitnessHash().ToUint256());
+        }
+    }
+    const TxRelayRanking ranking{pool, all_txids, all_wtxids};
+    BOOST_CHECK_EQUAL(ranking.Size(/*wtxid=*/false), txs.size());
+    BOOST_CHECK_EQUAL(ranking.Size(/*wtxid=*/true), txs.size());
+    // Only the given transactions are ranked
+    const TxRelayRanking partial{pool, some_txids, {}};
+    BOOST_CHECK_EQUAL(partial.Size(/*wtxid=*/false), some_txids.size());
+    BOOST_CHECK_EQUAL(partial.Size(/*wtxid=*/true), 0U);
+
+    for (const bool wtxid : {false, true}) {
+        const std::set<uint256> all{wtxid ? std::set<uint256>(all_wtxids.begin(), all_wtxids.end()) : std::set<uint256>(all_txids.begin(), all_txids.end())};
+        const std::set<uint256> some{wtxid ? std::set<uint256>(some_wtxids.begin(), some_wtxids.end()) : std::set<uint256>(some_txids.begin(), some_txids.end())};
+
+        // The whole mempool, and any subset of it, is ranked in the order of entryAll().
+        for (const auto* pending : {&all, &some}) {
+            std::vector<uint256> ranked, unranked;
+            ranking.Order(*pending, wtxid, ranked, unranked);
+            BOOST_CHECK(ranked == WITH_LOCK(pool.cs, return ExpectedOrder(pool, *pending, wtxid)));
+            BOOST_CHECK(unranked.empty());
+        }
+
+        // Transactions the ranking does not know are left unranked.
+        std::vector<uint256> ranked, unranked;
+        partial.Order(all, wtxid, ranked, unranked);
+        BOOST_CHECK(ranked == (wtxid ? std::vector<uint256>{} : WITH_LOCK(pool.cs, return ExpectedOrder(pool, some, wtxid))));
+        BOOST_CHECK_EQUAL(unranked.size(), all.size() - ranked.size());
+        const uint256 unknown{det_rand.rand256()};
+        ranked.clear();
+        unranked.clear();
+        ranking.Order({unknown}, wtxid, ranked, unranked);
+        BOOST_CHECK(ranked.empty());
+        BOOST_CHECK(unranked == std::vector<uint256>{unknown});
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ranking_removal)
+{
+    CTxMemPool& pool{*Assert(m_node.mempool)};
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+    std::vector<CTransactionRef> txs;
+    {
+        LOCK2(cs_main, pool.cs);
+        txs = PopulateMempool(det_rand, /*num_transactions=*/200, /*submit=*/true);
+    }
+    TxRelayRanking::Hashes txids, wtxids;
+    for (const auto& tx : txs) {
+        txids.insert(tx->GetHash().ToUint256());
+        wtxids.insert(tx->GetWitnessHash().ToUint256());
+    }
+    const TxRelayRanking before{pool, txids, wtxids};
+
+    // Remove some transactions, with their descendants, after the ranking was computed.
+    {
+        LOCK(pool.cs);
+        for (size_t i = 0; i < txs.size(); i += 20) {
+            pool.removeRecursive(*txs[i], MemPoolRemovalReason::REPLACED);
+        }
+    }
+    BOOST_REQUIRE_LT(pool.size(), txs.size());
+    const TxRelayRanking after{pool, txids, wtxids};
+    BOOST_CHECK_EQUAL(before.Size(/*wtxid=*/false), txs.size());
+    BOOST_CHECK_EQUAL(after.Size(/*wtxid=*/false), pool.size());
+    BOOST_CHECK_EQUAL(after.Size(/*wtxid=*/true), pool.size());
+
+    for (const bool wtxid : {false, true}) {
+        std::set<uint256> pending, removed;
+        for (const auto& tx : txs) {
+            const uint256 hash{wtxid ? tx->GetWitnessHash().ToUint256() : tx->GetHash().ToUint256()};
+            pending.insert(hash);
+            if (!pool.exists(wtxid ? GenTxid::Wtxid(hash) : GenTxid::Txid(hash))) removed.insert(hash);
+        }
+
+        // Removed transactions keep their position until the ranking is computed again.
+        std::vector<uint256> ranked, unranked;
+        before.Order(pending, wtxid, ranked, unranked);
+        BOOST_CHECK_EQUAL(ranked.size(), txs.size());
+        BOOST_CHECK(unranked.empty());
+        std::erase_if(ranked, [&](const uint256& hash) { return removed.count(hash) > 0; });
+        BOOST_CHECK(ranked == WITH_LOCK(pool.cs, return ExpectedOrder(pool, pending, wtxid)));
+
+        // A ranking computed afterwards does not rank them, and keeps the order of the others.
+        ranked.clear();
+        after.Order(pending, wtxid, ranked, unranked);
+        BOOST_CHECK(ranked == WITH_LOCK(pool.cs, return ExpectedOrder(pool, pending, wtxid)));
+        BOOST_CHECK(std::set<uint256>(unranked.begin(), unranked.end()) == removed);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <addresstype.h>
 #include <consensus/validation.h>
 #include <key_io.h>
 #include <policy/packages.h>
@@ -53,6 +54,73 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_reject_coinbase, TestChain100Setup)
     BOOST_CHECK(result.m_state.GetResult() == TxValidationResult::TX_CONSENSUS);
 }
 
+BOOST_FIXTURE_TEST_CASE(tx_mempool_parallel_script_checks, TestChain100Setup)
+{
+    BOOST_REQUIRE(m_node.chainman->GetCheckQueue().HasThreads());
+
+    // Fan a coinbase out to enough outputs for the spending transaction's
+    // scripts to be verified on the script-checking threads.
+    const CKey key{GenerateRandomKey()};
+    const CScript script{GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey()))};
+    constexpr size_t NUM_INPUTS{2 * MIN_PARALLEL_MEMPOOL_SCRIPT_CHECKS};
+    const auto [fanout, fanout_fee]{CreateValidTransaction({m_coinbase_txns[0]}, {COutPoint{m_coinbase_txns[0]->GetHash(), 0}}, /*input_height=*/1,
+                                                           {coinbaseKey}, std::vector<CTxOut>(NUM_INPUTS, CTxOut{COIN, script}), std::nullopt, std::nullopt)};
+    CreateAndProcessBlock({fanout}, script);
+
+    std::vector<COutPoint> inputs;
+    for (uint32_t i = 0; i < NUM_INPUTS; ++i) inputs.emplace_back(fanout.GetHash(), i);
+    const auto [spend, spend_fee]{CreateValidTransaction({MakeTransactionRef(fanout)}, inputs, /*input_height=*/101,
+                                                         {key}, {CTxOut{NUM_INPUTS * COIN - 10000, script}}, std::nullopt, std::nullopt)};
+
+    // An invalid signature on the last input is detected and reported like
+    // in the sequential checks.
+    CMutableTransaction bad_spend{spend};
+    bad_spend.vin.back().scriptWitness.stack.at(0).at(10) ^= 1;
+
+    LOCK(cs_main);
+    const MempoolAcceptResult bad_result{m_node.chainman->ProcessTransaction(MakeTransactionRef(bad_spend))};
+    BOOST_CHECK(bad_result.m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(bad_result.m_state.GetResult() == TxValidationResult::TX_CONSENSUS);
+    BOOST_CHECK(bad_result.m_state.GetRejectReason().starts_with("mandatory-script-verify-flag-failed"));
+
+    const MempoolAcceptResult result{m_node.chainman->ProcessTransaction(MakeTransactionRef(spend))};
+    BOOST_CHECK(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(m_node.mempool->exists(GenTxid::Txid(spend.GetHash())));
+}
+
+BOOST_FIXTURE_TEST_CASE(tx_mempool_precheck, TestChain100Setup)
+{
+    const CScript script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    // Context-free failures are reported with the reason ProcessTransaction gives
+    TxValidationState precheck_state;
+    BOOST_CHECK(!m_node.chainman->PreCheckTransaction(m_coinbase_txns[0], precheck_state));
+    BOOST_CHECK(precheck_state.GetResult() == TxValidationResult::TX_CONSENSUS);
+    BOOST_CHECK_EQUAL(precheck_state.GetRejectReason(), "coinbase");
+    {
+        LOCK(cs_main);
+        const MempoolAcceptResult result{m_node.chainman->ProcessTransaction(m_coinbase_txns[0])};
+        BOOST_CHECK_EQUAL(result.m_state.GetRejectReason(), precheck_state.GetRejectReason());
+    }
+
+    // Scripts are only verified by ProcessTransaction, after the policy checks
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                  coinbaseKey, script, /*output_amount=*/49 * COIN, /*submit=*/false)};
+    CMutableTransaction bad_spend{spend};
+    bad_spend.vin[0].scriptSig = CScript() << std::vector<unsigned char>(71, 1);
+    precheck_state = TxValidationState{};
+    BOOST_CHECK(m_node.chainman->PreCheckTransaction(MakeTransactionRef(bad_spend), precheck_state));
+    BOOST_CHECK(precheck_state.IsValid());
+
+    precheck_state = TxValidationState{};
+    BOOST_CHECK(m_node.chainman->PreCheckTransaction(MakeTransactionRef(spend), precheck_state));
+    BOOST_CHECK(precheck_state.IsValid());
+
+    LOCK(cs_main);
+    BOOST_CHECK(m_node.chainman->ProcessTransaction(MakeTransactionRef(bad_spend)).m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(m_node.chainman->ProcessTransaction(MakeTransactionRef(spend)).m_result_type == MempoolAcceptResult::ResultType::VALID);
+}
+
 // Generate a number of random, nonexistent outpoints.
 static inline std::vector<COutPoint> random_outpoints(size_t num_outpoints) {
     std::vector<COutPoint> outpoints;
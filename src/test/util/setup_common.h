@@ -56,6 +56,7 @@ struct TestOpts {
     bool setup_net{true};
     bool setup_validation_interface{true};
     bool min_validation_cache{false}; // Equivalent of -maxsigcachebytes=0
+    int script_check_threads{2}; // Number of dedicated script-checking threads
 };
 
 /** Basic testing setup.
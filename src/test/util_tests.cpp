@@ -23,6 +23,7 @@
 #include <util/string.h>
 #include <util/time.h>
 #include <util/vector.h>
+#include <util/vectorset.h>
 
 #include <array>
 #include <cmath>
@@ -30,6 +31,7 @@
 #include <limits>
 #include <map>
 #include <optional>
+#include <set>
 #include <stdint.h>
 #include <string.h>
 #include <thread>
@@ -1966,4 +1968,26 @@ BOOST_AUTO_TEST_CASE(mib_string_literal_test)
     BOOST_CHECK_EXCEPTION(operator""_MiB(static_cast<unsigned long long>(max_mib) + 1), std::overflow_error, HasReason("MiB value too large for size_t byte conversion"));
 }
 
+BOOST_AUTO_TEST_CASE(vectorset_test)
+{
+    // VectorSet behaves like std::set, including iteration order.
+    VectorSet<int, std::greater<int>> vset;
+    std::set<int, std::greater<int>> set;
+    for (int i = 0; i < 1000; ++i) {
+        const int value{static_cast<int>(m_rng.randrange(100))};
+        if (m_rng.randbool()) {
+            BOOST_CHECK_EQUAL(vset.insert(value).second, set.insert(value).second);
+        } else {
+            BOOST_CHECK_EQUAL(vset.erase(value), set.erase(value));
+        }
+        BOOST_CHECK_EQUAL(vset.count(value), set.count(value));
+        BOOST_CHECK_EQUAL(vset.size(), set.size());
+        BOOST_CHECK(std::equal(vset.begin(), vset.end(), set.begin(), set.end()));
+        BOOST_CHECK(vset.capacity() <= std::max<size_t>(2 * vset.size(), 1));
+    }
+    vset.clear();
+    BOOST_CHECK(vset.empty());
+    BOOST_CHECK(vset.find(0) == vset.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
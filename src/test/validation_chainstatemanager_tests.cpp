@@ -18,6 +18,7 @@
 #include <test/util/validation.h>
 #include <uint256.h>
 #include <util/result.h>
+#include <util/threadpool.h>
 #include <util/vector.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -419,6 +420,87 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot, SnapshotTestSetup)
     this->SetupSnapshot();
 }
 
+//! Test that a snapshot whose coins are not in database order still loads,
+//! hashing the loaded chainstate instead of the coins as they are read.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot_unsorted, SnapshotTestSetup)
+{
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+    mineBlocks(10);
+    const fs::path snapshot_path{m_path_root / "test_snapshot.110.dat"};
+
+    {
+        ASSERT_DEBUG_LOG("[snapshot] coins are not in database order");
+        BOOST_REQUIRE(CreateAndActivateUTXOSnapshot(
+            this, [&](AutoFile& auto_infile, SnapshotMetadata& metadata) {
+                // Reverse the order of the transactions, keeping their coins.
+                const int64_t coins_begin{auto_infile.tell()};
+                std::vector<DataStream> txs;
+                for (uint64_t coins_left{metadata.m_coins_count}; coins_left > 0;) {
+                    Txid txid;
+                    auto_infile >> txid;
+                    const uint64_t coins_per_txid{ReadCompactSize(auto_infile)};
+                    DataStream& tx_data{txs.emplace_back()};
+                    tx_data << txid;
+                    WriteCompactSize(tx_data, coins_per_txid);
+                    for (uint64_t i = 0; i < coins_per_txid; ++i) {
+                        WriteCompactSize(tx_data, ReadCompactSize(auto_infile));
+                        Coin coin;
+                        auto_infile >> coin;
+                        tx_data << coin;
+                    }
+                    coins_left -= coins_per_txid;
+                }
+                BOOST_REQUIRE_GT(txs.size(), 1U);
+
+                AutoFile outfile{fsbridge::fopen(snapshot_path, "r+b")};
+                outfile.seek(coins_begin, SEEK_SET);
+                for (auto tx{txs.rbegin()}; tx != txs.rend(); ++tx) {
+                    outfile.write(*tx);
+                }
+                BOOST_REQUIRE_EQUAL(outfile.fclose(), 0);
+                auto_infile.seek(coins_begin, SEEK_SET);
+        }));
+    }
+
+    BOOST_CHECK(chainman.IsSnapshotActive());
+    const auto& au_data = ::Params().AssumeutxoForHeight(110);
+    BOOST_CHECK_EQUAL(WITH_LOCK(chainman.GetMutex(), return chainman.ActiveTip()->m_chain_tx_count), au_data->m_chain_tx_count);
+}
+
+//! Test that writing the snapshot coins in parallel gives the same file.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_snapshot_write_parallel, TestChain100Setup)
+{
+    std::unique_ptr<CCoinsViewSnapshot> snapshot;
+    {
+        LOCK(::cs_main);
+        Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+        chainstate.ForceFlushStateToDisk();
+        snapshot = chainstate.CoinsDB().Snapshot();
+    }
+    BOOST_REQUIRE(snapshot);
+
+    ThreadPool thread_pool{"snapshot"};
+    thread_pool.Start(3);
+
+    std::vector<uint64_t> coins_written;
+    std::vector<std::vector<std::byte>> contents;
+    for (ThreadPool* pool : {static_cast<ThreadPool*>(nullptr), &thread_pool}) {
+        const fs::path path{m_path_root / (pool ? "coins_parallel.dat" : "coins.dat")};
+        {
+            AutoFile file{fsbridge::fopen(path, "wb")};
+            coins_written.push_back(node::WriteSnapshotCoins(file, *snapshot, pool));
+            BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+        }
+
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        contents.emplace_back(fs::file_size(path));
+        file.read(contents.back());
+    }
+    BOOST_CHECK_GE(coins_written[0], 100U);
+    BOOST_CHECK_EQUAL(coins_written[0], coins_written[1]);
+    BOOST_CHECK(contents[0] == contents[1]);
+}
+
 //! Test LoadBlockIndex behavior when multiple chainstates are in use.
 //!
 //! - First, verify that setBlockIndexCandidates is as expected when using a single,
@@ -162,8 +162,8 @@ class CCoinsViewDBCursor: public CCoinsViewCursor
 public:
     // Prefer using CCoinsViewDB::Cursor() since we want to perform some
     // cache warmup on instantiation.
-    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn):
-        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
+    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn, uint32_t prefix_end = CCoinsViewSnapshot::NUM_PREFIXES):
+        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn), m_prefix_end(prefix_end) {}
     ~CCoinsViewDBCursor() = default;
 
     bool GetKey(COutPoint &key) const override;
@@ -175,8 +175,42 @@ public:
 private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    //! Txid prefix at which iteration stops
+    const uint32_t m_prefix_end;
+
+    //! Cache the key at the current iterator position
+    void ReadKey();
 
     friend class CCoinsViewDB;
+    friend class CCoinsViewDBSnapshot;
+};
+
+/** Specialization of CCoinsViewSnapshot for a CCoinsViewDB, backed by a database snapshot */
+class CCoinsViewDBSnapshot : public CCoinsViewSnapshot
+{
+public:
+    CCoinsViewDBSnapshot(std::unique_ptr<CDBSnapshot> snapshot, const uint256& hashBlockIn) :
+        CCoinsViewSnapshot(hashBlockIn), m_snapshot(std::move(snapshot)) {}
+
+    std::unique_ptr<CCoinsViewCursor> Cursor(uint32_t prefix_begin, uint32_t prefix_end) const override
+    {
+        assert(prefix_begin <= prefix_end && prefix_end <= NUM_PREFIXES);
+        auto i = std::make_unique<CCoinsViewDBCursor>(m_snapshot->NewIterator(), GetBestBlock(), prefix_end);
+        if (prefix_begin == prefix_end) {
+            i->keyTmp.first = 0;
+            return i;
+        }
+        uint256 first_txid;
+        first_txid.data()[0] = prefix_begin >> 8;
+        first_txid.data()[1] = prefix_begin & 0xff;
+        const COutPoint first{Txid::FromUint256(first_txid), 0};
+        i->pcursor->Seek(CoinEntry(&first));
+        i->ReadKey();
+        return i;
+    }
+
+private:
+    const std::unique_ptr<CDBSnapshot> m_snapshot;
 };
 
 std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
@@ -188,14 +222,24 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    i->ReadKey();
+    return i;
+}
+
+std::unique_ptr<CCoinsViewSnapshot> CCoinsViewDB::Snapshot() const
+{
+    return std::make_unique<CCoinsViewDBSnapshot>(m_db->NewSnapshot(), GetBestBlock());
+}
+
+void CCoinsViewDBCursor::ReadKey()
+{
+    CoinEntry entry(&keyTmp.second);
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) ||
+        (entry.key == DB_COIN && CCoinsViewSnapshot::Prefix(keyTmp.second) >= m_prefix_end)) {
+        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = entry.key;
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
@@ -221,10 +265,5 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
-    CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
-        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
-    } else {
-        keyTmp.first = entry.key;
-    }
+    ReadKey();
 }
@@ -392,6 +392,7 @@ public:
 
     using txiter = indexed_transaction_set::nth_index<0>::type::const_iterator;
     std::vector<CTransactionRef> txns_randomized GUARDED_BY(cs); //!< All transactions in mapTx, in random order
+    std::vector<Wtxid> wtxids_randomized GUARDED_BY(cs); //!< Witness hashes of txns_randomized, in the same order, so they can be scanned without dereferencing each transaction
 
     typedef std::set<txiter, CompareIteratorByHash> setEntries;
 
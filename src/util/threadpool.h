@@ -0,0 +1,139 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_THREADPOOL_H
+#define BITCOIN_UTIL_THREADPOOL_H
+
+#include <sync.h>
+#include <tinyformat.h>
+#include <util/check.h>
+#include <util/thread.h>
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads executing arbitrary tasks.
+ *
+ * Tasks are submitted with Submit(), which returns a std::future for the
+ * task's result. Tasks are started in submission order, but may complete in
+ * any order; callers that need ordered results should keep the futures in
+ * order and wait on them sequentially.
+ *
+ * Exceptions thrown by a task are captured in its future and rethrown by
+ * std::future::get(), they do not terminate the worker.
+ *
+ * Stop() (also called by the destructor) runs the tasks that are still queued
+ * and joins the workers, so futures obtained from Submit() are always
+ * satisfied.
+ */
+class ThreadPool
+{
+private:
+    const std::string m_name;
+    Mutex m_mutex;
+    std::queue<std::packaged_task<void()>> m_work_queue GUARDED_BY(m_mutex);
+    std::condition_variable m_cv;
+    bool m_interrupt GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers GUARDED_BY(m_mutex);
+
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, wait_lock);
+        while (true) {
+            m_cv.wait(wait_lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_interrupt || !m_work_queue.empty(); });
+            // Drain the queue before exiting, so no future is left unsatisfied.
+            if (m_work_queue.empty()) return;
+
+            auto task = std::move(m_work_queue.front());
+            m_work_queue.pop();
+            REVERSE_LOCK(wait_lock);
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(std::string name) : m_name{std::move(name)} {}
+
+    ~ThreadPool()
+    {
+        Stop();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** Start the given number of worker threads. Must not be called on a running pool. */
+    void Start(int num_workers) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Assume(num_workers > 0);
+        LOCK(m_mutex);
+        if (!m_workers.empty()) throw std::runtime_error("Thread pool already started");
+        m_interrupt = false;
+
+        m_workers.reserve(num_workers);
+        for (int i = 0; i < num_workers; ++i) {
+            m_workers.emplace_back(&util::TraceThread, strprintf("%s.%d", m_name, i), [this] { WorkerThread(); });
+        }
+    }
+
+    /** Finish all queued tasks and join the worker threads. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<std::thread> workers;
+        {
+            LOCK(m_mutex);
+            m_interrupt = true;
+            workers.swap(m_workers);
+        }
+        m_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Enqueue a task for execution on one of the workers.
+     *
+     * @returns a future holding the task's result.
+     * @throws std::runtime_error if the pool has no running workers.
+     */
+    template <class F>
+    [[nodiscard]] auto Submit(F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        using R = std::invoke_result_t<F>;
+        std::packaged_task<R()> task{std::forward<F>(fn)};
+        auto future{task.get_future()};
+        {
+            LOCK(m_mutex);
+            if (m_workers.empty() || m_interrupt) {
+                throw std::runtime_error("No active workers; cannot accept new tasks");
+            }
+            m_work_queue.emplace([task = std::move(task)]() mutable { task(); });
+        }
+        m_cv.notify_one();
+        return future;
+    }
+
+    /** Number of tasks waiting to be picked up by a worker. */
+    size_t WorkQueueSize() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        return WITH_LOCK(m_mutex, return m_work_queue.size());
+    }
+
+    /** Number of running worker threads. */
+    size_t WorkersCount() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        return WITH_LOCK(m_mutex, return m_workers.size());
+    }
+};
+
+#endif // BITCOIN_UTIL_THREADPOOL_H
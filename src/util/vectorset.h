@@ -0,0 +1,66 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_VECTORSET_H
+#define BITCOIN_UTIL_VECTORSET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/** Data structure mimicking std::set, stored as a sorted vector.
+ *
+ * - Elements are kept in a single allocation instead of one tree node each, which makes
+ *   small sets several times smaller than std::set and cheaper to iterate.
+ * - Iteration order is the same as std::set with the same comparator.
+ * - insert() and erase() are O(n), so it is only suited to small sets.
+ * - Insertion and erasure invalidate iterators.
+ */
+template <typename T, typename Compare = std::less<T>>
+class VectorSet
+{
+    std::vector<T> m_data;
+    [[no_unique_address]] Compare m_comp;
+
+public:
+    using value_type = T;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using iterator = const_iterator;
+
+    const_iterator begin() const noexcept { return m_data.begin(); }
+    const_iterator end() const noexcept { return m_data.end(); }
+    size_t size() const noexcept { return m_data.size(); }
+    bool empty() const noexcept { return m_data.empty(); }
+    size_t capacity() const noexcept { return m_data.capacity(); }
+    void clear() noexcept { m_data.clear(); }
+
+    const_iterator find(const T& value) const
+    {
+        const auto it{std::lower_bound(m_data.begin(), m_data.end(), value, m_comp)};
+        return it != m_data.end() && !m_comp(value, *it) ? it : m_data.end();
+    }
+
+    size_t count(const T& value) const { return find(value) != end() ? 1 : 0; }
+
+    std::pair<const_iterator, bool> insert(const T& value)
+    {
+        const auto it{std::lower_bound(m_data.begin(), m_data.end(), value, m_comp)};
+        if (it != m_data.end() && !m_comp(value, *it)) return {it, false};
+        return {m_data.insert(it, value), true};
+    }
+
+    /** Erase value if present, releasing memory once less than half of it is used. Returns the number of elements erased. */
+    size_t erase(const T& value)
+    {
+        const auto it{find(value)};
+        if (it == m_data.end()) return 0;
+        m_data.erase(it);
+        if (m_data.size() * 2 < m_data.capacity()) m_data.shrink_to_fit();
+        return 1;
+    }
+};
+
+#endif // BITCOIN_UTIL_VECTORSET_H
@@ -59,6 +59,7 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
@@ -68,6 +69,7 @@
 #include <cassert>
 #include <chrono>
 #include <deque>
+#include <future>
 #include <numeric>
 #include <optional>
 #include <ranges>
@@ -432,6 +434,29 @@ static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, TxValidationS
     return CheckInputScripts(tx, state, view, flags, /* cacheSigStore= */ true, /* cacheFullScriptStore= */ true, txdata, validation_cache);
 }
 
+/**
+ * The first checks of mempool acceptance, which depend neither on the chain
+ * nor on the mempool contents and so can be run without holding any lock.
+ */
+static bool ContextFreeMempoolChecks(const CTransaction& tx, const CTxMemPool::Options& opts, TxValidationState& state)
+{
+    if (!CheckTransaction(tx, state)) {
+        return false; // state filled in by CheckTransaction
+    }
+
+    // Coinbase is only valid in a block, not as a loose transaction
+    if (tx.IsCoinBase())
+        return state.Invalid(TxValidationResult::TX_CONSENSUS, "coinbase");
+
+    // Rather not work on nonstandard transactions (unless -testnet/-regtest)
+    std::string reason;
+    if (opts.require_standard && !IsStandardTx(tx, opts.max_datacarrier_bytes, opts.permit_bare_multisig, opts.dust_relay_feerate, reason)) {
+        return state.Invalid(TxValidationResult::TX_NOT_STANDARD, reason);
+    }
+
+    return true;
+}
+
 namespace {
 
 class MemPoolAccept
@@ -780,18 +805,8 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     // Alias what we need out of ws
     TxValidationState& state = ws.m_state;
 
-    if (!CheckTransaction(tx, state)) {
-        return false; // state filled in by CheckTransaction
-    }
-
-    // Coinbase is only valid in a block, not as a loose transaction
-    if (tx.IsCoinBase())
-        return state.Invalid(TxValidationResult::TX_CONSENSUS, "coinbase");
-
-    // Rather not work on nonstandard transactions (unless -testnet/-regtest)
-    std::string reason;
-    if (m_pool.m_opts.require_standard && !IsStandardTx(tx, m_pool.m_opts.max_datacarrier_bytes, m_pool.m_opts.permit_bare_multisig, m_pool.m_opts.dust_relay_feerate, reason)) {
-        return state.Invalid(TxValidationResult::TX_NOT_STANDARD, reason);
+    if (!ContextFreeMempoolChecks(tx, m_pool.m_opts, state)) {
+        return false; // state filled in by ContextFreeMempoolChecks
     }
 
     // Only accept nLockTime-using transactions that can be mined in the next
@@ -1231,6 +1246,19 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
 
     // Check input scripts and signatures.
     // This is done last to help prevent CPU exhaustion denial-of-service attacks.
+    CCheckQueue<CScriptCheck>& check_queue{m_active_chainstate.m_chainman.GetCheckQueue()};
+    if (check_queue.HasThreads() && tx.vin.size() >= MIN_PARALLEL_MEMPOOL_SCRIPT_CHECKS) {
+        // Verify the inputs on the script-checking threads, which are idle
+        // while cs_main is held here. If any input fails, fall through to the
+        // sequential checks below, which determine the reject reason; the
+        // inputs verified so far are found in the signature cache.
+        std::vector<CScriptCheck> checks;
+        if (CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache(), &checks)) {
+            CCheckQueueControl<CScriptCheck> control(&check_queue);
+            control.Add(std::move(checks));
+            if (!control.Complete().has_value()) return true;
+        }
+    }
     if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache())) {
         // SCRIPT_VERIFY_CLEANSTACK requires SCRIPT_VERIFY_WITNESS, so we
         // need to turn both off, and compare against just turning off CLEANSTACK
@@ -1402,7 +1430,7 @@ bool MemPoolAccept::SubmitPackage(const ATMPArgs& args, std::vector<Workspace>&
                                                        ws.m_vsize, (*iter)->GetHeight(),
                                                        args.m_bypass_limits, args.m_package_submission,
                                                        IsCurrentForFeeEstimation(m_active_chainstate),
-                                                       m_pool.HasNoInputsOf(tx));
+                                                       m_pool.HasNoInputsOf(tx), (*iter)->GetTime());
         m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, m_pool.GetAndIncrementSequence());
     }
     return all_submitted;
@@ -1481,7 +1509,7 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransaction(const CTransactionRef
                                                        ws.m_vsize, (*iter)->GetHeight(),
                                                        args.m_bypass_limits, args.m_package_submission,
                                                        IsCurrentForFeeEstimation(m_active_chainstate),
-                                                       m_pool.HasNoInputsOf(tx));
+                                                       m_pool.HasNoInputsOf(tx), (*iter)->GetTime());
         m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, m_pool.GetAndIncrementSequence());
     }
 
@@ -4648,6 +4676,14 @@ MempoolAcceptResult ChainstateManager::ProcessTransaction(const CTransactionRef&
     return result;
 }
 
+bool ChainstateManager::PreCheckTransaction(const CTransactionRef& ptx, TxValidationState& state)
+{
+    AssertLockNotHeld(cs_main);
+    const CTxMemPool* pool{ActiveChainstate().GetMempool()};
+    if (!pool) return true; // ProcessTransaction reports the missing mempool
+    return ContextFreeMempoolChecks(*ptx, pool->m_opts, state);
+}
+
 bool TestBlockValidity(BlockValidationState& state,
                        const CChainParams& chainparams,
                        Chainstate& chainstate,
@@ -5871,6 +5907,9 @@ static void FlushSnapshotToDisk(CCoinsViewCache& coins_cache, bool snapshot_load
     coins_cache.Flush();
 }
 
+//! Number of coins handed to the hashing thread at once while loading a snapshot
+static constexpr size_t SNAPSHOT_HASH_BATCH_SIZE{50000};
+
 struct StopHashingException : public std::exception
 {
     const char* what() const noexcept override
@@ -5927,6 +5966,43 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_left, base_blockhash.ToString());
     int64_t coins_processed{0};
 
+    // Snapshots written by dumptxoutset contain the coins in the order of the
+    // coins database, which is also the order in which they are hashed. In
+    // that case the hash of the UTXO set is computed on a separate thread
+    // while loading, rather than by reading back the whole chainstate
+    // afterwards. Batches of coins are handed to the hashing thread, and
+    // moved into the coins cache once hashed, while the next batch is read.
+    HashWriter hash_writer{};
+    bool hash_while_loading{true};
+    std::optional<Txid> last_txid;
+    std::vector<std::pair<COutPoint, Coin>> batch;
+    std::future<std::vector<std::pair<COutPoint, Coin>>> hashed_batch;
+    // Declared after hash_writer, so that the hashing task is done with it
+    // before it is destroyed on early returns.
+    ThreadPool hash_thread{"snapshothash"};
+    hash_thread.Start(1);
+
+    const auto emplace_coins{[&](std::vector<std::pair<COutPoint, Coin>>&& coins) {
+        for (auto& [outpoint, coin] : coins) {
+            coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
+        }
+    }};
+    const auto submit_batch{[&] {
+        auto previous_batch{std::move(hashed_batch)};
+        if (hash_while_loading) {
+            hashed_batch = hash_thread.Submit([&hash_writer, coins = std::move(batch)]() mutable {
+                for (const auto& [outpoint, coin] : coins) {
+                    kernel::ApplyCoinHash(hash_writer, outpoint, coin);
+                }
+                return std::move(coins);
+            });
+        } else {
+            emplace_coins(std::move(batch));
+        }
+        batch.clear();
+        if (previous_batch.valid()) emplace_coins(previous_batch.get());
+    }};
+
     while (coins_left > 0) {
         try {
             Txid txid;
@@ -5938,6 +6014,10 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
                 return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
             }
 
+            if (last_txid && !(*last_txid < txid)) hash_while_loading = false;
+            last_txid = txid;
+            const size_t txid_begin{batch.size()};
+
             for (size_t i = 0; i < coins_per_txid; i++) {
                 COutPoint outpoint;
                 Coin coin;
@@ -5954,7 +6034,7 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
                     return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value",
                               coins_count - coins_left))};
                 }
-                coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
+                batch.emplace_back(std::move(outpoint), std::move(coin));
 
                 --coins_left;
                 ++coins_processed;
@@ -5989,11 +6069,22 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
                     }
                 }
             }
+
+            // The outputs of a transaction are hashed in the order of their
+            // index, which differs from the database order for large indexes.
+            const auto txid_coins{batch.begin() + txid_begin};
+            std::sort(txid_coins, batch.end(), [](const auto& a, const auto& b) { return a.first.n < b.first.n; });
+            if (std::adjacent_find(txid_coins, batch.end(), [](const auto& a, const auto& b) { return a.first.n == b.first.n; }) != batch.end()) {
+                hash_while_loading = false;
+            }
+            if (batch.size() >= SNAPSHOT_HASH_BATCH_SIZE) submit_batch();
         } catch (const std::ios_base::failure&) {
             return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
                       coins_processed))};
         }
     }
+    submit_batch();
+    if (hashed_batch.valid()) emplace_coins(hashed_batch.get());
 
     // Important that we set this. This and the coins_cache accesses above are
     // sort of a layer violation, but either we reach into the innards of
@@ -6029,22 +6120,29 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     // about the snapshot_chainstate.
     CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
 
-    std::optional<CCoinsStats> maybe_stats;
+    uint256 hash_serialized;
+    if (hash_while_loading) {
+        hash_serialized = hash_writer.GetHash();
+    } else {
+        LogPrintf("[snapshot] coins are not in database order, hashing the loaded chainstate\n");
+        std::optional<CCoinsStats> maybe_stats;
 
-    try {
-        maybe_stats = ComputeUTXOStats(
-            CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
-    } catch (StopHashingException const&) {
-        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-    }
-    if (!maybe_stats.has_value()) {
-        return util::Error{Untranslated("Failed to generate coins stats")};
+        try {
+            maybe_stats = ComputeUTXOStats(
+                CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
+        } catch (StopHashingException const&) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
+        if (!maybe_stats.has_value()) {
+            return util::Error{Untranslated("Failed to generate coins stats")};
+        }
+        hash_serialized = maybe_stats->hashSerialized;
     }
 
     // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
+    if (AssumeutxoHash{hash_serialized} != au_data.hash_serialized) {
         return util::Error{Untranslated(strprintf("Bad snapshot content hash: expected %s, got %s",
-            au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString()))};
+            au_data.hash_serialized.ToString(), hash_serialized.ToString()))};
     }
 
     snapshot_chainstate.m_chain.SetTip(*snapshot_start_block);
@@ -80,6 +80,8 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
+/** Minimum number of inputs of a transaction for its mempool script checks to use the script-checking threads */
+static constexpr size_t MIN_PARALLEL_MEMPOOL_SCRIPT_CHECKS{8};
 
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
@@ -1253,6 +1255,21 @@ public:
     [[nodiscard]] MempoolAcceptResult ProcessTransaction(const CTransactionRef& tx, bool test_accept=false)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Run the context-free transaction and standardness checks of mempool
+     * acceptance without cs_main, before calling ProcessTransaction. Scripts
+     * are not verified here: ProcessTransaction verifies them only once the
+     * fee, replacement and package limit checks have passed.
+     *
+     * @param[in]   tx     The transaction about to be submitted.
+     * @param[out]  state  Set if the transaction fails a context-free check.
+     * @returns false if ProcessTransaction is certain to reject the transaction
+     *          with the reason in state, unless it has to be rejected for not
+     *          having a mempool.
+     */
+    bool PreCheckTransaction(const CTransactionRef& tx, TxValidationState& state)
+        LOCKS_EXCLUDED(cs_main);
+
     //! Load the block tree and coins database from disk, initializing state if we're running with -reindex
     bool LoadBlockIndex() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -13,6 +13,7 @@
 #include <script/signingprovider.h>
 
 #include <algorithm>
+#include <chrono>
 #include <map>
 #include <optional>
 #include <set>
@@ -117,6 +118,8 @@ public:
     std::optional<uint32_t> m_version;
     //! Caps weight of resulting tx
     std::optional<int> m_max_tx_weight{std::nullopt};
+    //! Time budget for the BnB and CoinGrinder searches of each selection attempt, unlimited if unset
+    std::optional<std::chrono::milliseconds> m_max_search_time{std::nullopt};
 
     CCoinControl();
 
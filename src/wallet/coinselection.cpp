@@ -89,9 +89,11 @@ struct {
  */
 
 static const size_t TOTAL_TRIES = 100000;
+//! Number of tries between checks whether a search was interrupted
+static const size_t INTERRUPT_CHECK_INTERVAL = 1000;
 
 util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, const CAmount& cost_of_change,
-                                             int max_selection_weight)
+                                             int max_selection_weight, CoinSelectionInterrupt* interrupt)
 {
     SelectionResult result(selection_target, SelectionAlgorithm::BNB);
     CAmount curr_value = 0;
@@ -122,6 +124,8 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
 
     // Depth First search loop for choosing the UTXOs
     for (size_t curr_try = 0, utxo_pool_index = 0; curr_try < TOTAL_TRIES; ++curr_try, ++utxo_pool_index) {
+        if (interrupt && curr_try % INTERRUPT_CHECK_INTERVAL == 0 && interrupt->Interrupted()) break;
+
         // Conditions for starting a backtrack
         bool backtrack = false;
         if (curr_value + curr_available_value < selection_target || // Cannot possibly reach target with the amount remaining in the curr_available_value.
@@ -322,7 +326,8 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
  * @param int max_selection_weight The maximum allowed weight for a selection result to be valid.
  * @returns The result of this coin selection algorithm, or std::nullopt
  */
-util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight)
+util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight,
+                                          CoinSelectionInterrupt* interrupt)
 {
     std::sort(utxo_pool.begin(), utxo_pool.end(), descending_effval_weight);
     // The sum of UTXO amounts after this UTXO index, e.g. lookahead[5] = Σ(UTXO[6+].amount)
@@ -463,8 +468,8 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
             }
         }
 
-        if (curr_try >= TOTAL_TRIES) {
-            // Solution is not guaranteed to be optimal if `curr_try` hit TOTAL_TRIES
+        if (curr_try >= TOTAL_TRIES || (interrupt && curr_try % INTERRUPT_CHECK_INTERVAL == 0 && interrupt->Interrupted())) {
+            // Solution is not guaranteed to be optimal if `curr_try` hit TOTAL_TRIES or the search was interrupted
             result.SetAlgoCompleted(false);
             break;
         }
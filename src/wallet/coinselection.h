@@ -14,7 +14,10 @@
 #include <util/check.h>
 #include <util/insert.h>
 #include <util/result.h>
+#include <util/time.h>
 
+#include <atomic>
+#include <chrono>
 #include <optional>
 
 
@@ -176,6 +179,9 @@ struct CoinSelectionParams {
     bool m_include_unsafe_inputs = false;
     /** The maximum weight for this transaction. */
     std::optional<int> m_max_tx_weight{std::nullopt};
+    /** Time budget for the searches of one selection attempt, after which they return the best
+     * solution found so far. When unset, the searches are only limited by their number of tries. */
+    std::optional<std::chrono::milliseconds> m_max_search_time{std::nullopt};
 
     CoinSelectionParams(FastRandomContext& rng_fast, int change_output_size, int change_spend_size,
                         CAmount min_change_target, CFeeRate effective_feerate,
@@ -443,10 +449,36 @@ public:
     int GetWeight() const { return m_weight; }
 };
 
+/** Shared cancellation of the coin selection searches that run for one selection attempt.
+ *
+ * The searches stop once Interrupt() was called or the time budget is spent, and then behave as if
+ * they had reached their limit of tries. Safe to use from several threads at once.
+ */
+class CoinSelectionInterrupt
+{
+    std::atomic<bool> m_interrupted{false};
+    const std::optional<SteadyClock::time_point> m_deadline;
+
+public:
+    explicit CoinSelectionInterrupt(std::optional<std::chrono::milliseconds> time_budget = std::nullopt)
+        : m_deadline{time_budget ? std::optional{SteadyClock::now() + *time_budget} : std::nullopt} {}
+
+    void Interrupt() { m_interrupted.store(true, std::memory_order_relaxed); }
+
+    //! Return whether the searches should stop. Interrupts all of them once the deadline passed.
+    bool Interrupted()
+    {
+        if (m_interrupted.load(std::memory_order_relaxed)) return true;
+        if (m_deadline && SteadyClock::now() >= *m_deadline) Interrupt();
+        return m_interrupted.load(std::memory_order_relaxed);
+    }
+};
+
 util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, const CAmount& cost_of_change,
-                                             int max_selection_weight);
+                                             int max_selection_weight, CoinSelectionInterrupt* interrupt = nullptr);
 
-util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight);
+util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight,
+                                          CoinSelectionInterrupt* interrupt = nullptr);
 
 /** Select coins by Single Random Draw. OutputGroups are selected randomly from the eligible
  * outputs until the target is satisfied
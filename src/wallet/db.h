@@ -12,6 +12,7 @@
 #include <util/fs.h>
 
 #include <atomic>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -179,6 +180,53 @@ public:
 
     /** Make a DatabaseBatch connected to this database */
     virtual std::unique_ptr<DatabaseBatch> MakeBatch(bool flush_on_close = true) = 0;
+
+    /**
+     * Group the writes of batches that did not begin their own transaction into shared
+     * transactions, committed every max_records writes and by the matching EndGroupCommit().
+     * Calls may be nested. Backends that do not commit each write on its own ignore this.
+     * EndGroupCommit() returns false if grouped writes could not be committed since the
+     * outermost BeginGroupCommit(), in which case they were rolled back.
+     *
+     * The group covers every batch writing to this database while it is active, not only
+     * the caller's. Autocommit writes made by unrelated batches in the meantime, such as
+     * label or address book writes from RPCs during a rescan, join the shared transaction.
+     * Their Write() returns true once the row is written, but a later failed group commit
+     * rolls them back as well, and only the caller of EndGroupCommit() learns about it.
+     */
+    virtual void BeginGroupCommit(size_t max_records) {}
+    virtual bool EndGroupCommit() { return true; }
+};
+
+/** Number of writes grouped into one transaction during block connection and rescans */
+static constexpr size_t DEFAULT_GROUP_COMMIT_RECORDS{1000};
+
+/** RAII helper that groups the writes to a database while it is in scope. See WalletDatabase::BeginGroupCommit(). */
+class DatabaseGroupCommit
+{
+    WalletDatabase& m_database;
+    bool m_active{true};
+
+public:
+    explicit DatabaseGroupCommit(WalletDatabase& database, size_t max_records = DEFAULT_GROUP_COMMIT_RECORDS)
+        : m_database{database}
+    {
+        m_database.BeginGroupCommit(max_records);
+    }
+    ~DatabaseGroupCommit()
+    {
+        if (m_active) m_database.EndGroupCommit();
+    }
+
+    /** End the group now. Returns false if the grouped writes were lost, see WalletDatabase::EndGroupCommit(). */
+    [[nodiscard]] bool Commit()
+    {
+        m_active = false;
+        return m_database.EndGroupCommit();
+    }
+
+    DatabaseGroupCommit(const DatabaseGroupCommit&) = delete;
+    DatabaseGroupCommit& operator=(const DatabaseGroupCommit&) = delete;
 };
 
 enum class DatabaseFormat {
@@ -198,6 +246,7 @@ struct DatabaseOptions {
     // Specialized options. Not every option is supported by every backend.
     bool verify = true;             //!< Check data integrity on load.
     bool use_unsafe_sync = false;   //!< Disable file sync for faster performance.
+    bool use_sqlite_wal = false;    //!< Use SQLite write-ahead logging instead of a rollback journal.
     bool use_shared_memory = false; //!< Let other processes access the database.
     int64_t max_log_mb = 100;       //!< Max log size to allow before consolidating.
 };
@@ -550,6 +550,10 @@ public:
         return MakeSignalHandler(m_wallet->NotifyTransactionChanged.connect(
             [fn](const uint256& txid, ChangeType status) { fn(txid, status); }));
     }
+    std::unique_ptr<Handler> handleTransactionsChanged(TransactionsChangedFn fn) override
+    {
+        return MakeSignalHandler(m_wallet->NotifyTransactionsChanged.connect(fn));
+    }
     std::unique_ptr<Handler> handleWatchOnlyChanged(WatchOnlyChangedFn fn) override
     {
         return MakeSignalHandler(m_wallet->NotifyWatchonlyChanged.connect(fn));
@@ -293,27 +293,42 @@ bool CachedTxIsTrusted(const CWallet& wallet, const CWalletTx& wtx)
 Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse)
 {
     Balance ret;
-    isminefilter reuse_filter = avoid_reuse ? ISMINE_NO : ISMINE_USED;
     {
         LOCK(wallet.cs_wallet);
+        const bool allow_used_addresses{!avoid_reuse || !wallet.IsWalletFlagSet(WALLET_FLAG_AVOID_REUSE)};
         std::set<uint256> trusted_parents;
-        for (const auto& entry : wallet.mapWallet)
-        {
-            const CWalletTx& wtx = entry.second;
+        // Only transactions with unspent outputs can contribute to the balance
+        for (const auto& [txid, outputs] : wallet.GetUnspentTXOs()) {
+            const CWalletTx& wtx{wallet.mapWallet.at(txid)};
             const bool is_trusted{CachedTxIsTrusted(wallet, wtx, trusted_parents)};
             const int tx_depth{wallet.GetTxDepthInMainChain(wtx)};
-            const CAmount tx_credit_mine{CachedTxGetAvailableCredit(wallet, wtx, ISMINE_SPENDABLE | reuse_filter)};
-            const CAmount tx_credit_watchonly{CachedTxGetAvailableCredit(wallet, wtx, ISMINE_WATCH_ONLY | reuse_filter)};
-            if (is_trusted && tx_depth >= min_depth) {
-                ret.m_mine_trusted += tx_credit_mine;
-                ret.m_watchonly_trusted += tx_credit_watchonly;
-            }
-            if (!is_trusted && tx_depth == 0 && wtx.InMempool()) {
-                ret.m_mine_untrusted_pending += tx_credit_mine;
-                ret.m_watchonly_untrusted_pending += tx_credit_watchonly;
+            const bool is_immature{wallet.IsTxImmatureCoinBase(wtx)};
+            const bool is_available_trusted{!is_immature && is_trusted && tx_depth >= min_depth};
+            const bool is_available_pending{!is_immature && !is_trusted && tx_depth == 0 && wtx.InMempool()};
+            for (const uint32_t n : outputs) {
+                const CTxOut& txout{wtx.tx->vout[n]};
+                if (!MoneyRange(txout.nValue)) throw std::runtime_error(std::string(__func__) + ": value out of range");
+                if (wallet.IsSpent(COutPoint{wtx.GetHash(), n})) continue;
+                const isminetype mine{wallet.IsMine(txout)};
+                const CAmount credit_mine{(mine & ISMINE_SPENDABLE) ? txout.nValue : 0};
+                const CAmount credit_watchonly{(mine & ISMINE_WATCH_ONLY) ? txout.nValue : 0};
+                if (is_immature) {
+                    if (wtx.isConfirmed()) {
+                        ret.m_mine_immature += credit_mine;
+                        ret.m_watchonly_immature += credit_watchonly;
+                    }
+                    continue;
+                }
+                if (!is_available_trusted && !is_available_pending) continue;
+                if (!allow_used_addresses && wallet.IsSpentKey(txout.scriptPubKey)) continue;
+                if (is_available_trusted) {
+                    ret.m_mine_trusted += credit_mine;
+                    ret.m_watchonly_trusted += credit_watchonly;
+                } else {
+                    ret.m_mine_untrusted_pending += credit_mine;
+                    ret.m_watchonly_untrusted_pending += credit_watchonly;
+                }
             }
-            ret.m_mine_immature += CachedTxGetImmatureCredit(wallet, wtx, ISMINE_SPENDABLE);
-            ret.m_watchonly_immature += CachedTxGetImmatureCredit(wallet, wtx, ISMINE_WATCH_ONLY);
         }
     }
     return ret;
@@ -0,0 +1,100 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WALLET_SCRIPTFILTER_H
+#define BITCOIN_WALLET_SCRIPTFILTER_H
+
+#include <crypto/common.h>
+#include <random.h>
+#include <script/script.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wallet {
+/** Approximate set of scriptPubKeys, used to quickly reject scripts that are not in the wallet.
+ *
+ * This is a blocked bloom filter: every script sets 4 bits in a single 64-bit block selected by a
+ * salted 64-bit fingerprint of the script, so a lookup touches one word of memory and never hashes
+ * the script with SipHash. MayContain() has no false negatives; at full capacity about 0.5% of the
+ * scripts that were never inserted are false positives.
+ *
+ * The fingerprint is not collision resistant. Someone who crafts scripts that pass the filter only
+ * makes the caller fall through to its exact lookup, which it would have done without the filter.
+ *
+ * Scripts cannot be removed. Once more scripts than Capacity() have been inserted the false positive
+ * rate rises, so the owner is expected to Reset() to a larger size and insert all scripts again.
+ */
+class ScriptPubKeyFilter
+{
+    //! Number of scripts per 64-bit block at capacity (16 bits per script)
+    static constexpr size_t SCRIPTS_PER_BLOCK{4};
+
+    const uint64_t m_salt;
+    std::vector<uint64_t> m_blocks;
+
+    uint64_t Fingerprint(const CScript& script) const
+    {
+        const unsigned char* data{script.data()};
+        size_t size{script.size()};
+        uint64_t h{m_salt ^ (size * 0x9e3779b97f4a7c15ULL)};
+        for (; size >= 8; data += 8, size -= 8) {
+            h = std::rotl((h ^ ReadLE64(data)) * 0x87c37b91114253d5ULL, 31);
+        }
+        uint64_t tail{0};
+        for (size_t i = 0; i < size; ++i) tail |= uint64_t{data[i]} << (8 * i);
+        h ^= tail;
+        // Finalizer of splitmix64, so that every bit of the fingerprint depends on every input bit
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    uint64_t& Block(uint64_t fingerprint) { return m_blocks[((fingerprint >> 32) * m_blocks.size()) >> 32]; }
+    uint64_t Block(uint64_t fingerprint) const { return m_blocks[((fingerprint >> 32) * m_blocks.size()) >> 32]; }
+
+    static uint64_t Mask(uint64_t fingerprint)
+    {
+        return (uint64_t{1} << (fingerprint & 63)) | (uint64_t{1} << ((fingerprint >> 6) & 63)) |
+               (uint64_t{1} << ((fingerprint >> 12) & 63)) | (uint64_t{1} << ((fingerprint >> 18) & 63));
+    }
+
+public:
+    ScriptPubKeyFilter() : m_salt{FastRandomContext().rand64()} {}
+
+    //! Remove all scripts and size the filter for num_scripts scripts.
+    void Reset(size_t num_scripts)
+    {
+        const size_t num_blocks{std::max<size_t>(1, (num_scripts + SCRIPTS_PER_BLOCK - 1) / SCRIPTS_PER_BLOCK)};
+        // The block index is computed from 32 bits of the fingerprint
+        Assume(num_blocks <= UINT32_MAX);
+        m_blocks.assign(num_blocks, 0);
+    }
+
+    //! Number of scripts the filter is sized for.
+    size_t Capacity() const { return m_blocks.empty() ? 0 : m_blocks.size() * SCRIPTS_PER_BLOCK; }
+
+    void Insert(const CScript& script)
+    {
+        if (m_blocks.empty()) Reset(1);
+        const uint64_t fingerprint{Fingerprint(script)};
+        Block(fingerprint) |= Mask(fingerprint);
+    }
+
+    //! Return false if the script was never inserted. May return true for scripts that were not inserted.
+    bool MayContain(const CScript& script) const
+    {
+        if (m_blocks.empty()) return false;
+        const uint64_t fingerprint{Fingerprint(script)};
+        const uint64_t mask{Mask(fingerprint)};
+        return (Block(fingerprint) & mask) == mask;
+    }
+};
+} // namespace wallet
+
+#endif // BITCOIN_WALLET_SCRIPTFILTER_H
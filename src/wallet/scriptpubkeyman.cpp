@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <common/system.h>
 #include <hash.h>
 #include <key_io.h>
 #include <logging.h>
@@ -15,10 +16,14 @@
 #include <util/check.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/scriptpubkeyman.h>
 
+#include <algorithm>
+#include <exception>
+#include <future>
 #include <optional>
 
 using common::PSBTError;
@@ -27,6 +32,12 @@ using util::ToString;
 namespace wallet {
 //! Value for the first BIP 32 hardened derivation. Can be used as a bit mask and as a value. See BIP 32 for more details.
 const uint32_t BIP32_HARDENED_KEY_LIMIT = 0x80000000;
+//! Number of descriptor range indexes expanded per thread pool task when loading a descriptor cache.
+static constexpr int32_t DESCRIPTOR_EXPAND_CHUNK_SIZE{250};
+//! Minimum number of inputs to sign for FillPSBT to create the signatures on a thread pool.
+static constexpr size_t PARALLEL_PSBT_SIGN_MIN_INPUTS{64};
+//! Maximum number of threads FillPSBT creates signatures on.
+static constexpr int MAX_PSBT_SIGN_WORKERS{8};
 
 util::Result<CTxDestination> LegacyScriptPubKeyMan::GetNewDestination(const OutputType type)
 {
@@ -2570,6 +2581,32 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
     if (n_signed) {
         *n_signed = 0;
     }
+    // The signing providers of the inputs are collected first, then all inputs are signed in one batch,
+    // which is spread over a thread pool for large transactions.
+    std::vector<std::unique_ptr<FlatSigningProvider>> input_keys;
+    std::vector<HidingSigningProvider> input_providers;
+    std::vector<int> input_indices;
+    const auto sign_inputs{[&] {
+        std::vector<std::pair<int, const SigningProvider*>> inputs;
+        inputs.reserve(input_indices.size());
+        for (size_t j = 0; j < input_indices.size(); ++j) {
+            inputs.emplace_back(input_indices[j], &input_providers[j]);
+        }
+        ThreadPool thread_pool{"psbtsign"};
+        const bool parallel{sign && inputs.size() >= PARALLEL_PSBT_SIGN_MIN_INPUTS};
+        if (parallel) thread_pool.Start(std::clamp(GetNumCores(), 1, MAX_PSBT_SIGN_WORKERS));
+        SignPSBTInputs(inputs, psbtx, txdata, sighash_type, finalize, parallel ? &thread_pool : nullptr);
+
+        for (const int i : input_indices) {
+            bool signed_one = PSBTInputSigned(psbtx.inputs[i]);
+            if (n_signed && (signed_one || !sign)) {
+                // If sign is false, we assume that we _could_ sign if we get here. This
+                // will never have false negatives; it is hard to tell under what i
+                // circumstances it could have false positives.
+                (*n_signed)++;
+            }
+        }
+    }};
     for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
         const CTxIn& txin = psbtx.tx->vin[i];
         PSBTInput& input = psbtx.inputs.at(i);
@@ -2580,6 +2617,7 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
 
         // Get the Sighash type
         if (sign && input.sighash_type != std::nullopt && *input.sighash_type != sighash_type) {
+            sign_inputs();
             return PSBTError::SIGHASH_MISMATCH;
         }
 
@@ -2589,6 +2627,7 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
             script = input.witness_utxo.scriptPubKey;
         } else if (input.non_witness_utxo) {
             if (txin.prevout.n >= input.non_witness_utxo->vout.size()) {
+                sign_inputs();
                 return PSBTError::MISSING_INPUTS;
             }
             script = input.non_witness_utxo->vout[txin.prevout.n].scriptPubKey;
@@ -2640,16 +2679,11 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
             }
         }
 
-        SignPSBTInput(HidingSigningProvider(keys.get(), /*hide_secret=*/!sign, /*hide_origin=*/!bip32derivs), psbtx, i, &txdata, sighash_type, nullptr, finalize);
-
-        bool signed_one = PSBTInputSigned(input);
-        if (n_signed && (signed_one || !sign)) {
-            // If sign is false, we assume that we _could_ sign if we get here. This
-            // will never have false negatives; it is hard to tell under what i
-            // circumstances it could have false positives.
-            (*n_signed)++;
-        }
+        input_providers.emplace_back(keys.get(), /*hide_secret=*/!sign, /*hide_origin=*/!bip32derivs);
+        input_keys.push_back(std::move(keys));
+        input_indices.push_back(i);
     }
+    sign_inputs();
 
     // Fill in the bip32 keypaths and redeemscripts for the outputs so that hardware wallets can identify change
     for (unsigned int i = 0; i < psbtx.tx->vout.size(); ++i) {
@@ -2687,35 +2721,77 @@ uint256 DescriptorScriptPubKeyMan::GetID() const
     return m_wallet_descriptor.id;
 }
 
-void DescriptorScriptPubKeyMan::SetCache(const DescriptorCache& cache)
+void DescriptorScriptPubKeyMan::SetCache(const DescriptorCache& cache, ThreadPool* thread_pool)
 {
     LOCK(cs_desc_man);
     std::set<CScript> new_spks;
     m_wallet_descriptor.cache = cache;
-    for (int32_t i = m_wallet_descriptor.range_start; i < m_wallet_descriptor.range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            throw std::runtime_error("Error: Unable to expand wallet descriptor from cache");
+
+    // Expanding from the cache derives the keys of every index of the range, which
+    // is done in chunks on the thread pool if there is one. The results are merged
+    // below in index order, exactly as if the range had been expanded sequentially.
+    using Expansion = std::pair<std::vector<CScript>, FlatSigningProvider>;
+    const Descriptor& descriptor{*m_wallet_descriptor.descriptor};
+    const DescriptorCache& desc_cache{m_wallet_descriptor.cache};
+    const auto expand_range{[&descriptor, &desc_cache](int32_t begin, int32_t end) {
+        std::vector<Expansion> expansions(end - begin);
+        for (int32_t i = begin; i < end; ++i) {
+            auto& [scripts, out_keys] = expansions[i - begin];
+            if (!descriptor.ExpandFromCache(i, desc_cache, scripts, out_keys)) {
+                throw std::runtime_error("Error: Unable to expand wallet descriptor from cache");
+            }
         }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        new_spks.insert(scripts_temp.begin(), scripts_temp.end());
-        for (const CScript& script : scripts_temp) {
-            if (m_map_script_pub_keys.count(script) != 0) {
-                throw std::runtime_error(strprintf("Error: Already loaded script at index %d as being at index %d", i, m_map_script_pub_keys[script]));
+        return expansions;
+    }};
+    const int32_t range_start{m_wallet_descriptor.range_start};
+    const int32_t range_end{std::max(m_wallet_descriptor.range_start, m_wallet_descriptor.range_end)};
+    std::vector<std::future<std::vector<Expansion>>> chunks;
+    if (thread_pool && range_end - range_start > DESCRIPTOR_EXPAND_CHUNK_SIZE) {
+        for (int32_t begin = range_start; begin < range_end; begin += DESCRIPTOR_EXPAND_CHUNK_SIZE) {
+            const int32_t end{std::min(range_end, begin + DESCRIPTOR_EXPAND_CHUNK_SIZE)};
+            chunks.push_back(thread_pool->Submit([&expand_range, begin, end] { return expand_range(begin, end); }));
+        }
+    }
+
+    int32_t i{range_start};
+    const auto merge_expansions{[&](std::vector<Expansion>&& expansions) EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man) {
+        for (auto& [scripts_temp, out_keys] : expansions) {
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            new_spks.insert(scripts_temp.begin(), scripts_temp.end());
+            for (const CScript& script : scripts_temp) {
+                if (m_map_script_pub_keys.count(script) != 0) {
+                    throw std::runtime_error(strprintf("Error: Already loaded script at index %d as being at index %d", i, m_map_script_pub_keys[script]));
+                }
+                m_map_script_pub_keys[script] = i;
             }
-            m_map_script_pub_keys[script] = i;
+            for (const auto& pk_pair : out_keys.pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
+            }
+            m_max_cached_index++;
+            ++i;
         }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
-                continue;
+    }};
+    if (chunks.empty()) {
+        merge_expansions(expand_range(range_start, range_end));
+    } else {
+        // Wait for all chunks even if one fails, as they reference the locals above
+        std::vector<std::vector<Expansion>> results;
+        std::exception_ptr error;
+        for (auto& chunk : chunks) {
+            try {
+                results.push_back(chunk.get());
+            } catch (...) {
+                if (!error) error = std::current_exception();
             }
-            m_map_pubkeys[pubkey] = i;
         }
-        m_max_cached_index++;
+        if (error) std::rethrow_exception(error);
+        for (auto& expansions : results) merge_expansions(std::move(expansions));
     }
     // Make sure the wallet knows about our new spks
     m_storage.TopUpCallback(new_spks, this);
@@ -29,6 +29,7 @@
 #include <unordered_map>
 
 enum class OutputType;
+class ThreadPool;
 
 namespace wallet {
 struct MigrationData;
@@ -688,7 +689,11 @@ public:
 
     uint256 GetID() const override;
 
-    void SetCache(const DescriptorCache& cache);
+    /**
+     * Set the descriptor cache and expand the scriptPubKeys of the descriptor's
+     * range from it. The expansion is split over the thread pool if one is given.
+     */
+    void SetCache(const DescriptorCache& cache, ThreadPool* thread_pool = nullptr);
 
     bool AddKey(const CKeyID& key_id, const CKey& key);
     bool AddCryptedKey(const CKeyID& key_id, const CPubKey& pubkey, const std::vector<unsigned char>& crypted_key);
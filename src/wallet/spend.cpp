@@ -19,6 +19,7 @@
 #include <util/check.h>
 #include <util/moneystr.h>
 #include <util/rbf.h>
+#include <util/threadpool.h>
 #include <util/trace.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -29,6 +30,8 @@
 #include <wallet/wallet.h>
 
 #include <cmath>
+#include <future>
+#include <mutex>
 
 using common::StringForFeeReason;
 using common::TransactionErrorString;
@@ -42,6 +45,8 @@ TRACEPOINT_SEMAPHORE(coin_selection, aps_create_tx_internal);
 
 namespace wallet {
 static constexpr size_t OUTPUT_GROUP_MAX_ENTRIES{100};
+//! Minimum number of output groups for which the coin selection algorithms run concurrently
+static constexpr size_t PARALLEL_COIN_SELECTION_MIN_GROUPS{1000};
 
 /** Whether the descriptor represents, directly or not, a witness program. */
 static bool IsSegwit(const Descriptor& desc) {
@@ -262,6 +267,34 @@ static OutputType GetOutputType(TxoutType type, bool is_from_p2sh)
     }
 }
 
+/** Compute the input size and output type of a coin for AvailableCoins. This only depends on the script of
+ * the coin, so the result is cached by the wallet. */
+static ScriptSpendInfo ComputeScriptSpendInfo(const CWallet& wallet, const CTxOut& output, bool can_grind_r, const CCoinControl* coin_control)
+{
+    std::unique_ptr<SigningProvider> provider = wallet.GetSolvingProvider(output.scriptPubKey);
+
+    int input_bytes = CalculateMaximumSignedInputSize(output, COutPoint(), provider.get(), can_grind_r, coin_control);
+    bool solvable = input_bytes > -1;
+
+    // Obtain script type
+    std::vector<std::vector<uint8_t>> script_solutions;
+    TxoutType type = Solver(output.scriptPubKey, script_solutions);
+
+    // If the output is P2SH and solvable, we want to know if it is
+    // a P2SH (legacy) or one of P2SH-P2WPKH, P2SH-P2WSH (P2SH-Segwit). We can determine
+    // this from the redeemScript. If the output is not solvable, it will be classified
+    // as a P2SH (legacy), since we have no way of knowing otherwise without the redeemScript
+    bool is_from_p2sh{false};
+    if (type == TxoutType::SCRIPTHASH && solvable) {
+        CScript script;
+        if (!provider->GetCScript(CScriptID(uint160(script_solutions[0])), script)) return {input_bytes, std::nullopt};
+        type = Solver(script, script_solutions);
+        is_from_p2sh = true;
+    }
+
+    return {input_bytes, GetOutputType(type, is_from_p2sh)};
+}
+
 // Fetch and validate the coin control selected inputs.
 // Coins could be internal (from the wallet) or external.
 util::Result<PreSelectedInputs> FetchSelectedInputs(const CWallet& wallet, const CCoinControl& coin_control,
@@ -326,13 +359,15 @@ CoinsResult AvailableCoins(const CWallet& wallet,
     const int max_depth = {coinControl ? coinControl->m_max_depth : DEFAULT_MAX_DEPTH};
     const bool only_safe = {coinControl ? !coinControl->m_include_unsafe_inputs : true};
     const bool can_grind_r = wallet.CanGrindR();
+    // Input sizes of coins assume maximum size signatures if R can't be ground or watch-only coins are allowed
+    const bool use_max_sig{!can_grind_r || UseMaxSig(std::nullopt, coinControl)};
     std::vector<COutPoint> outpoints;
 
     std::set<uint256> trusted_parents;
-    for (const auto& entry : wallet.mapWallet)
+    // Only transactions with unspent outputs of the wallet can provide coins
+    for (const auto& [txid, unspent_outputs] : wallet.GetUnspentTXOs())
     {
-        const uint256& txid = entry.first;
-        const CWalletTx& wtx = entry.second;
+        const CWalletTx& wtx = wallet.mapWallet.at(txid);
 
         if (wallet.IsTxImmatureCoinBase(wtx) && !params.include_immature_coinbase)
             continue;
@@ -389,7 +424,7 @@ CoinsResult AvailableCoins(const CWallet& wallet,
 
         bool tx_from_me = CachedTxIsFromMe(wallet, wtx, ISMINE_ALL);
 
-        for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+        for (const uint32_t i : unspent_outputs) {
             const CTxOut& output = wtx.tx->vout[i];
             const COutPoint outpoint(Txid::FromUint256(txid), i);
 
@@ -416,9 +451,12 @@ CoinsResult AvailableCoins(const CWallet& wallet,
                 continue;
             }
 
-            std::unique_ptr<SigningProvider> provider = wallet.GetSolvingProvider(output.scriptPubKey);
-
-            int input_bytes = CalculateMaximumSignedInputSize(output, COutPoint(), provider.get(), can_grind_r, coinControl);
+            std::optional<ScriptSpendInfo> spend_info = wallet.GetCachedScriptSpendInfo(output.scriptPubKey, use_max_sig);
+            if (!spend_info) {
+                spend_info = ComputeScriptSpendInfo(wallet, output, can_grind_r, coinControl);
+                wallet.CacheScriptSpendInfo(output.scriptPubKey, use_max_sig, *spend_info);
+            }
+            const int input_bytes{spend_info->input_bytes};
             // Because CalculateMaximumSignedInputSize infers a solvable descriptor to get the satisfaction size,
             // it is safe to assume that this input is solvable if input_bytes is greater than -1.
             bool solvable = input_bytes > -1;
@@ -427,23 +465,9 @@ CoinsResult AvailableCoins(const CWallet& wallet,
             // Filter by spendable outputs only
             if (!spendable && params.only_spendable) continue;
 
-            // Obtain script type
-            std::vector<std::vector<uint8_t>> script_solutions;
-            TxoutType type = Solver(output.scriptPubKey, script_solutions);
-
-            // If the output is P2SH and solvable, we want to know if it is
-            // a P2SH (legacy) or one of P2SH-P2WPKH, P2SH-P2WSH (P2SH-Segwit). We can determine
-            // this from the redeemScript. If the output is not solvable, it will be classified
-            // as a P2SH (legacy), since we have no way of knowing otherwise without the redeemScript
-            bool is_from_p2sh{false};
-            if (type == TxoutType::SCRIPTHASH && solvable) {
-                CScript script;
-                if (!provider->GetCScript(CScriptID(uint160(script_solutions[0])), script)) continue;
-                type = Solver(script, script_solutions);
-                is_from_p2sh = true;
-            }
+            if (!spend_info->output_type) continue;
 
-            result.Add(GetOutputType(type, is_from_p2sh),
+            result.Add(*spend_info->output_type,
                        COutput(outpoint, output, nDepth, input_bytes, spendable, solvable, safeTx, wtx.GetTxTime(), tx_from_me, feerate));
 
             outpoints.push_back(outpoint);
@@ -660,6 +684,15 @@ FilteredOutputGroups GroupOutputs(const CWallet& wallet,
 // Returns true if the result contains an error and the message is not empty
 static bool HasErrorMsg(const util::Result<SelectionResult>& res) { return !util::ErrorString(res).empty(); }
 
+//! Worker running the BnB and CoinGrinder searches while Knapsack runs on the caller, shared by all wallets and started on first use
+static ThreadPool& GetCoinSelectionThreadPool()
+{
+    static ThreadPool thread_pool{"coinselect"};
+    static std::once_flag started;
+    std::call_once(started, [] { thread_pool.Start(1); });
+    return thread_pool;
+}
+
 util::Result<SelectionResult> AttemptSelection(interfaces::Chain& chain, const CAmount& nTargetValue, OutputGroupTypeMap& groups,
                                const CoinSelectionParams& coin_selection_params, bool allow_mixed_output_types)
 {
@@ -708,35 +741,64 @@ util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, co
         return util::Error{_("Maximum transaction weight is less than transaction weight without inputs")};
     }
 
-    // SFFO frequently causes issues in the context of changeless input sets: skip BnB when SFFO is active
-    if (!coin_selection_params.m_subtract_fee_outputs) {
-        if (auto bnb_result{SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight)}) {
-            results.push_back(*bnb_result);
-        } else append_error(std::move(bnb_result));
-    }
-
     // Deduct change weight because remaining Coin Selection algorithms can create change output
     int change_outputs_weight = coin_selection_params.change_output_size * WITNESS_SCALE_FACTOR;
-    max_selection_weight -= change_outputs_weight;
-    if (max_selection_weight < 0 && results.empty()) {
-        return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+    const int max_selection_weight_with_change{max_selection_weight - change_outputs_weight};
+
+    // The BnB and CoinGrinder searches share a time budget, if any
+    CoinSelectionInterrupt interrupt{coin_selection_params.m_max_search_time};
+    std::optional<util::Result<SelectionResult>> bnb_result;
+    std::optional<util::Result<SelectionResult>> cg_result;
+    // SFFO frequently causes issues in the context of changeless input sets: skip BnB when SFFO is active
+    const bool run_bnb{!coin_selection_params.m_subtract_fee_outputs};
+    // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
+    const bool run_cg{coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}};
+    const auto run_bnb_search{[&] {
+        bnb_result.emplace(SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight, &interrupt));
+    }};
+    const auto run_cg_search{[&] {
+        cg_result.emplace(CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight_with_change, &interrupt));
+        if (*cg_result) (*cg_result)->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
+    }};
+
+    // BnB and CoinGrinder search (and sort) the positive groups, while Knapsack draws from the mixed groups.
+    // For large pools, the searches run on a worker thread while Knapsack runs on this one. SRD runs last
+    // because it depends on the order the searches leave the positive groups in and on the randomness
+    // Knapsack consumed, so the results are the same as when running the algorithms one after the other.
+    const bool run_parallel{(run_bnb || run_cg) && max_selection_weight_with_change >= 0 &&
+                            groups.positive_group.size() + groups.mixed_group.size() >= PARALLEL_COIN_SELECTION_MIN_GROUPS};
+    std::future<void> searches;
+    if (run_parallel) {
+        searches = GetCoinSelectionThreadPool().Submit([&] {
+            if (run_bnb) run_bnb_search();
+            if (run_cg) run_cg_search();
+        });
+    } else {
+        if (run_bnb) run_bnb_search();
+        if (max_selection_weight_with_change < 0 && !(bnb_result && *bnb_result)) {
+            return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+        }
     }
 
     // The knapsack solver has some legacy behavior where it will spend dust outputs. We retain this behavior, so don't filter for positive only here.
-    if (auto knapsack_result{KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast, max_selection_weight)}) {
-        results.push_back(*knapsack_result);
-    } else append_error(std::move(knapsack_result));
-
-    if (coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}) { // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
-        if (auto cg_result{CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight)}) {
-            cg_result->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
-            results.push_back(*cg_result);
+    auto knapsack_result{KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast, max_selection_weight_with_change)};
+
+    if (run_parallel) {
+        searches.get();
+    } else if (run_cg) {
+        run_cg_search();
+    }
+
+    for (auto* result : {bnb_result ? &*bnb_result : nullptr, &knapsack_result, cg_result ? &*cg_result : nullptr}) {
+        if (!result) continue;
+        if (*result) {
+            results.push_back(**result);
         } else {
-            append_error(std::move(cg_result));
+            append_error(std::move(*result));
         }
     }
 
-    if (auto srd_result{SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, coin_selection_params.rng_fast, max_selection_weight)}) {
+    if (auto srd_result{SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, coin_selection_params.rng_fast, max_selection_weight_with_change)}) {
         results.push_back(*srd_result);
     } else append_error(std::move(srd_result));
 
@@ -1027,6 +1089,7 @@ static util::Result<CreatedTransactionResult> CreateTransactionInternal(
     coin_selection_params.m_avoid_partial_spends = coin_control.m_avoid_partial_spends;
     coin_selection_params.m_include_unsafe_inputs = coin_control.m_include_unsafe_inputs;
     coin_selection_params.m_max_tx_weight = coin_control.m_max_tx_weight.value_or(MAX_STANDARD_TX_WEIGHT);
+    coin_selection_params.m_max_search_time = coin_control.m_max_search_time;
     int minimum_tx_weight = 0;
     if (coin_selection_params.m_max_tx_weight.value() < minimum_tx_weight || coin_selection_params.m_max_tx_weight.value() > MAX_STANDARD_TX_WEIGHT) {
         return util::Error{strprintf(_("Maximum transaction weight must be between %d and %d"), minimum_tx_weight, MAX_STANDARD_TX_WEIGHT)};
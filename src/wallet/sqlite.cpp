@@ -112,7 +112,7 @@ Mutex SQLiteDatabase::g_sqlite_mutex;
 int SQLiteDatabase::g_sqlite_count = 0;
 
 SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_path, const DatabaseOptions& options, bool mock)
-    : WalletDatabase(), m_mock(mock), m_dir_path(fs::PathToString(dir_path)), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync)
+    : WalletDatabase(), m_mock(mock), m_dir_path(fs::PathToString(dir_path)), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync), m_use_wal(options.use_sqlite_wal)
 {
     {
         LOCK(g_sqlite_mutex);
@@ -292,6 +292,17 @@ void SQLiteDatabase::Open()
     // Enable fullfsync for the platforms that use it
     SetPragma(m_db, "fullfsync", "true", "Failed to enable fullfsync");
 
+    if (m_use_wal && !m_mock) {
+        // With exclusive locking mode, WAL does not need shared memory, so this works on all platforms.
+        // synchronous=NORMAL only syncs the WAL on checkpoints, which keeps the database consistent
+        // but may lose the latest transactions on power loss.
+        SetPragma(m_db, "journal_mode", "WAL", "Failed to set journal mode to WAL");
+        SetPragma(m_db, "synchronous", "NORMAL", "Failed to set synchronous mode to NORMAL");
+    } else if (!m_mock) {
+        // The journal mode is stored in the database file, so undo a previous use of WAL.
+        SetPragma(m_db, "journal_mode", "DELETE", "Failed to set journal mode to DELETE");
+    }
+
     if (m_use_unsafe_sync) {
         // Use normal synchronous mode for the journal
         LogPrintf("WARNING SQLite is configured to not wait for data to be flushed to disk. Data loss and corruption may occur.\n");
@@ -372,6 +383,10 @@ bool SQLiteDatabase::Backup(const std::string& dest) const
 
 void SQLiteDatabase::Close()
 {
+    // Don't lose grouped writes, closing the connection would roll them back
+    if (!CommitGroup()) {
+        LogPrintf("SQLiteDatabase: Grouped writes were rolled back while closing the database\n");
+    }
     int res = sqlite3_close(m_db);
     if (res != SQLITE_OK) {
         throw std::runtime_error(strprintf("SQLiteDatabase: Failed to close database: %s\n", sqlite3_errstr(res)));
@@ -385,6 +400,59 @@ bool SQLiteDatabase::HasActiveTxn()
     return m_db && sqlite3_get_autocommit(m_db) == 0;
 }
 
+void SQLiteDatabase::BeginGroupCommit(size_t max_records)
+{
+    m_write_semaphore.wait();
+    if (m_group_depth++ == 0) {
+        m_group_max_records = max_records;
+        m_group_failed = false;
+    }
+    m_write_semaphore.post();
+}
+
+bool SQLiteDatabase::EndGroupCommit()
+{
+    m_write_semaphore.wait();
+    bool committed{true};
+    if (Assume(m_group_depth > 0) && --m_group_depth == 0) committed = CommitGroup();
+    const bool success{committed && !m_group_failed};
+    m_write_semaphore.post();
+    return success;
+}
+
+void SQLiteDatabase::GroupWriteBegin()
+{
+    if (m_group_depth == 0 || m_group_txn || !m_db) return;
+    if (sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        // Fall back to committing each write on its own
+        LogPrintf("SQLiteDatabase: Failed to begin group commit transaction\n");
+        return;
+    }
+    m_group_txn = true;
+    m_group_records = 0;
+}
+
+bool SQLiteDatabase::GroupWriteEnd()
+{
+    if (m_group_txn && ++m_group_records >= m_group_max_records) return CommitGroup();
+    return true;
+}
+
+bool SQLiteDatabase::CommitGroup()
+{
+    if (!m_group_txn) return true;
+    m_group_txn = false;
+    if (m_group_exec_handler->Exec(*this, "COMMIT TRANSACTION") == SQLITE_OK) return true;
+
+    LogPrintf("SQLiteDatabase: Failed to commit group commit transaction: %s\n", sqlite3_errmsg(m_db));
+    m_group_failed = true;
+    // Some errors leave the transaction open. Roll it back so the next transaction can begin.
+    if (HasActiveTxn() && m_group_exec_handler->Exec(*this, "ROLLBACK TRANSACTION") != SQLITE_OK) {
+        LogPrintf("SQLiteDatabase: Failed to roll back group commit transaction: %s\n", sqlite3_errmsg(m_db));
+    }
+    return false;
+}
+
 int SQliteExecHandler::Exec(SQLiteDatabase& database, const std::string& statement)
 {
     return sqlite3_exec(database.m_db, statement.data(), nullptr, nullptr, nullptr);
@@ -498,7 +566,10 @@ bool SQLiteBatch::WriteKey(DataStream&& key, DataStream&& value, bool overwrite)
     if (!BindBlobToStatement(stmt, 2, value, "value")) return false;
 
     // Acquire semaphore if not previously acquired when creating a transaction.
-    if (!m_txn) m_database.m_write_semaphore.wait();
+    if (!m_txn) {
+        m_database.m_write_semaphore.wait();
+        m_database.GroupWriteBegin();
+    }
 
     // Execute
     int res = sqlite3_step(stmt);
@@ -508,9 +579,13 @@ bool SQLiteBatch::WriteKey(DataStream&& key, DataStream&& value, bool overwrite)
         LogPrintf("%s: Unable to execute statement: %s\n", __func__, sqlite3_errstr(res));
     }
 
-    if (!m_txn) m_database.m_write_semaphore.post();
+    bool group_committed{true};
+    if (!m_txn) {
+        group_committed = m_database.GroupWriteEnd();
+        m_database.m_write_semaphore.post();
+    }
 
-    return res == SQLITE_DONE;
+    return res == SQLITE_DONE && group_committed;
 }
 
 bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob)
@@ -522,7 +597,10 @@ bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob)
     if (!BindBlobToStatement(stmt, 1, blob, "key")) return false;
 
     // Acquire semaphore if not previously acquired when creating a transaction.
-    if (!m_txn) m_database.m_write_semaphore.wait();
+    if (!m_txn) {
+        m_database.m_write_semaphore.wait();
+        m_database.GroupWriteBegin();
+    }
 
     // Execute
     int res = sqlite3_step(stmt);
@@ -532,9 +610,13 @@ bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob)
         LogPrintf("%s: Unable to execute statement: %s\n", __func__, sqlite3_errstr(res));
     }
 
-    if (!m_txn) m_database.m_write_semaphore.post();
+    bool group_committed{true};
+    if (!m_txn) {
+        group_committed = m_database.GroupWriteEnd();
+        m_database.m_write_semaphore.post();
+    }
 
-    return res == SQLITE_DONE;
+    return res == SQLITE_DONE && group_committed;
 }
 
 bool SQLiteBatch::EraseKey(DataStream&& key)
@@ -652,6 +734,11 @@ bool SQLiteBatch::TxnBegin()
 {
     if (!m_database.m_db || m_txn) return false;
     m_database.m_write_semaphore.wait();
+    // Writes grouped so far are committed first, this batch's transaction can't be nested into the group
+    if (!m_database.CommitGroup()) {
+        m_database.m_write_semaphore.post();
+        return false;
+    }
     Assert(!m_database.HasActiveTxn());
     int res = Assert(m_exec_handler)->Exec(m_database, "BEGIN TRANSACTION");
     if (res != SQLITE_OK) {
@@ -120,6 +120,14 @@ private:
 
     void Cleanup() noexcept EXCLUSIVE_LOCKS_REQUIRED(!g_sqlite_mutex);
 
+    //! Group commit state, see BeginGroupCommit(). Only accessed while holding m_write_semaphore.
+    size_t m_group_depth{0};
+    size_t m_group_max_records{0};
+    size_t m_group_records{0};
+    bool m_group_txn{false};
+    bool m_group_failed{false};
+    std::unique_ptr<SQliteExecHandler> m_group_exec_handler{std::make_unique<SQliteExecHandler>()};
+
 public:
     SQLiteDatabase() = delete;
 
@@ -174,8 +182,29 @@ public:
     /** Return true if there is an on-going txn in this connection */
     bool HasActiveTxn();
 
+    void BeginGroupCommit(size_t max_records) override;
+    bool EndGroupCommit() override;
+
+    /**
+     * Called by batches around a write that is not part of their own transaction, while
+     * holding m_write_semaphore. Opens a group transaction if group commit is enabled, and
+     * commits it once it holds enough writes. GroupWriteEnd() returns false if that commit
+     * failed.
+     */
+    void GroupWriteBegin();
+    [[nodiscard]] bool GroupWriteEnd();
+    /**
+     * Commit the group transaction, if open. Must be called while holding m_write_semaphore.
+     * If the commit fails, the transaction is rolled back, so the writes grouped into it are
+     * lost, and false is returned.
+     */
+    [[nodiscard]] bool CommitGroup();
+    //! Replace the handler executing the group transaction statements, for tests
+    void SetGroupExecHandler(std::unique_ptr<SQliteExecHandler>&& handler) { m_group_exec_handler = std::move(handler); }
+
     sqlite3* m_db{nullptr};
     bool m_use_unsafe_sync;
+    bool m_use_wal;
 };
 
 std::unique_ptr<SQLiteDatabase> MakeSQLiteDatabase(const fs::path& path, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error);
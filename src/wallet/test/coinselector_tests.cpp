@@ -1305,6 +1305,28 @@ BOOST_AUTO_TEST_CASE(coin_grinder_tests)
     }
 }
 
+BOOST_AUTO_TEST_CASE(coin_selection_interrupt)
+{
+    CoinSelectionInterrupt unlimited;
+    BOOST_CHECK(!unlimited.Interrupted());
+    unlimited.Interrupt();
+    BOOST_CHECK(unlimited.Interrupted());
+    CoinSelectionInterrupt no_time{std::chrono::milliseconds{0}};
+    BOOST_CHECK(no_time.Interrupted());
+    CoinSelectionInterrupt enough_time{std::chrono::hours{1}};
+    BOOST_CHECK(!enough_time.Interrupted());
+
+    std::vector<COutput> utxo_pool;
+    add_coin(1 * CENT, 1, utxo_pool);
+    add_coin(2 * CENT, 2, utxo_pool);
+    add_coin(3 * CENT, 3, utxo_pool);
+    BOOST_CHECK(SelectCoinsBnB(GroupCoins(utxo_pool), 3 * CENT, 0.5 * CENT, MAX_STANDARD_TX_WEIGHT, &enough_time));
+    // An interrupted search stops as if it had run out of tries before finding a solution
+    const auto res{SelectCoinsBnB(GroupCoins(utxo_pool), 3 * CENT, 0.5 * CENT, MAX_STANDARD_TX_WEIGHT, &no_time)};
+    BOOST_CHECK(!res);
+    BOOST_CHECK(util::ErrorString(res).empty());
+}
+
 static util::Result<SelectionResult> SelectCoinsSRD(const CAmount& target,
                                                     const CoinSelectionParams& cs_params,
                                                     const node::NodeContext& m_node,
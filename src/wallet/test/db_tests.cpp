@@ -385,6 +385,114 @@ BOOST_AUTO_TEST_CASE(concurrent_txn_dont_interfere)
     BOOST_CHECK(handler2->Read(key, read_value));
     BOOST_CHECK_EQUAL(read_value, value2);
 }
+
+BOOST_AUTO_TEST_CASE(group_commit)
+{
+    DatabaseOptions options;
+    DatabaseStatus status;
+    bilingual_str error;
+    std::unique_ptr<SQLiteDatabase> database = MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error);
+    BOOST_REQUIRE(database);
+
+    std::string value = "value";
+    std::string read_value;
+    {
+        DatabaseGroupCommit outer{*database, /*max_records=*/3};
+        BOOST_CHECK(!database->HasActiveTxn());
+        {
+            // Nested groups keep the outer limit and only the outer group commits
+            DatabaseGroupCommit inner{*database, /*max_records=*/1};
+            BOOST_CHECK(database->MakeBatch()->Write(std::string{"key1"}, value));
+            BOOST_CHECK(database->MakeBatch()->Write(std::string{"key2"}, value));
+        }
+        // Writes from different batches share the group transaction
+        BOOST_CHECK(database->HasActiveTxn());
+        BOOST_CHECK(database->MakeBatch()->Read(std::string{"key1"}, read_value));
+        // The transaction is committed once it reaches max_records writes
+        BOOST_CHECK(database->MakeBatch()->Write(std::string{"key3"}, value));
+        BOOST_CHECK(!database->HasActiveTxn());
+        BOOST_CHECK(database->MakeBatch()->Write(std::string{"key4"}, value));
+        BOOST_CHECK(database->HasActiveTxn());
+
+        // A batch transaction commits the group first and is not nested into it
+        std::unique_ptr<DatabaseBatch> batch = database->MakeBatch();
+        BOOST_CHECK(batch->TxnBegin());
+        BOOST_CHECK(batch->Write(std::string{"key5"}, value));
+        BOOST_CHECK(batch->TxnAbort());
+        BOOST_CHECK(!batch->Exists(std::string{"key5"}));
+        BOOST_CHECK(batch->Exists(std::string{"key4"}));
+
+        BOOST_CHECK(database->MakeBatch()->Write(std::string{"key6"}, value));
+        BOOST_CHECK(database->HasActiveTxn());
+    }
+    // Ending the group commits the remaining writes
+    BOOST_CHECK(!database->HasActiveTxn());
+    std::unique_ptr<DatabaseBatch> batch = database->MakeBatch();
+    for (const char* key : {"key1", "key2", "key3", "key4", "key6"}) {
+        BOOST_CHECK(batch->Exists(std::string{key}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(group_commit_failure)
+{
+    DatabaseOptions options;
+    DatabaseStatus status;
+    bilingual_str error;
+    std::unique_ptr<SQLiteDatabase> database = MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error);
+    BOOST_REQUIRE(database);
+
+    std::string value = "value";
+    database->SetGroupExecHandler(std::make_unique<DbExecBlocker>(std::set<std::string>{"COMMIT TRANSACTION"}));
+    {
+        DatabaseGroupCommit group{*database, /*max_records=*/2};
+        BOOST_CHECK(database->MakeBatch()->Write(std::string{"key1"}, value));
+        // The write that fills the group reports the failed commit, and the group is rolled back
+        BOOST_CHECK(!database->MakeBatch()->Write(std::string{"key2"}, value));
+        BOOST_CHECK(!database->HasActiveTxn());
+        BOOST_CHECK(!database->MakeBatch()->Exists(std::string{"key1"}));
+        BOOST_CHECK(!group.Commit());
+    }
+
+    {
+        DatabaseGroupCommit group{*database, /*max_records=*/2};
+        BOOST_CHECK(database->MakeBatch()->Write(std::string{"key3"}, value));
+        // A batch transaction can still begin after the group failed to commit
+        std::unique_ptr<DatabaseBatch> batch = database->MakeBatch();
+        BOOST_CHECK(!batch->TxnBegin());
+        BOOST_CHECK(!database->HasActiveTxn());
+        BOOST_CHECK(batch->TxnBegin());
+        BOOST_CHECK(batch->TxnAbort());
+        BOOST_CHECK(!group.Commit());
+    }
+
+    database->SetGroupExecHandler(std::make_unique<SQliteExecHandler>());
+    {
+        DatabaseGroupCommit group{*database};
+        BOOST_CHECK(database->MakeBatch()->Write(std::string{"key4"}, value));
+        BOOST_CHECK(group.Commit());
+    }
+    BOOST_CHECK(database->MakeBatch()->Exists(std::string{"key4"}));
+}
+
+BOOST_AUTO_TEST_CASE(wal_journal_mode_not_persisted)
+{
+    // A wallet opened once with WAL goes back to the rollback journal without the option
+    DatabaseStatus status;
+    bilingual_str error;
+    const fs::path path{m_path_root / "sqlite"};
+    // Byte 18 of the database header is 2 in WAL mode and 1 with a rollback journal
+    auto file_format_version = [&] {
+        std::ifstream file{path / "wallet.dat", std::ios::binary};
+        file.seekg(18);
+        return file.get();
+    };
+    DatabaseOptions wal_options;
+    wal_options.use_sqlite_wal = true;
+    BOOST_REQUIRE(MakeSQLiteDatabase(path, wal_options, status, error));
+    BOOST_CHECK_EQUAL(file_format_version(), 2);
+    BOOST_REQUIRE(MakeSQLiteDatabase(path, DatabaseOptions{}, status, error));
+    BOOST_CHECK_EQUAL(file_format_version(), 1);
+}
 #endif // USE_SQLITE
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -73,6 +73,7 @@ FUZZ_TARGET(wallet_create_transaction, .init = initialize_setup)
         auto ret{fuzzed_wallet.wallet->mapWallet.emplace(std::piecewise_construct, std::forward_as_tuple(txid), std::forward_as_tuple(MakeTransactionRef(std::move(tx)), TxStateConfirmed{chainstate.m_chain.Tip()->GetBlockHash(), chainstate.m_chain.Height(), /*index=*/0}))};
         assert(ret.second);
     }
+    WITH_LOCK(fuzzed_wallet.wallet->cs_wallet, fuzzed_wallet.wallet->RefreshAllUnspentTXOs());
 
     std::vector<CRecipient> recipients;
     LIMITED_WHILE(fuzzed_data_provider.ConsumeBool(), 100) {
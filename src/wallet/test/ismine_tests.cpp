@@ -9,6 +9,7 @@
 #include <script/solver.h>
 #include <script/signingprovider.h>
 #include <test/util/setup_common.h>
+#include <wallet/scriptfilter.h>
 #include <wallet/types.h>
 #include <wallet/wallet.h>
 #include <wallet/test/util.h>
@@ -702,5 +703,43 @@ BOOST_AUTO_TEST_CASE(ismine_standard)
     }
 }
 
+BOOST_AUTO_TEST_CASE(script_pubkey_filter)
+{
+    const auto random_script{[&] {
+        return GetScriptForDestination(WitnessV0KeyHash{uint160{m_rng.randbytes(20)}});
+    }};
+
+    ScriptPubKeyFilter filter;
+    BOOST_CHECK_EQUAL(filter.Capacity(), 0U);
+    BOOST_CHECK(!filter.MayContain(random_script()));
+
+    constexpr size_t num_scripts{10'000};
+    filter.Reset(num_scripts);
+    BOOST_CHECK_GE(filter.Capacity(), num_scripts);
+    std::vector<CScript> scripts;
+    for (size_t i = 0; i < num_scripts; ++i) {
+        scripts.push_back(random_script());
+        filter.Insert(scripts.back());
+    }
+    // No false negatives
+    for (const CScript& script : scripts) {
+        BOOST_CHECK(filter.MayContain(script));
+    }
+    // Few false positives at capacity
+    int false_positives{0};
+    for (size_t i = 0; i < num_scripts; ++i) {
+        false_positives += filter.MayContain(random_script());
+    }
+    BOOST_CHECK_LT(false_positives, 200);
+
+    // Resetting removes all scripts
+    filter.Reset(num_scripts);
+    int matches{0};
+    for (const CScript& script : scripts) {
+        matches += filter.MayContain(script);
+    }
+    BOOST_CHECK_EQUAL(matches, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -2,10 +2,13 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <key.h>
 #include <key_io.h>
 #include <node/types.h>
+#include <psbt.h>
 #include <util/bip32.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <wallet/wallet.h>
 
 #include <boost/test/unit_test.hpp>
@@ -154,5 +157,49 @@ BOOST_AUTO_TEST_CASE(parse_hd_keypath)
     BOOST_CHECK(!ParseHDKeypath("m/4294967296", keypath)); // 4294967296 == 0xFFFFFFFF (uint32_t max) + 1
 }
 
+BOOST_AUTO_TEST_CASE(psbt_sign_inputs_batch)
+{
+    // Signing the inputs of a PSBT in a batch on a thread pool gives the same PSBT as signing them one at a time
+    constexpr int NUM_INPUTS{200};
+    FlatSigningProvider keystore;
+    CMutableTransaction mtx;
+    std::vector<CTxOut> prev_outs;
+    for (int i = 0; i < NUM_INPUTS; ++i) {
+        const CKey key{GenerateRandomKey()};
+        const CPubKey pubkey{key.GetPubKey()};
+        keystore.keys.emplace(pubkey.GetID(), key);
+        keystore.pubkeys.emplace(pubkey.GetID(), pubkey);
+        mtx.vin.emplace_back(Txid::FromUint256(m_rng.rand256()), i);
+        prev_outs.emplace_back(COIN, GetScriptForDestination(i % 2 ? CTxDestination{WitnessV0KeyHash(pubkey)} : CTxDestination{WitnessV1Taproot(XOnlyPubKey{pubkey})}));
+    }
+    mtx.vout.emplace_back(NUM_INPUTS * COIN / 2, GetScriptForDestination(WitnessV0KeyHash(keystore.pubkeys.begin()->second)));
+    PartiallySignedTransaction psbt_seq{mtx};
+    for (int i = 0; i < NUM_INPUTS; ++i) psbt_seq.inputs[i].witness_utxo = prev_outs[i];
+    PartiallySignedTransaction psbt_batch{psbt_seq};
+
+    const PrecomputedTransactionData txdata{PrecomputePSBTData(psbt_seq)};
+    std::vector<std::pair<int, const SigningProvider*>> inputs;
+    for (int i = 0; i < NUM_INPUTS; ++i) {
+        BOOST_CHECK(SignPSBTInput(keystore, psbt_seq, i, &txdata, SIGHASH_DEFAULT));
+        inputs.emplace_back(i, &keystore);
+    }
+
+    ThreadPool thread_pool{"psbtsign"};
+    thread_pool.Start(2);
+    BOOST_CHECK(SignPSBTInputs(inputs, psbt_batch, txdata, SIGHASH_DEFAULT, /*finalize=*/true, &thread_pool));
+    // Schnorr signatures use random aux data, so compare the ECDSA inputs and verify the others
+    for (int i = 0; i < NUM_INPUTS; ++i) {
+        BOOST_CHECK(PSBTInputSignedAndVerified(psbt_batch, i, &txdata));
+        if (i % 2) BOOST_CHECK(psbt_batch.inputs[i].final_script_witness.stack == psbt_seq.inputs[i].final_script_witness.stack);
+    }
+    BOOST_CHECK(FinalizePSBT(psbt_batch, &thread_pool));
+
+    // Inputs that cannot be signed are reported as incomplete
+    PartiallySignedTransaction psbt_unsigned{mtx};
+    for (int i = 0; i < NUM_INPUTS; ++i) psbt_unsigned.inputs[i].witness_utxo = prev_outs[i];
+    BOOST_CHECK(!FinalizePSBT(psbt_unsigned, &thread_pool));
+    BOOST_CHECK_EQUAL(CountPSBTUnsignedInputs(psbt_unsigned), size_t{NUM_INPUTS});
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
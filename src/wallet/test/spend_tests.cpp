@@ -13,6 +13,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+#include <optional>
+
 namespace wallet {
 BOOST_FIXTURE_TEST_SUITE(spend_tests, WalletTestingSetup)
 
@@ -61,6 +64,26 @@ BOOST_FIXTURE_TEST_CASE(SubtractFee, TestChain100Setup)
     BOOST_CHECK_EQUAL(fee, check_tx(fee + 123));
 }
 
+BOOST_FIXTURE_TEST_CASE(coin_selection_time_budget, TestChain100Setup)
+{
+    // Mature two coinbase outputs, so that paying 75 BTC needs both
+    for (int i = 0; i < 2; ++i) CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    auto wallet = CreateSyncedWallet(*m_node.chain, WITH_LOCK(Assert(m_node.chainman)->GetMutex(), return m_node.chainman->ActiveChain()), coinbaseKey);
+
+    // A spent time budget stops the BnB and CoinGrinder searches right away,
+    // the other algorithms still fund the transaction.
+    CCoinControl coin_control;
+    coin_control.m_feerate.emplace(100000);
+    coin_control.fOverrideFeeRate = true;
+    for (const auto max_search_time : {std::optional<std::chrono::milliseconds>{}, std::optional{std::chrono::milliseconds{0}}}) {
+        coin_control.m_max_search_time = max_search_time;
+        const auto res{CreateTransaction(*wallet, {CRecipient{PubKeyDestination({}), 75 * COIN, /*subtract_fee=*/false}}, /*change_pos=*/std::nullopt, coin_control)};
+        BOOST_REQUIRE(res);
+        BOOST_CHECK_GE(res->tx->vin.size(), 2U);
+        BOOST_CHECK_GT(res->fee, 0);
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(wallet_duplicated_preset_inputs_test, TestChain100Setup)
 {
     // Verify that the wallet's Coin Selection process does not include pre-selected inputs twice in a transaction.
@@ -104,5 +127,44 @@ BOOST_FIXTURE_TEST_CASE(wallet_duplicated_preset_inputs_test, TestChain100Setup)
     BOOST_CHECK(!CreateTransaction(*wallet, recipients, /*change_pos=*/std::nullopt, coin_control));
 }
 
+BOOST_FIXTURE_TEST_CASE(available_coins_script_spend_info, TestChain100Setup)
+{
+    CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    auto wallet = CreateSyncedWallet(*m_node.chain, WITH_LOCK(Assert(m_node.chainman)->GetMutex(), return m_node.chainman->ActiveChain()), coinbaseKey);
+    const CScript script{GetScriptForRawPubKey(coinbaseKey.GetPubKey())};
+
+    LOCK(wallet->cs_wallet);
+    BOOST_CHECK(!wallet->GetCachedScriptSpendInfo(script, /*use_max_sig=*/false));
+
+    // Listing the coins caches the spend info of their script
+    std::vector<COutput> coins = AvailableCoins(*wallet).All();
+    BOOST_REQUIRE(!coins.empty());
+    const int input_bytes{CalculateMaximumSignedInputSize(coins[0].txout, wallet.get(), /*coin_control=*/nullptr)};
+    BOOST_CHECK_GT(input_bytes, 0);
+    for (const auto& coin : coins) BOOST_CHECK_EQUAL(coin.input_bytes, input_bytes);
+    auto spend_info{wallet->GetCachedScriptSpendInfo(script, /*use_max_sig=*/false)};
+    BOOST_REQUIRE(spend_info);
+    BOOST_CHECK_EQUAL(spend_info->input_bytes, input_bytes);
+    BOOST_CHECK(spend_info->output_type == OutputType::UNKNOWN);
+
+    // Allowing watch-only coins assumes maximum size signatures, which are cached separately
+    BOOST_CHECK(!wallet->GetCachedScriptSpendInfo(script, /*use_max_sig=*/true));
+    CCoinControl coin_control;
+    coin_control.fAllowWatchOnly = true;
+    coins = AvailableCoins(*wallet, &coin_control).All();
+    BOOST_REQUIRE(!coins.empty());
+    BOOST_CHECK_EQUAL(coins[0].input_bytes, CalculateMaximumSignedInputSize(coins[0].txout, wallet.get(), &coin_control));
+    BOOST_CHECK_GT(coins[0].input_bytes, input_bytes);
+    BOOST_CHECK(wallet->GetCachedScriptSpendInfo(script, /*use_max_sig=*/true));
+
+    // Adding the script to a script pubkey manager invalidates its spend info
+    const auto spk_mans{wallet->GetScriptPubKeyMans(script)};
+    BOOST_REQUIRE_EQUAL(spk_mans.size(), 1U);
+    wallet->CacheNewScriptPubKeys({script}, *spk_mans.begin());
+    BOOST_CHECK(!wallet->GetCachedScriptSpendInfo(script, /*use_max_sig=*/false));
+    BOOST_CHECK(!wallet->GetCachedScriptSpendInfo(script, /*use_max_sig=*/true));
+    BOOST_CHECK_EQUAL(AvailableCoins(*wallet).All()[0].input_bytes, input_bytes);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -315,8 +315,7 @@ BOOST_FIXTURE_TEST_CASE(importwallet_rescan, TestChain100Setup)
         request.params.setArray();
         request.params.push_back(backup_file);
         AddWallet(context, wallet);
-        LOCK(Assert(m_node.chainman)->GetMutex());
-        wallet->SetLastBlockProcessed(m_node.chainman->ActiveChain().Height(), m_node.chainman->ActiveChain().Tip()->GetBlockHash());
+        WITH_LOCK(Assert(m_node.chainman)->GetMutex(), wallet->SetLastBlockProcessed(m_node.chainman->ActiveChain().Height(), m_node.chainman->ActiveChain().Tip()->GetBlockHash()));
         wallet::importwallet().HandleRequest(request);
         RemoveWallet(context, wallet, /* load_on_start= */ std::nullopt);
 
@@ -676,6 +675,56 @@ BOOST_FIXTURE_TEST_CASE(ListCoinsTest, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2U);
 }
 
+static void CheckUnspentTXOs(const CWallet& wallet) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet)
+{
+    // The incrementally maintained unspent outputs must match a scan of all wallet transactions
+    std::map<uint256, std::vector<uint32_t>> expected;
+    for (const auto& [txid, wtx] : wallet.mapWallet) {
+        for (uint32_t i = 0; i < wtx.tx->vout.size(); ++i) {
+            if (wallet.IsMine(wtx.tx->vout[i]) != ISMINE_NO && !wallet.IsSpent(COutPoint{wtx.GetHash(), i})) expected[txid].push_back(i);
+        }
+    }
+    BOOST_CHECK(wallet.GetUnspentTXOs() == expected);
+    BOOST_CHECK_EQUAL(GetBalance(wallet).m_mine_trusted, AvailableCoins(wallet).GetTotalAmount());
+}
+
+BOOST_FIXTURE_TEST_CASE(wallet_unspent_txos, ListCoinsTestingSetup)
+{
+    WITH_LOCK(wallet->cs_wallet, CheckUnspentTXOs(*wallet));
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, 50 * COIN);
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_immature, 100 * 50 * COIN);
+
+    // A confirmed spend replaces the coinbase output by its change
+    const CWalletTx& confirmed_tx{AddTx(CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false})};
+    {
+        LOCK(wallet->cs_wallet);
+        CheckUnspentTXOs(*wallet);
+        BOOST_CHECK(wallet->GetUnspentTXOs().count(confirmed_tx.GetHash()));
+    }
+
+    // An unbroadcast spend of the change makes it spent, until it is abandoned
+    CTransactionRef tx;
+    {
+        CCoinControl coin_control;
+        auto res{CreateTransaction(*wallet, {CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false}}, /*change_pos=*/std::nullopt, coin_control)};
+        BOOST_REQUIRE(res);
+        tx = res->tx;
+    }
+    wallet->CommitTransaction(tx, {}, {});
+    {
+        LOCK(wallet->cs_wallet);
+        CheckUnspentTXOs(*wallet);
+        BOOST_CHECK(wallet->GetUnspentTXOs().count(tx->GetHash()));
+        BOOST_CHECK(!wallet->GetUnspentTXOs().count(tx->vin[0].prevout.hash));
+    }
+    BOOST_CHECK(wallet->AbandonTransaction(tx->GetHash()));
+    {
+        LOCK(wallet->cs_wallet);
+        CheckUnspentTXOs(*wallet);
+        BOOST_CHECK(wallet->GetUnspentTXOs().count(tx->vin[0].prevout.hash));
+    }
+}
+
 void TestCoinsResult(ListCoinsTest& context, OutputType out_type, CAmount amount,
                      std::map<OutputType, size_t>& expected_coins_sizes)
 {
@@ -1021,5 +1070,77 @@ BOOST_FIXTURE_TEST_CASE(wallet_sync_tx_invalid_state_test, TestingSetup)
                           HasReason("DB error adding transaction to wallet, write failed"));
 }
 
+BOOST_FIXTURE_TEST_CASE(wallet_block_connected_notifications, TestingSetup)
+{
+    CWallet wallet(m_node.chain.get(), "", CreateMockableWalletDatabase());
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet.SetupDescriptorScriptPubKeyMans();
+    }
+    const CScript wallet_script{GetScriptForDestination(*Assert(wallet.GetNewDestination(OutputType::BECH32M, "")))};
+
+    std::vector<std::pair<uint256, ChangeType>> tx_changed;
+    std::vector<std::vector<std::pair<uint256, ChangeType>>> txs_changed;
+    boost::signals2::scoped_connection c1{wallet.NotifyTransactionChanged.connect([&](const uint256& hash, ChangeType status) {
+        tx_changed.emplace_back(hash, status);
+    })};
+    boost::signals2::scoped_connection c2{wallet.NotifyTransactionsChanged.connect([&](const std::vector<std::pair<uint256, ChangeType>>& changes) {
+        txs_changed.push_back(changes);
+    })};
+
+    // Outside of a block, every change is notified on its own
+    CMutableTransaction in_mempool;
+    in_mempool.vin.emplace_back(Txid::FromUint256(m_rng.rand256()), 0);
+    in_mempool.vout.emplace_back(COIN, wallet_script);
+    wallet.transactionAddedToMempool(MakeTransactionRef(in_mempool));
+    const std::vector<std::pair<uint256, ChangeType>> mempool_changes{{in_mempool.GetHash(), CT_NEW}};
+    BOOST_CHECK(tx_changed == mempool_changes);
+    BOOST_REQUIRE_EQUAL(txs_changed.size(), 1U);
+    BOOST_CHECK(txs_changed[0] == mempool_changes);
+    tx_changed.clear();
+    txs_changed.clear();
+
+    // A block confirming the mempool transaction, a new transaction paying to the
+    // wallet, a transaction spending from both and an unrelated transaction
+    CMutableTransaction received;
+    received.vin.emplace_back(Txid::FromUint256(m_rng.rand256()), 0);
+    received.vout.emplace_back(2 * COIN, wallet_script);
+    CMutableTransaction spend;
+    spend.vin.emplace_back(in_mempool.GetHash(), 0);
+    spend.vin.emplace_back(received.GetHash(), 0);
+    spend.vout.emplace_back(3 * COIN, CScript() << OP_TRUE);
+    CMutableTransaction unrelated;
+    unrelated.vin.emplace_back(Txid::FromUint256(m_rng.rand256()), 0);
+    unrelated.vout.emplace_back(COIN, CScript() << OP_TRUE);
+    CBlock block;
+    for (const CMutableTransaction& mtx : {unrelated, in_mempool, received, spend}) {
+        block.vtx.push_back(MakeTransactionRef(mtx));
+    }
+    const uint256 block_hash{block.GetHash()};
+    const uint256 prev_hash{m_rng.rand256()};
+    interfaces::BlockInfo block_info{block_hash};
+    block_info.prev_hash = &prev_hash;
+    block_info.height = 1;
+    block_info.chain_time_max = std::numeric_limits<unsigned int>::max();
+    block_info.data = &block;
+    wallet.blockConnected(ChainstateRole::NORMAL, block_info);
+
+    // Each transaction is notified once, in block order, and all of them at once
+    const std::vector<std::pair<uint256, ChangeType>> block_changes{
+        {in_mempool.GetHash(), CT_UPDATED}, {received.GetHash(), CT_NEW}, {spend.GetHash(), CT_NEW}};
+    BOOST_CHECK(tx_changed == block_changes);
+    BOOST_REQUIRE_EQUAL(txs_changed.size(), 1U);
+    BOOST_CHECK(txs_changed[0] == block_changes);
+    {
+        LOCK(wallet.cs_wallet);
+        BOOST_CHECK_EQUAL(wallet.mapWallet.size(), 3U);
+        for (const auto& [hash, status] : block_changes) {
+            BOOST_CHECK(wallet.GetWalletTx(hash)->isConfirmed());
+        }
+        BOOST_CHECK(wallet.IsSpent(COutPoint{received.GetHash(), 0}));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
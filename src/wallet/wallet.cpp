@@ -57,6 +57,7 @@
 #include <util/moneystr.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -73,11 +74,15 @@
 #include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <exception>
+#include <future>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <thread>
 #include <tuple>
+#include <unordered_set>
 #include <variant>
 
 struct KeyOriginInfo;
@@ -308,63 +313,90 @@ std::shared_ptr<CWallet> LoadWalletInternal(WalletContext& context, const std::s
     }
 }
 
-class FastWalletRescanFilter
-{
-public:
-    FastWalletRescanFilter(const CWallet& wallet) : m_wallet(wallet)
-    {
-        // fast rescanning via block filters is only supported by descriptor wallets right now
-        assert(!m_wallet.IsLegacy());
-
-        // create initial filter with scripts from all ScriptPubKeyMans
-        for (auto spkm : m_wallet.GetAllScriptPubKeyMans()) {
-            auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(spkm)};
-            assert(desc_spkm != nullptr);
-            AddScriptPubKeys(desc_spkm);
-            // save each range descriptor's end for possible future filter updates
-            if (desc_spkm->IsHDEnabled()) {
-                m_last_range_ends.emplace(desc_spkm->GetID(), desc_spkm->GetEndRange());
-            }
-        }
-    }
+//! Maximum number of worker threads preparing blocks ahead of the wallet update during a rescan
+constexpr int MAX_RESCAN_WORKERS{4};
+//! Number of blocks prepared by the rescan workers ahead of the wallet update
+constexpr size_t RESCAN_LOOKAHEAD_BLOCKS{16};
 
-    void UpdateIfNeeded()
+/**
+ * Snapshot of the scriptPubKeys of a descriptor wallet, which rescan workers
+ * match blocks and transactions against without holding cs_wallet. Scripts
+ * are only ever added to the wallet (e.g. by a keypool top-up), so a snapshot
+ * is current for as long as the wallet holds the same number of scripts.
+ *
+ * A snapshot is never modified once shared with the workers. Scripts added
+ * later go into a new snapshot layered on top of it, which only holds the new
+ * scripts. Layers are merged whenever the one below is not larger, which keeps
+ * the number of layers logarithmic in the number of scripts.
+ */
+struct RescanScriptSnapshot {
+    //! Snapshot this one adds scripts to, nullptr for the bottom layer
+    std::shared_ptr<const RescanScriptSnapshot> base;
+    //! Number of wallet scripts covered by this snapshot and its base
+    size_t num_scripts{0};
+    //! Scripts of this layer
+    std::unordered_set<CScript, SaltedSipHasher> scripts;
+    //! The same scripts in the form matched against block filters, only filled in for fast rescans
+    GCSFilter::ElementSet filter_set;
+
+    void Add(const CScript& script, bool use_block_filter)
     {
-        // repopulate filter with new scripts if top-up has happened since last iteration
-        for (const auto& [desc_spkm_id, last_range_end] : m_last_range_ends) {
-            auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(m_wallet.GetScriptPubKeyMan(desc_spkm_id))};
-            assert(desc_spkm != nullptr);
-            int32_t current_range_end{desc_spkm->GetEndRange()};
-            if (current_range_end > last_range_end) {
-                AddScriptPubKeys(desc_spkm, last_range_end);
-                m_last_range_ends.at(desc_spkm->GetID()) = current_range_end;
-            }
-        }
+        if (scripts.insert(script).second && use_block_filter) filter_set.emplace(script.begin(), script.end());
     }
 
-    std::optional<bool> MatchesBlock(const uint256& block_hash) const
+    bool Contains(const CScript& script) const
     {
-        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+        for (const RescanScriptSnapshot* layer{this}; layer; layer = layer->base.get()) {
+            if (layer->scripts.count(script)) return true;
+        }
+        return false;
     }
+};
 
-private:
-    const CWallet& m_wallet;
-    /** Map for keeping track of each range descriptor's last seen end range.
-      * This information is used to detect whether new addresses were derived
-      * (that is, if the current end range is larger than the saved end range)
-      * after processing a block and hence a filter set update is needed to
-      * take possible keypool top-ups into account.
-      */
-    std::map<uint256, int32_t> m_last_range_ends;
-    GCSFilter::ElementSet m_filter_set;
+//! Workers preparing blocks ahead of the wallet update, shared by all rescans and started on first use
+ThreadPool& GetRescanThreadPool()
+{
+    static ThreadPool thread_pool{"walletscan"};
+    static std::once_flag started;
+    std::call_once(started, [] { thread_pool.Start(std::clamp(GetNumCores(), 1, MAX_RESCAN_WORKERS)); });
+    return thread_pool;
+}
+
+/** Block prepared by a rescan worker for the in-order wallet update. */
+struct RescanBlock {
+    //! Scripts the block was matched against, nullptr for legacy wallets
+    std::shared_ptr<const RescanScriptSnapshot> snapshot;
+    //! Whether the block filter matched the scripts, unset if the filter was not checked or not found
+    std::optional<bool> filter_match;
+    //! Block data, null if the block was skipped because of its filter or could not be read
+    CBlock block;
+    //! For each transaction of the block, whether one of its outputs pays to a script of the snapshot
+    std::vector<bool> pays_to_wallet;
+};
 
-    void AddScriptPubKeys(const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
-    {
-        for (const auto& script_pub_key : desc_spkm->GetScriptPubKeys(last_range_end)) {
-            m_filter_set.emplace(script_pub_key.begin(), script_pub_key.end());
+RescanBlock PrepareRescanBlock(interfaces::Chain& chain, const uint256& block_hash, std::shared_ptr<const RescanScriptSnapshot> snapshot, bool use_block_filter)
+{
+    RescanBlock result;
+    if (use_block_filter) {
+        result.filter_match = false;
+        for (const RescanScriptSnapshot* layer{snapshot.get()}; layer && result.filter_match == false; layer = layer->base.get()) {
+            result.filter_match = chain.blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, layer->filter_set);
         }
     }
-};
+    if (result.filter_match != false) {
+        chain.findBlock(block_hash, FoundBlock().data(result.block));
+        if (snapshot) {
+            result.pays_to_wallet.reserve(result.block.vtx.size());
+            for (const CTransactionRef& tx : result.block.vtx) {
+                result.pays_to_wallet.push_back(std::any_of(tx->vout.begin(), tx->vout.end(), [&](const CTxOut& txout) {
+                    return snapshot->Contains(txout.scriptPubKey);
+                }));
+            }
+        }
+    }
+    result.snapshot = std::move(snapshot);
+    return result;
+}
 } // namespace
 
 std::shared_ptr<CWallet> LoadWallet(WalletContext& context, const std::string& name, std::optional<bool> load_on_start, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error, std::vector<bilingual_str>& warnings)
@@ -781,6 +813,53 @@ bool CWallet::IsSpent(const COutPoint& outpoint) const
     return false;
 }
 
+void CWallet::RefreshUnspentTXO(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+    const auto wit{mapWallet.find(outpoint.hash)};
+    const bool unspent{wit != mapWallet.end() && outpoint.n < wit->second.tx->vout.size() &&
+                       IsMine(wit->second.tx->vout[outpoint.n]) != ISMINE_NO && !IsSpent(outpoint)};
+
+    auto it{m_unspent_txos.find(outpoint.hash)};
+    if (it == m_unspent_txos.end()) {
+        if (unspent) m_unspent_txos.emplace(outpoint.hash, std::vector<uint32_t>{outpoint.n});
+        return;
+    }
+    std::vector<uint32_t>& outputs{it->second};
+    const auto pos{std::lower_bound(outputs.begin(), outputs.end(), outpoint.n)};
+    const bool tracked{pos != outputs.end() && *pos == outpoint.n};
+    if (unspent && !tracked) {
+        outputs.insert(pos, outpoint.n);
+    } else if (!unspent && tracked) {
+        outputs.erase(pos);
+        if (outputs.empty()) m_unspent_txos.erase(it);
+    }
+}
+
+void CWallet::RefreshUnspentTXOs(const CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+    for (uint32_t i = 0; i < wtx.tx->vout.size(); ++i) {
+        RefreshUnspentTXO(COutPoint{wtx.GetHash(), i});
+    }
+    for (const CTxIn& txin : wtx.tx->vin) {
+        RefreshUnspentTXO(txin.prevout);
+    }
+}
+
+void CWallet::RefreshAllUnspentTXOs()
+{
+    AssertLockHeld(cs_wallet);
+    m_unspent_txos.clear();
+    for (const auto& [txid, wtx] : mapWallet) {
+        std::vector<uint32_t> outputs;
+        for (uint32_t i = 0; i < wtx.tx->vout.size(); ++i) {
+            if (IsMine(wtx.tx->vout[i]) != ISMINE_NO && !IsSpent(COutPoint{wtx.GetHash(), i})) outputs.push_back(i);
+        }
+        if (!outputs.empty()) m_unspent_txos.emplace(txid, std::move(outputs));
+    }
+}
+
 void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid, WalletBatch* batch)
 {
     mapTxSpends.insert(std::make_pair(outpoint, wtxid));
@@ -1015,7 +1094,7 @@ bool CWallet::MarkReplaced(const uint256& originalHash, const uint256& newHash)
         success = false;
     }
 
-    NotifyTransactionChanged(originalHash, CT_UPDATED);
+    NotifyTxChanged(originalHash, CT_UPDATED);
 
     return success;
 }
@@ -1069,11 +1148,12 @@ bool CWallet::IsSpentKey(const CScript& scriptPubKey) const
     return false;
 }
 
-CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const UpdateWalletTxFn& update_wtx, bool fFlushOnClose, bool rescanning_old_block)
+CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const UpdateWalletTxFn& update_wtx, bool fFlushOnClose, bool rescanning_old_block, WalletBatch* batch)
 {
     LOCK(cs_wallet);
 
-    WalletBatch batch(GetDatabase(), fFlushOnClose);
+    std::optional<WalletBatch> own_batch;
+    if (!batch) batch = &own_batch.emplace(GetDatabase(), fFlushOnClose);
 
     uint256 hash = tx->GetHash();
 
@@ -1083,7 +1163,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
 
         for (const CTxIn& txin : tx->vin) {
             const COutPoint& op = txin.prevout;
-            SetSpentKeyState(batch, op.hash, op.n, true, tx_destinations);
+            SetSpentKeyState(*batch, op.hash, op.n, true, tx_destinations);
         }
 
         MarkDestinationsDirty(tx_destinations);
@@ -1096,10 +1176,10 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
     bool fUpdated = update_wtx && update_wtx(wtx, fInsertedNew);
     if (fInsertedNew) {
         wtx.nTimeReceived = GetTime();
-        wtx.nOrderPos = IncOrderPosNext(&batch);
+        wtx.nOrderPos = IncOrderPosNext(batch);
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
         wtx.nTimeSmart = ComputeTimeSmart(wtx, rescanning_old_block);
-        AddToSpends(wtx, &batch);
+        AddToSpends(wtx, batch);
 
         // Update birth time when tx time is older than it.
         MaybeUpdateBirthTime(wtx.GetTxTime());
@@ -1137,7 +1217,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
             desc_tx->m_state = inactive_state;
             // Break caches since we have changed the state
             desc_tx->MarkDirty();
-            batch.WriteTx(*desc_tx);
+            batch->WriteTx(*desc_tx);
             MarkInputsDirty(desc_tx->tx);
             for (unsigned int i = 0; i < desc_tx->tx->vout.size(); ++i) {
                 COutPoint outpoint(desc_tx->GetHash(), i);
@@ -1152,19 +1232,21 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
         }
     }
 
+    RefreshUnspentTXOs(wtx);
+
     //// debug print
     WalletLogPrintf("AddToWallet %s  %s%s %s\n", hash.ToString(), (fInsertedNew ? "new" : ""), (fUpdated ? "update" : ""), TxStateString(state));
 
     // Write to disk
     if (fInsertedNew || fUpdated)
-        if (!batch.WriteTx(wtx))
+        if (!batch->WriteTx(wtx))
             return nullptr;
 
     // Break debit/credit balance caches:
     wtx.MarkDirty();
 
     // Notify UI of new or updated transaction
-    NotifyTransactionChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
+    NotifyTxChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
 
 #if HAVE_SYSTEM
     // notify an external script when a wallet transaction comes in or is updated
@@ -1229,7 +1311,7 @@ bool CWallet::LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx
     return true;
 }
 
-bool CWallet::AddToWalletIfInvolvingMe(const CTransactionRef& ptx, const SyncTxState& state, bool fUpdate, bool rescanning_old_block)
+bool CWallet::AddToWalletIfInvolvingMe(const CTransactionRef& ptx, const SyncTxState& state, bool fUpdate, bool rescanning_old_block, WalletBatch* batch)
 {
     const CTransaction& tx = *ptx;
     {
@@ -1241,7 +1323,7 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransactionRef& ptx, const SyncTxS
                 while (range.first != range.second) {
                     if (range.first->second != tx.GetHash()) {
                         WalletLogPrintf("Transaction %s (in block %s) conflicts with wallet transaction %s (both spend %s:%i)\n", tx.GetHash().ToString(), conf->confirmed_block_hash.ToString(), range.first->second.ToString(), range.first->first.hash.ToString(), range.first->first.n);
-                        MarkConflicted(conf->confirmed_block_hash, conf->confirmed_block_height, range.first->second);
+                        MarkConflicted(conf->confirmed_block_hash, conf->confirmed_block_height, range.first->second, batch);
                     }
                     range.first++;
                 }
@@ -1283,7 +1365,7 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransactionRef& ptx, const SyncTxS
             // Block disconnection override an abandoned tx as unconfirmed
             // which means user may have to call abandontransaction again
             TxState tx_state = std::visit([](auto&& s) -> TxState { return s; }, state);
-            CWalletTx* wtx = AddToWallet(MakeTransactionRef(tx), tx_state, /*update_wtx=*/nullptr, /*fFlushOnClose=*/false, rescanning_old_block);
+            CWalletTx* wtx = AddToWallet(MakeTransactionRef(tx), tx_state, /*update_wtx=*/nullptr, /*fFlushOnClose=*/false, rescanning_old_block, batch);
             if (!wtx) {
                 // Can only be nullptr if there was a db write error (missing db, read-only db or a db engine internal writing error).
                 // As we only store arriving transaction in this process, and we don't want an inconsistent state, let's throw an error.
@@ -1308,6 +1390,7 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
+            RefreshUnspentTXO(txin.prevout);
         }
     }
 }
@@ -1350,7 +1433,7 @@ bool CWallet::AbandonTransaction(CWalletTx& tx)
     return true;
 }
 
-void CWallet::MarkConflicted(const uint256& hashBlock, int conflicting_height, const uint256& hashTx)
+void CWallet::MarkConflicted(const uint256& hashBlock, int conflicting_height, const uint256& hashTx, WalletBatch* batch)
 {
     LOCK(cs_wallet);
 
@@ -1376,7 +1459,11 @@ void CWallet::MarkConflicted(const uint256& hashBlock, int conflicting_height, c
     };
 
     // Iterate over all its outputs, and mark transactions in the wallet that spend them conflicted too.
-    RecursiveUpdateTxState(hashTx, try_updating_state);
+    if (batch) {
+        RecursiveUpdateTxState(batch, hashTx, try_updating_state);
+    } else {
+        RecursiveUpdateTxState(hashTx, try_updating_state);
+    }
 
 }
 
@@ -1415,7 +1502,7 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const uint256& tx_hash,
             }
 
             if (update_state == TxUpdate::NOTIFY_CHANGED) {
-                NotifyTransactionChanged(wtx.GetHash(), CT_UPDATED);
+                NotifyTxChanged(wtx.GetHash(), CT_UPDATED);
             }
 
             // If a transaction changes its tx state, that usually changes the balance
@@ -1425,9 +1512,53 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const uint256& tx_hash,
     }
 }
 
-void CWallet::SyncTransaction(const CTransactionRef& ptx, const SyncTxState& state, bool update_tx, bool rescanning_old_block)
+void CWallet::NotifyTxChanged(const uint256& hash, ChangeType status)
 {
-    if (!AddToWalletIfInvolvingMe(ptx, state, update_tx, rescanning_old_block))
+    AssertLockHeld(cs_wallet);
+    if (m_pending_tx_changes) {
+        m_pending_tx_changes->emplace_back(hash, status);
+        return;
+    }
+    NotifyTransactionChanged(hash, status);
+    NotifyTransactionsChanged({{hash, status}});
+}
+
+CWallet::TxNotificationBatch::TxNotificationBatch(CWallet& wallet)
+    : m_wallet{wallet}, m_outermost{!wallet.m_pending_tx_changes}
+{
+    AssertLockHeld(m_wallet.cs_wallet);
+    if (m_outermost) m_wallet.m_pending_tx_changes.emplace();
+}
+
+CWallet::TxNotificationBatch::~TxNotificationBatch()
+{
+    AssertLockHeld(m_wallet.cs_wallet);
+    if (!m_outermost) return;
+    const std::vector<std::pair<uint256, ChangeType>> pending{std::move(*m_wallet.m_pending_tx_changes)};
+    m_wallet.m_pending_tx_changes.reset();
+
+    // Notify once per transaction, in the order of the first change. A transaction
+    // stays new if it is updated afterwards, but its removal overrides any change.
+    std::vector<std::pair<uint256, ChangeType>> changes;
+    std::unordered_map<uint256, size_t, SaltedTxidHasher> change_index;
+    for (const auto& [hash, status] : pending) {
+        const auto [it, inserted] = change_index.try_emplace(hash, changes.size());
+        if (inserted) {
+            changes.emplace_back(hash, status);
+        } else if (status == CT_DELETED) {
+            changes[it->second].second = CT_DELETED;
+        }
+    }
+    if (changes.empty()) return;
+    for (const auto& [hash, status] : changes) {
+        m_wallet.NotifyTransactionChanged(hash, status);
+    }
+    m_wallet.NotifyTransactionsChanged(changes);
+}
+
+void CWallet::SyncTransaction(const CTransactionRef& ptx, const SyncTxState& state, bool update_tx, bool rescanning_old_block, WalletBatch* batch)
+{
+    if (!AddToWalletIfInvolvingMe(ptx, state, update_tx, rescanning_old_block, batch))
         return; // Not one of ours
 
     // If a transaction changes 'conflicted' state, that changes the balance
@@ -1527,11 +1658,16 @@ void CWallet::blockConnected(ChainstateRole role, const interfaces::BlockInfo& b
     // Uses chain max time and twice the grace period to adjust time for block time variability.
     if (block.chain_time_max < m_birth_time.load() - (TIMESTAMP_WINDOW * 2)) return;
 
-    // Scan block
+    // Scan block through a single batch, committing the resulting writes together,
+    // and notify about the changed transactions once they are committed
+    TxNotificationBatch notifications{*this};
+    DatabaseGroupCommit group_commit{GetDatabase()};
+    WalletBatch batch{GetDatabase(), /*_fFlushOnClose=*/false};
     for (size_t index = 0; index < block.data->vtx.size(); index++) {
-        SyncTransaction(block.data->vtx[index], TxStateConfirmed{block.hash, block.height, static_cast<int>(index)});
+        SyncTransaction(block.data->vtx[index], TxStateConfirmed{block.hash, block.height, static_cast<int>(index)}, /*update_tx=*/true, /*rescanning_old_block=*/false, &batch);
         transactionRemovedFromMempool(block.data->vtx[index], MemPoolRemovalReason::BLOCK);
     }
+    if (!group_commit.Commit()) throw std::runtime_error("DB error committing the wallet writes of a connected block");
 }
 
 void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
@@ -1548,11 +1684,14 @@ void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
 
     int disconnect_height = block.height;
 
+    TxNotificationBatch notifications{*this};
+    DatabaseGroupCommit group_commit{GetDatabase()};
+    WalletBatch batch{GetDatabase(), /*_fFlushOnClose=*/false};
     for (size_t index = 0; index < block.data->vtx.size(); index++) {
         const CTransactionRef& ptx = Assert(block.data)->vtx[index];
         // Coinbase transactions are not only inactive but also abandoned,
         // meaning they should never be relayed standalone via the p2p protocol.
-        SyncTransaction(ptx, TxStateInactive{/*abandoned=*/index == 0});
+        SyncTransaction(ptx, TxStateInactive{/*abandoned=*/index == 0}, /*update_tx=*/true, /*rescanning_old_block=*/false, &batch);
 
         for (const CTxIn& tx_in : ptx->vin) {
             // No other wallet transactions conflicted with this transaction
@@ -1575,10 +1714,11 @@ void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
                     return TxUpdate::UNCHANGED;
                 };
 
-                RecursiveUpdateTxState(wtx.tx->GetHash(), try_updating_state);
+                RecursiveUpdateTxState(&batch, wtx.tx->GetHash(), try_updating_state);
             }
         }
     }
+    if (!group_commit.Commit()) throw std::runtime_error("DB error committing the wallet writes of a disconnected block");
 }
 
 void CWallet::updatedBlockTip()
@@ -1631,14 +1771,16 @@ isminetype CWallet::IsMine(const CScript& script) const
     AssertLockHeld(cs_wallet);
 
     // Search the cache so that IsMine is called only on the relevant SPKMs instead of on everything in m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
-        isminetype res = ISMINE_NO;
-        for (const auto& spkm : it->second) {
-            res = std::max(res, spkm->IsMine(script));
+    if (m_cached_spks_filter.MayContain(script)) {
+        const auto& it = m_cached_spks.find(script);
+        if (it != m_cached_spks.end()) {
+            isminetype res = ISMINE_NO;
+            for (const auto& spkm : it->second) {
+                res = std::max(res, spkm->IsMine(script));
+            }
+            Assume(res == ISMINE_SPENDABLE);
+            return res;
         }
-        Assume(res == ISMINE_SPENDABLE);
-        return res;
     }
 
     // Legacy wallet
@@ -1785,7 +1927,12 @@ bool CWallet::ImportScripts(const std::set<CScript> scripts, int64_t timestamp)
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportScripts(scripts, timestamp);
+    if (!spk_man->ImportScripts(scripts, timestamp)) {
+        return false;
+    }
+    // Outputs of wallet transactions may have become ours
+    WITH_LOCK(cs_wallet, RefreshAllUnspentTXOs());
+    return true;
 }
 
 bool CWallet::ImportPrivKeys(const std::map<CKeyID, CKey>& privkey_map, const int64_t timestamp)
@@ -1795,7 +1942,12 @@ bool CWallet::ImportPrivKeys(const std::map<CKeyID, CKey>& privkey_map, const in
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportPrivKeys(privkey_map, timestamp);
+    if (!spk_man->ImportPrivKeys(privkey_map, timestamp)) {
+        return false;
+    }
+    // Outputs of wallet transactions may have become ours
+    WITH_LOCK(cs_wallet, RefreshAllUnspentTXOs());
+    return true;
 }
 
 bool CWallet::ImportPubKeys(const std::vector<std::pair<CKeyID, bool>>& ordered_pubkeys, const std::map<CKeyID, CPubKey>& pubkey_map, const std::map<CKeyID, std::pair<CPubKey, KeyOriginInfo>>& key_origins, const bool add_keypool, const int64_t timestamp)
@@ -1805,7 +1957,12 @@ bool CWallet::ImportPubKeys(const std::vector<std::pair<CKeyID, bool>>& ordered_
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportPubKeys(ordered_pubkeys, pubkey_map, key_origins, add_keypool, timestamp);
+    if (!spk_man->ImportPubKeys(ordered_pubkeys, pubkey_map, key_origins, add_keypool, timestamp)) {
+        return false;
+    }
+    // Outputs of wallet transactions may have become ours
+    WITH_LOCK(cs_wallet, RefreshAllUnspentTXOs());
+    return true;
 }
 
 bool CWallet::ImportScriptPubKeys(const std::string& label, const std::set<CScript>& script_pub_keys, const bool have_solving_data, const bool apply_label, const int64_t timestamp)
@@ -1828,6 +1985,7 @@ bool CWallet::ImportScriptPubKeys(const std::string& label, const std::set<CScri
             }
         }
     }
+    WITH_LOCK(cs_wallet, RefreshAllUnspentTXOs());
     return true;
 }
 
@@ -1890,6 +2048,8 @@ int64_t CWallet::RescanFromTime(int64_t startTime, const WalletRescanReserver& r
  * @pre Caller needs to make sure start_block (and the optional stop_block) are on
  * the main chain after to the addition of any new keys you want to detect
  * transactions for.
+ * @pre Caller must not hold the chain's cs_main, which the workers reading the
+ * blocks ahead need.
  */
 CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_block, int start_height, std::optional<int> max_height, const WalletRescanReserver& reserver, bool fUpdate, const bool save_progress)
 {
@@ -1902,11 +2062,67 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     uint256 block_hash = start_block;
     ScanResult result;
 
-    std::unique_ptr<FastWalletRescanFilter> fast_rescan_filter;
-    if (!IsLegacy() && chain().hasBlockFilterIndex(BlockFilterType::BASIC)) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this);
+    // Block filters can only be matched against the scripts of descriptor wallets
+    const bool use_block_filter{!IsLegacy() && chain().hasBlockFilterIndex(BlockFilterType::BASIC)};
 
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
-                    fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
+                    use_block_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
+
+    // Blocks are matched against the block filter, read, and checked for outputs
+    // paying to the wallet by a pool of workers ahead of the in-order wallet update
+    // below. The workers don't take cs_wallet, they match against a snapshot of
+    // the wallet's scripts, which is retaken whenever scripts were added since.
+    std::shared_ptr<const RescanScriptSnapshot> script_snapshot;
+    const auto get_script_snapshot{[&]() -> std::shared_ptr<const RescanScriptSnapshot> {
+        if (IsLegacy()) return nullptr;
+        LOCK(cs_wallet);
+        if (!script_snapshot) {
+            auto snapshot{std::make_shared<RescanScriptSnapshot>()};
+            snapshot->num_scripts = m_cached_spks.size();
+            snapshot->scripts.reserve(m_cached_spks.size());
+            for (const auto& [script, spkms] : m_cached_spks) {
+                snapshot->Add(script, use_block_filter);
+            }
+            script_snapshot = std::move(snapshot);
+            // Collect the scripts added from now on, to extend the snapshot with
+            m_rescan_new_spks.emplace();
+        } else if (script_snapshot->num_scripts != m_cached_spks.size()) {
+            auto snapshot{std::make_shared<RescanScriptSnapshot>()};
+            snapshot->num_scripts = m_cached_spks.size();
+            for (const CScript& script : *m_rescan_new_spks) {
+                if (!script_snapshot->Contains(script)) snapshot->Add(script, use_block_filter);
+            }
+            m_rescan_new_spks->clear();
+            snapshot->base = script_snapshot;
+            while (snapshot->base && snapshot->base->scripts.size() <= snapshot->scripts.size()) {
+                for (const CScript& script : snapshot->base->scripts) {
+                    snapshot->Add(script, use_block_filter);
+                }
+                snapshot->base = snapshot->base->base;
+            }
+            script_snapshot = std::move(snapshot);
+        }
+        return script_snapshot;
+    }};
+    const auto is_snapshot_current{[&](const RescanBlock& prepared) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+        return prepared.snapshot && prepared.snapshot->num_scripts == m_cached_spks.size();
+    }};
+    // Transactions without outputs paying to the wallet can only involve it if
+    // they spend from or conflict with wallet transactions, or are known already.
+    const auto may_involve_wallet{[&](const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+        if (mapWallet.count(tx.GetHash())) return true;
+        return std::any_of(tx.vin.begin(), tx.vin.end(), [&](const CTxIn& txin) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+            return mapWallet.count(txin.prevout.hash) > 0 || mapTxSpends.count(txin.prevout) > 0;
+        });
+    }};
+
+    ThreadPool& thread_pool{GetRescanThreadPool()};
+    std::deque<std::pair<uint256, std::future<RescanBlock>>> pending_blocks;
+    const auto submit_block{[&](const uint256& hash) {
+        pending_blocks.emplace_back(hash, thread_pool.Submit([&scan_chain = chain(), hash, snapshot = get_script_snapshot(), use_block_filter] {
+            return PrepareRescanBlock(scan_chain, hash, snapshot, use_block_filter);
+        }));
+    }};
 
     fAbortRescan = false;
     ShowProgress(strprintf("%s %s", GetDisplayName(), _("Rescanning…")), 0); // show rescan progress in GUI as dialog or on splashscreen, if rescan required on startup (e.g. due to corruption)
@@ -1933,12 +2149,32 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             WalletLogPrintf("Still rescanning. At block %d. Progress=%f\n", block_height, progress_current);
         }
 
+        // Keep the workers busy with the blocks following this one. The blocks
+        // prepared ahead are dropped if a reorg replaced them in the meantime.
+        if (pending_blocks.empty() || pending_blocks.front().first != block_hash) {
+            pending_blocks.clear();
+            submit_block(block_hash);
+        }
+        const int last_height{WITH_LOCK(cs_wallet, return GetLastBlockHeight())};
+        for (int height{block_height + static_cast<int>(pending_blocks.size()) - 1};
+             pending_blocks.size() < RESCAN_LOOKAHEAD_BLOCKS && height < last_height && (!max_height || height < *max_height); ++height) {
+            bool has_next{false};
+            uint256 next_hash;
+            chain().findBlock(pending_blocks.back().first, FoundBlock().nextBlock(FoundBlock().inActiveChain(has_next).hash(next_hash)));
+            if (!has_next) break;
+            submit_block(next_hash);
+        }
+        RescanBlock prepared{pending_blocks.front().second.get()};
+        pending_blocks.pop_front();
+
         bool fetch_block{true};
-        if (fast_rescan_filter) {
-            fast_rescan_filter->UpdateIfNeeded();
-            auto matches_block{fast_rescan_filter->MatchesBlock(block_hash)};
-            if (matches_block.has_value()) {
-                if (*matches_block) {
+        if (use_block_filter) {
+            if (prepared.filter_match == false && !WITH_LOCK(cs_wallet, return is_snapshot_current(prepared))) {
+                // Scripts were added to the wallet since the block was matched, match it again
+                prepared = PrepareRescanBlock(chain(), block_hash, get_script_snapshot(), use_block_filter);
+            }
+            if (prepared.filter_match.has_value()) {
+                if (*prepared.filter_match) {
                     LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (filter matched)\n", block_height, block_hash.ToString());
                 } else {
                     result.last_scanned_block = block_hash;
@@ -1958,10 +2194,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         chain().findBlock(block_hash, FoundBlock().inActiveChain(block_still_active).nextBlock(FoundBlock().inActiveChain(next_block).hash(next_block_hash)));
 
         if (fetch_block) {
-            // Read block data
-            CBlock block;
-            chain().findBlock(block_hash, FoundBlock().data(block));
-
+            const CBlock& block{prepared.block};
             if (!block.IsNull()) {
                 LOCK(cs_wallet);
                 if (!block_still_active) {
@@ -1971,8 +2204,16 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                     result.status = ScanResult::FAILURE;
                     break;
                 }
+                // Commit the writes for this block, including the scan progress, together
+                // and notify about the changed transactions once they are committed
+                TxNotificationBatch notifications{*this};
+                DatabaseGroupCommit group_commit{GetDatabase()};
+                WalletBatch block_batch{GetDatabase(), /*_fFlushOnClose=*/false};
                 for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true);
+                    // The workers' check for outputs paying to the wallet can only be relied
+                    // on while no scripts were added, which syncing a transaction may do.
+                    if (is_snapshot_current(prepared) && !prepared.pays_to_wallet[posInBlock] && !may_involve_wallet(*block.vtx[posInBlock])) continue;
+                    SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true, &block_batch);
                 }
                 // scan succeeded, record block as most recent successfully scanned
                 result.last_scanned_block = block_hash;
@@ -1987,6 +2228,12 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                         batch.WriteBestBlock(loc);
                     }
                 }
+                if (!group_commit.Commit()) {
+                    // The block's writes were rolled back, so it has to be scanned again
+                    WalletLogPrintf("Failed to commit the wallet writes of block %s\n", block_hash.ToString());
+                    result.last_failed_block = block_hash;
+                    result.status = ScanResult::FAILURE;
+                }
             } else {
                 // could not scan block, keep scanning but record this block as the most recent failure
                 result.last_failed_block = block_hash;
@@ -2039,6 +2286,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     } else {
         WalletLogPrintf("Rescan completed in %15dms\n", Ticks<std::chrono::milliseconds>(reserver.now() - start_time));
     }
+    WITH_LOCK(cs_wallet, m_rescan_new_spks.reset());
     return result;
 }
 
@@ -2365,7 +2613,7 @@ void CWallet::CommitTransaction(CTransactionRef tx, mapValue_t mapValue, std::ve
     for (const CTxIn& txin : tx->vin) {
         CWalletTx &coin = mapWallet.at(txin.prevout.hash);
         coin.MarkDirty();
-        NotifyTransactionChanged(coin.GetHash(), CT_UPDATED);
+        NotifyTxChanged(coin.GetHash(), CT_UPDATED);
     }
 
     if (!fBroadcastTransactions) {
@@ -2387,6 +2635,7 @@ DBErrors CWallet::LoadWallet()
     Assert(m_spk_managers.empty());
     Assert(m_wallet_flags == 0);
     DBErrors nLoadWalletRet = WalletBatch(GetDatabase()).LoadWallet(this);
+    RefreshAllUnspentTXOs();
     if (nLoadWalletRet == DBErrors::NEED_REWRITE)
     {
         if (GetDatabase().Rewrite("\x04pool"))
@@ -2448,8 +2697,10 @@ util::Result<void> CWallet::RemoveTxs(WalletBatch& batch, std::vector<uint256>&
             for (const auto& txin : it->second.tx->vin)
                 mapTxSpends.erase(txin.prevout);
             mapWallet.erase(it);
-            NotifyTransactionChanged(hash, CT_DELETED);
+            NotifyTxChanged(hash, CT_DELETED);
         }
+        // Outputs spent by the removed transactions may be unspent again
+        RefreshAllUnspentTXOs();
 
         MarkDirty();
     }, .on_abort={}});
@@ -3957,6 +4208,7 @@ ScriptPubKeyMan* CWallet::AddWalletDescriptor(WalletDescriptor& desc, const Flat
     if (spk_man) {
         WalletLogPrintf("Update existing descriptor: %s\n", desc.descriptor->ToString());
         spk_man->UpdateWalletDescriptor(desc);
+        m_script_spend_info.clear();
     } else {
         auto new_spk_man = std::unique_ptr<DescriptorScriptPubKeyMan>(new DescriptorScriptPubKeyMan(*this, desc, m_keypool_size));
         spk_man = new_spk_man.get();
@@ -4000,6 +4252,9 @@ ScriptPubKeyMan* CWallet::AddWalletDescriptor(WalletDescriptor& desc, const Flat
     // Save the descriptor to DB
     spk_man->WriteDescriptor();
 
+    // Outputs of wallet transactions may have become ours
+    RefreshAllUnspentTXOs();
+
     return spk_man;
 }
 
@@ -4289,6 +4544,12 @@ util::Result<void> CWallet::ApplyMigrationData(WalletBatch& local_wallet_batch,
         }
     }
 
+    // The wallets' scripts and transactions changed
+    RefreshAllUnspentTXOs();
+    for (const auto& [wallet, _batch] : wallets_vec) {
+        WITH_LOCK(wallet->cs_wallet, wallet->RefreshAllUnspentTXOs());
+    }
+
     return {}; // all good
 }
 
@@ -4631,7 +4892,37 @@ void CWallet::CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyM
 {
     for (const auto& script : spks) {
         m_cached_spks[script].push_back(spkm);
+        if (m_rescan_new_spks) m_rescan_new_spks->push_back(script);
+        // The script may now be solvable through spkm
+        m_script_spend_info.erase(script);
     }
+    if (m_cached_spks.size() > m_cached_spks_filter.Capacity()) {
+        // Grow the filter geometrically so that rebuilding it stays amortized constant time per script
+        m_cached_spks_filter.Reset(std::max(m_cached_spks.size(), 2 * m_cached_spks_filter.Capacity()));
+        for (const auto& [script, _] : m_cached_spks) {
+            m_cached_spks_filter.Insert(script);
+        }
+    } else {
+        for (const auto& script : spks) {
+            m_cached_spks_filter.Insert(script);
+        }
+    }
+}
+
+std::optional<ScriptSpendInfo> CWallet::GetCachedScriptSpendInfo(const CScript& script, bool use_max_sig) const
+{
+    AssertLockHeld(cs_wallet);
+    if (!IsWalletFlagSet(WALLET_FLAG_DESCRIPTORS)) return std::nullopt;
+    const auto it = m_script_spend_info.find(script);
+    if (it == m_script_spend_info.end()) return std::nullopt;
+    return it->second[use_max_sig];
+}
+
+void CWallet::CacheScriptSpendInfo(const CScript& script, bool use_max_sig, const ScriptSpendInfo& info) const
+{
+    AssertLockHeld(cs_wallet);
+    if (!IsWalletFlagSet(WALLET_FLAG_DESCRIPTORS)) return;
+    m_script_spend_info[script][use_max_sig] = info;
 }
 
 void CWallet::TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
@@ -29,11 +29,13 @@
 #include <util/ui_change_type.h>
 #include <wallet/crypter.h>
 #include <wallet/db.h>
+#include <wallet/scriptfilter.h>
 #include <wallet/scriptpubkeyman.h>
 #include <wallet/transaction.h>
 #include <wallet/types.h>
 #include <wallet/walletutil.h>
 
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
@@ -292,6 +294,15 @@ struct CRecipient
     bool fSubtractFeeFromAmount;
 };
 
+/** Information needed to list a coin of a wallet script for coin selection, which only depends on the script */
+struct ScriptSpendInfo
+{
+    //! Maximum size of a signed input spending the script, -1 if the script is not solvable
+    int input_bytes;
+    //! Output type the coins of the script are grouped by, std::nullopt if the redeem script of a P2SH script is unknown
+    std::optional<OutputType> output_type;
+};
+
 class WalletRescanReserver; //forward declarations for ScanForWalletTransactions/RescanFromTime
 /**
  * A CWallet maintains a set of transactions and balances, and provides the ability to create new transactions.
@@ -352,10 +363,10 @@ private:
      * Should be called with rescanning_old_block set to true, if the transaction is
      * not discovered in real time, but during a rescan of old blocks.
      */
-    bool AddToWalletIfInvolvingMe(const CTransactionRef& tx, const SyncTxState& state, bool fUpdate, bool rescanning_old_block) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    bool AddToWalletIfInvolvingMe(const CTransactionRef& tx, const SyncTxState& state, bool fUpdate, bool rescanning_old_block, WalletBatch* batch = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /** Mark a transaction (and its in-wallet descendants) as conflicting with a particular block. */
-    void MarkConflicted(const uint256& hashBlock, int conflicting_height, const uint256& hashTx);
+    void MarkConflicted(const uint256& hashBlock, int conflicting_height, const uint256& hashTx, WalletBatch* batch = nullptr);
 
     enum class TxUpdate { UNCHANGED, CHANGED, NOTIFY_CHANGED };
 
@@ -368,9 +379,29 @@ private:
     /** Mark a transaction's inputs dirty, thus forcing the outputs to be recomputed */
     void MarkInputsDirty(const CTransactionRef& tx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /**
+     * Indices of the outputs of each wallet transaction that are ours and not
+     * spent by another wallet transaction. Transactions without such outputs
+     * have no entry, so balances and coin listings only visit the transactions
+     * that still hold coins of the wallet rather than all of mapWallet. Ordered
+     * by txid, so that they are visited in the same order on every run.
+     */
+    std::map<uint256, std::vector<uint32_t>> m_unspent_txos GUARDED_BY(cs_wallet);
+
+    /** Add or remove an output of a wallet transaction from m_unspent_txos, depending on whether it is currently ours and unspent */
+    void RefreshUnspentTXO(const COutPoint& outpoint) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Refresh the outputs of a wallet transaction and the wallet outputs it spends in m_unspent_txos */
+    void RefreshUnspentTXOs(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
-    void SyncTransaction(const CTransactionRef& tx, const SyncTxState& state, bool update_tx = true, bool rescanning_old_block = false) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void SyncTransaction(const CTransactionRef& tx, const SyncTxState& state, bool update_tx = true, bool rescanning_old_block = false, WalletBatch* batch = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /** Transaction changes not notified yet because a TxNotificationBatch is in scope */
+    std::optional<std::vector<std::pair<uint256, ChangeType>>> m_pending_tx_changes GUARDED_BY(cs_wallet);
+
+    /** Notify about a changed wallet transaction, or defer the notification while a TxNotificationBatch is in scope */
+    void NotifyTxChanged(const uint256& hash, ChangeType status) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /** WalletFlags set on this wallet. */
     std::atomic<uint64_t> m_wallet_flags{0};
@@ -427,6 +458,12 @@ private:
 
     //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to set of spkms
     std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> m_cached_spks;
+    //! Approximate set of the scripts in m_cached_spks, checked first so most scripts that are not ours skip the map lookup
+    ScriptPubKeyFilter m_cached_spks_filter;
+    //! Scripts added to m_cached_spks during a rescan, which extends its script snapshot with them. Unset while no rescan collects them.
+    std::optional<std::vector<CScript>> m_rescan_new_spks;
+    //! Spend info of wallet scripts computed by AvailableCoins, indexed by whether maximum size signatures are assumed
+    mutable std::unordered_map<CScript, std::array<std::optional<ScriptSpendInfo>, 2>, SaltedSipHasher> m_script_spend_info;
 
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
@@ -535,6 +572,22 @@ public:
 
     bool IsSpent(const COutPoint& outpoint) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /** Wallet transactions with outputs that are ours and unspent, with the indices of these outputs */
+    const std::map<uint256, std::vector<uint32_t>>& GetUnspentTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet)
+    {
+        AssertLockHeld(cs_wallet);
+        return m_unspent_txos;
+    }
+    /** Rebuild the set of unspent outputs from all wallet transactions, e.g. after scripts were imported */
+    void RefreshAllUnspentTXOs() EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /**
+     * Return the cached spend info of a wallet script, if any. Only descriptor wallets cache spend info,
+     * as the scripts of legacy wallets can become solvable without going through CacheNewScriptPubKeys().
+     */
+    std::optional<ScriptSpendInfo> GetCachedScriptSpendInfo(const CScript& script, bool use_max_sig) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void CacheScriptSpendInfo(const CScript& script, bool use_max_sig, const ScriptSpendInfo& info) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     // Whether this or any known scriptPubKey with the same single key has been spent.
     bool IsSpentKey(const CScript& scriptPubKey) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void SetSpentKeyState(WalletBatch& batch, const uint256& hash, unsigned int n, bool used, std::set<CTxDestination>& tx_destinations) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -605,9 +658,10 @@ public:
 
     /**
      * Add the transaction to the wallet, wrapping it up inside a CWalletTx
+     * Writes to the given batch if there is one, otherwise to a new batch.
      * @return the recently added wtx pointer or nullptr if there was a db write error.
      */
-    CWalletTx* AddToWallet(CTransactionRef tx, const TxState& state, const UpdateWalletTxFn& update_wtx=nullptr, bool fFlushOnClose=true, bool rescanning_old_block = false);
+    CWalletTx* AddToWallet(CTransactionRef tx, const TxState& state, const UpdateWalletTxFn& update_wtx=nullptr, bool fFlushOnClose=true, bool rescanning_old_block = false, WalletBatch* batch = nullptr);
     bool LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void transactionAddedToMempool(const CTransactionRef& tx) override;
     void blockConnected(ChainstateRole role, const interfaces::BlockInfo& block) override;
@@ -630,6 +684,10 @@ public:
         //! USER_ABORT.
         uint256 last_failed_block;
     };
+    /**
+     * Scan the chain for wallet transactions, see the definition for the parameters.
+     * Blocks are read ahead by worker threads, so the caller must not hold cs_main.
+     */
     ScanResult ScanForWalletTransactions(const uint256& start_block, int start_height, std::optional<int> max_height, const WalletRescanReserver& reserver, bool fUpdate, const bool save_progress);
     void transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason) override;
     /** Set the next time this wallet should resend transactions to 12-36 hours from now, ~1 day on average. */
@@ -846,6 +904,31 @@ public:
      */
     boost::signals2::signal<void(const uint256& hashTx, ChangeType status)> NotifyTransactionChanged;
 
+    /**
+     * Wallet transactions added, removed or updated together. Emitted after
+     * NotifyTransactionChanged for each of them, once for all the changes of a
+     * connected or disconnected block, and once per change otherwise.
+     * @note called with lock cs_wallet held.
+     */
+    boost::signals2::signal<void(const std::vector<std::pair<uint256, ChangeType>>& changes)> NotifyTransactionsChanged;
+
+    /**
+     * Defers the transaction notifications of the wallet while in scope, and
+     * sends them without duplicates when going out of scope. A batch created
+     * while another one is in scope joins it.
+     */
+    class TxNotificationBatch
+    {
+        CWallet& m_wallet;
+        const bool m_outermost;
+
+    public:
+        explicit TxNotificationBatch(CWallet& wallet) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet);
+        ~TxNotificationBatch();
+        TxNotificationBatch(const TxNotificationBatch&) = delete;
+        TxNotificationBatch& operator=(const TxNotificationBatch&) = delete;
+    };
+
     /** Show progress e.g. for rescan */
     boost::signals2::signal<void (const std::string &title, int nProgress)> ShowProgress;
 
@@ -16,6 +16,7 @@
 #include <util/bip32.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #ifdef USE_BDB
@@ -27,11 +28,22 @@
 #endif
 #include <wallet/wallet.h>
 
+#include <algorithm>
 #include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
 #include <optional>
 #include <string>
 
 namespace wallet {
+//! Maximum number of threads used to deserialize records and expand descriptor caches while loading a wallet
+static constexpr int MAX_WALLET_LOAD_WORKERS{4};
+//! Number of tx records read from the database before they are deserialized on the load thread pool
+static constexpr size_t TX_LOAD_BATCH_SIZE{4096};
+//! Number of tx records deserialized per load thread pool task
+static constexpr size_t TX_LOAD_CHUNK_SIZE{256};
+
 namespace DBKeys {
 const std::string ACENTRY{"acentry"};
 const std::string ACTIVEEXTERNALSPK{"activeexternalspk"};
@@ -799,7 +811,7 @@ static DataStream PrefixStream(const Args&... args)
     return prefix;
 }
 
-static DBErrors LoadDescriptorWalletRecords(CWallet* pwallet, DatabaseBatch& batch, int last_client) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
+static DBErrors LoadDescriptorWalletRecords(CWallet* pwallet, DatabaseBatch& batch, int last_client, ThreadPool& thread_pool) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
 {
     AssertLockHeld(pwallet->cs_wallet);
 
@@ -807,7 +819,7 @@ static DBErrors LoadDescriptorWalletRecords(CWallet* pwallet, DatabaseBatch& bat
     int num_keys = 0;
     int num_ckeys= 0;
     LoadResult desc_res = LoadRecords(pwallet, batch, DBKeys::WALLETDESCRIPTOR,
-        [&batch, &num_keys, &num_ckeys, &last_client] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& strErr) {
+        [&batch, &num_keys, &num_ckeys, &last_client, &thread_pool] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& strErr) {
         DBErrors result = DBErrors::LOAD_OK;
 
         uint256 id;
@@ -889,7 +901,7 @@ static DBErrors LoadDescriptorWalletRecords(CWallet* pwallet, DatabaseBatch& bat
         // Set the cache for this descriptor
         auto spk_man = (DescriptorScriptPubKeyMan*)pwallet->GetScriptPubKeyMan(id);
         assert(spk_man);
-        spk_man->SetCache(cache);
+        spk_man->SetCache(cache, &thread_pool);
 
         // Get unencrypted keys
         prefix = PrefixStream(DBKeys::WALLETDESCRIPTORKEY, id);
@@ -1031,63 +1043,108 @@ static DBErrors LoadAddressBookRecords(CWallet* pwallet, DatabaseBatch& batch) E
     return result;
 }
 
-static DBErrors LoadTxRecords(CWallet* pwallet, DatabaseBatch& batch, std::vector<uint256>& upgraded_txs, bool& any_unordered) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
+static DBErrors LoadTxRecords(CWallet* pwallet, DatabaseBatch& batch, std::vector<uint256>& upgraded_txs, bool& any_unordered, ThreadPool& thread_pool) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
 {
     AssertLockHeld(pwallet->cs_wallet);
     DBErrors result = DBErrors::LOAD_OK;
 
-    // Load tx record
-    any_unordered = false;
-    LoadResult tx_res = LoadRecords(pwallet, batch, DBKeys::TX,
-        [&any_unordered, &upgraded_txs] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
-        DBErrors result = DBErrors::LOAD_OK;
+    // Tx records are read from the database in batches. The transactions of a
+    // batch are deserialized on the thread pool and then added to the wallet in
+    // database order, so the result is the same as loading them one by one.
+    struct TxRecord {
         uint256 hash;
-        key >> hash;
-        // LoadToWallet call below creates a new CWalletTx that fill_wtx
-        // callback fills with transaction metadata.
-        auto fill_wtx = [&](CWalletTx& wtx, bool new_tx) {
-            if(!new_tx) {
-                // There's some corruption here since the tx we just tried to load was already in the wallet.
-                err = "Error: Corrupt transaction found. This can be fixed by removing transactions from wallet and rescanning.";
-                result = DBErrors::CORRUPT;
-                return false;
+        DataStream value;
+        std::unique_ptr<CWalletTx> wtx;
+    };
+    std::vector<TxRecord> records;
+    const auto load_batch = [&]() EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        std::vector<std::future<void>> chunks;
+        for (size_t begin = 0; begin < records.size(); begin += TX_LOAD_CHUNK_SIZE) {
+            const size_t end{std::min(records.size(), begin + TX_LOAD_CHUNK_SIZE)};
+            chunks.push_back(thread_pool.Submit([&records, begin, end] {
+                for (size_t i = begin; i < end; ++i) {
+                    auto wtx{std::make_unique<CWalletTx>(nullptr, TxStateInactive{})};
+                    records[i].value >> *wtx;
+                    records[i].wtx = std::move(wtx);
+                }
+            }));
+        }
+        // Wait for all chunks even if one fails, as they reference the records
+        std::exception_ptr error;
+        for (auto& chunk : chunks) {
+            try {
+                chunk.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
             }
-            value >> wtx;
-            if (wtx.GetHash() != hash)
-                return false;
-
-            // Undo serialize changes in 31600
-            if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
-            {
-                if (!value.empty())
-                {
-                    uint8_t fTmp;
-                    uint8_t fUnused;
-                    std::string unused_string;
-                    value >> fTmp >> fUnused >> unused_string;
-                    pwallet->WalletLogPrintf("LoadWallet() upgrading tx ver=%d %d %s\n",
-                                       wtx.fTimeReceivedIsTxTime, fTmp, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = fTmp;
+        }
+        if (error) std::rethrow_exception(error);
+
+        for (auto& [hash, value, loaded_wtx] : records) {
+            DBErrors record_res = DBErrors::LOAD_OK;
+            std::string err;
+            // LoadToWallet call below creates a new CWalletTx that fill_wtx
+            // callback fills with transaction metadata.
+            auto fill_wtx = [&](CWalletTx& wtx, bool new_tx) {
+                if(!new_tx) {
+                    // There's some corruption here since the tx we just tried to load was already in the wallet.
+                    err = "Error: Corrupt transaction found. This can be fixed by removing transactions from wallet and rescanning.";
+                    record_res = DBErrors::CORRUPT;
+                    return false;
                 }
-                else
+                wtx.CopyFrom(*loaded_wtx);
+                if (wtx.GetHash() != hash)
+                    return false;
+
+                // Undo serialize changes in 31600
+                if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
                 {
-                    pwallet->WalletLogPrintf("LoadWallet() repairing tx ver=%d %s\n", wtx.fTimeReceivedIsTxTime, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = 0;
+                    if (!value.empty())
+                    {
+                        uint8_t fTmp;
+                        uint8_t fUnused;
+                        std::string unused_string;
+                        value >> fTmp >> fUnused >> unused_string;
+                        pwallet->WalletLogPrintf("LoadWallet() upgrading tx ver=%d %d %s\n",
+                                           wtx.fTimeReceivedIsTxTime, fTmp, hash.ToString());
+                        wtx.fTimeReceivedIsTxTime = fTmp;
+                    }
+                    else
+                    {
+                        pwallet->WalletLogPrintf("LoadWallet() repairing tx ver=%d %s\n", wtx.fTimeReceivedIsTxTime, hash.ToString());
+                        wtx.fTimeReceivedIsTxTime = 0;
+                    }
+                    upgraded_txs.push_back(hash);
                 }
-                upgraded_txs.push_back(hash);
-            }
 
-            if (wtx.nOrderPos == -1)
-                any_unordered = true;
+                if (wtx.nOrderPos == -1)
+                    any_unordered = true;
 
-            return true;
-        };
-        if (!pwallet->LoadToWallet(hash, fill_wtx)) {
-            // Use std::max as fill_wtx may have already set result to CORRUPT
-            result = std::max(result, DBErrors::NEED_RESCAN);
+                return true;
+            };
+            if (!pwallet->LoadToWallet(hash, fill_wtx)) {
+                // Use std::max as fill_wtx may have already set record_res to CORRUPT
+                record_res = std::max(record_res, DBErrors::NEED_RESCAN);
+            }
+            if (record_res != DBErrors::LOAD_OK) {
+                pwallet->WalletLogPrintf("%s\n", err);
+            }
+            result = std::max(result, record_res);
         }
-        return result;
+        records.clear();
+    };
+
+    // Load tx record
+    any_unordered = false;
+    LoadResult tx_res = LoadRecords(pwallet, batch, DBKeys::TX,
+        [&records, &load_batch] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        uint256 hash;
+        key >> hash;
+        records.push_back({hash, value, nullptr});
+        if (records.size() >= TX_LOAD_BATCH_SIZE) load_batch();
+        return DBErrors::LOAD_OK;
     });
+    load_batch();
     result = std::max(result, tx_res.m_result);
 
     // Load locked utxo record
@@ -1179,6 +1236,16 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
 
     LOCK(pwallet->cs_wallet);
 
+    ThreadPool thread_pool{"walletload"};
+    thread_pool.Start(std::clamp(GetNumCores(), 1, MAX_WALLET_LOAD_WORKERS));
+    // Log how long each group of records took to load
+    auto phase_start{SteadyClock::now()};
+    const auto log_phase = [&](std::string_view phase) {
+        const auto now{SteadyClock::now()};
+        pwallet->WalletLogPrintf("Loaded %s in %dms\n", phase, Ticks<std::chrono::milliseconds>(now - phase_start));
+        phase_start = now;
+    };
+
     // Last client version to open this wallet
     int last_client = CLIENT_VERSION;
     bool has_last_client = m_batch->Read(DBKeys::VERSION, last_client);
@@ -1200,9 +1267,11 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
 
         // Load legacy wallet keys
         result = std::max(LoadLegacyWalletRecords(pwallet, *m_batch, last_client), result);
+        log_phase("legacy wallet records");
 
         // Load descriptors
-        result = std::max(LoadDescriptorWalletRecords(pwallet, *m_batch, last_client), result);
+        result = std::max(LoadDescriptorWalletRecords(pwallet, *m_batch, last_client, thread_pool), result);
+        log_phase("descriptors");
         // Early return if there are unknown descriptors. Later loading of ACTIVEINTERNALSPK and ACTIVEEXTERNALEXPK
         // may reference the unknown descriptor's ID which can result in a misleading corruption error
         // when in reality the wallet is simply too new.
@@ -1210,15 +1279,19 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
 
         // Load address book
         result = std::max(LoadAddressBookRecords(pwallet, *m_batch), result);
+        log_phase("address book");
 
         // Load tx records
-        result = std::max(LoadTxRecords(pwallet, *m_batch, upgraded_txs, any_unordered), result);
+        result = std::max(LoadTxRecords(pwallet, *m_batch, upgraded_txs, any_unordered, thread_pool), result);
+        log_phase("transactions");
 
         // Load SPKMs
         result = std::max(LoadActiveSPKMs(pwallet, *m_batch), result);
+        log_phase("active scriptPubKeyManagers");
 
         // Load decryption keys
         result = std::max(LoadDecryptionKeys(pwallet, *m_batch), result);
+        log_phase("decryption keys");
     } catch (...) {
         // Exceptions that can be ignored or treated as non-critical are handled by the individual loading functions.
         // Any uncaught exceptions will be caught here and treated as critical.
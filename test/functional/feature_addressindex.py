@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the address index RPCs and REST endpoints.
+
+Test that getaddresshistory, getaddressbalance, getaddressutxos and their REST
+counterparts answer from -addressindex, agree with the UTXO set, and follow reorgs.
+"""
+from decimal import Decimal
+import http.client
+import json
+import urllib.parse
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import (
+    MiniWallet,
+    getnewdestination,
+)
+
+
+class AddressIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [["-addressindex", "-rest"], ["-rest"]]
+
+    def rest_get(self, node, path, query_params=None, status=200):
+        uri = f"/rest/{path}.json"
+        if query_params:
+            uri += f"?{urllib.parse.urlencode(query_params)}"
+        url = urllib.parse.urlparse(node.url)
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request("GET", uri)
+        resp = conn.getresponse()
+        assert_equal(resp.status, status)
+        body = resp.read().decode("utf-8")
+        return json.loads(body, parse_float=Decimal) if status == 200 else body
+
+    def check_balance(self, node, address):
+        """Check the totals of an address against its history and the UTXO set."""
+        balance = node.getaddressbalance(address)
+        history = node.getaddresshistory(address)
+        assert_equal(balance["received"], sum(entry["amount"] for entry in history if not entry["spent"]))
+        assert_equal(balance["balance"], sum(entry["amount"] for entry in history))
+        utxos = node.scantxoutset("start", [f"addr({address})"])
+        assert_equal(balance["balance"], utxos["total_amount"])
+        assert_equal(balance["unspent"], len(utxos["unspents"]))
+        assert_equal(self.rest_get(node, f"addressbalance/{address}"), balance)
+        unspents = node.getaddressutxos(address)
+        fields = ("txid", "vout", "height", "amount")
+        assert_equal(sorted(tuple(u[f] for f in fields) for u in unspents),
+                     sorted(tuple(u[f] for f in fields) for u in utxos["unspents"]))
+        assert_equal(self.rest_get(node, f"addressutxos/{address}"), unspents)
+        return balance
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+        self.wait_until(lambda: node.getindexinfo("addressindex")["addressindex"]["synced"])
+
+        self.log.info("Check an address that was paid to twice")
+        _, script, address = getnewdestination()
+        txids = [self.wallet.send_to(from_node=node, scriptPubKey=script, amount=amount)["txid"]
+                 for amount in (100_000, 250_000)]
+        self.generate(node, 1)
+        height = node.getblockcount()
+        balance = self.check_balance(node, address)
+        assert_equal(balance, {"balance": Decimal("0.00350000"), "received": Decimal("0.00350000"), "unspent": 2})
+        history = node.getaddresshistory(address)
+        assert_equal(sorted(entry["txid"] for entry in history), sorted(txids))
+        assert all(entry["height"] == height and not entry["spent"] for entry in history)
+
+        self.log.info("Check the address of the wallet, which spends its own outputs")
+        wallet_address = self.wallet.get_address()
+        for _ in range(3):
+            self.wallet.send_self_transfer(from_node=node)
+            self.generate(node, 1)
+        wallet_balance = self.check_balance(node, wallet_address)
+        assert wallet_balance["received"] > wallet_balance["balance"] > 0
+        assert any(entry["spent"] for entry in node.getaddresshistory(wallet_address))
+
+        self.log.info("Check history height ranges")
+        wallet_history = node.getaddresshistory(wallet_address)
+        ranged = node.getaddresshistory(wallet_address, height, height + 1)
+        assert_equal(ranged, [entry for entry in wallet_history if height <= entry["height"] <= height + 1])
+        assert_equal(self.rest_get(node, f"addresshistory/{wallet_address}", {"start_height": height, "end_height": height + 1}), ranged)
+        assert_equal(self.rest_get(node, f"addresshistory/{wallet_address}"), wallet_history)
+        assert_raises_rpc_error(-8, "Invalid height range", node.getaddresshistory, wallet_address, 10, 9)
+        self.rest_get(node, f"addresshistory/{wallet_address}", {"start_height": 10, "end_height": 9}, status=400)
+
+        self.log.info("Check that the totals follow a reorg")
+        tip = node.getbestblockhash()
+        reorg_block = node.getblockhash(height)
+        node.invalidateblock(reorg_block)
+        # The index rewinds when a block is connected on the new branch. Leave
+        # the transactions paying to the address in the mempool.
+        self.generateblock(node, output=getnewdestination()[2], transactions=[], sync_fun=self.no_op)
+        assert_equal(node.getaddressbalance(address), {"balance": 0, "received": 0, "unspent": 0})
+        assert_equal(node.getaddresshistory(address), [])
+        assert_equal(node.getaddressutxos(address), [])
+        self.check_balance(node, wallet_address)
+        node.reconsiderblock(reorg_block)
+        assert_equal(node.getbestblockhash(), tip)
+        assert_equal(self.check_balance(node, address), balance)
+        assert_equal(self.check_balance(node, wallet_address), wallet_balance)
+
+        self.log.info("Check invalid requests")
+        assert_raises_rpc_error(-5, "Invalid address", node.getaddressbalance, "invalid")
+        assert_raises_rpc_error(-5, "Invalid address", node.getaddressutxos, "invalid")
+        self.rest_get(node, "addressutxos/invalid", status=400)
+        assert_equal(self.rest_get(node, "addressbalance/invalid", status=400), "Invalid address: invalid\r\n")
+
+        self.log.info("Check a node without the address index")
+        assert_raises_rpc_error(-1, "Address index is not enabled", self.nodes[1].getaddressbalance, address)
+        assert_raises_rpc_error(-1, "Address index is not enabled", self.nodes[1].getaddresshistory, address)
+        assert_raises_rpc_error(-1, "Address index is not enabled", self.nodes[1].getaddressutxos, address)
+        self.rest_get(self.nodes[1], f"addressbalance/{address}", status=400)
+        self.rest_get(self.nodes[1], f"addresshistory/{address}", status=400)
+        self.rest_get(self.nodes[1], f"addressutxos/{address}", status=400)
+
+
+if __name__ == '__main__':
+    AddressIndexTest(__file__).main()
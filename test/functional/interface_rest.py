@@ -351,12 +351,23 @@ class RESTTest (BitcoinTestFramework):
         raw_mempool_verbose = self.nodes[0].getrawmempool(verbose=True)
 
         assert_equal(json_obj, raw_mempool_verbose)
+        # The verbose contents are streamed rather than sent as one body
+        resp = self.test_rest_request("/mempool/contents", ret_type=RetType.OBJ)
+        assert_equal(resp.getheader("Transfer-Encoding"), "chunked")
+        assert_equal(json.loads(resp.read().decode('utf-8'), parse_float=Decimal), raw_mempool_verbose)
 
         for i, tx in enumerate(txs):
             assert tx in json_obj
             assert_equal(json_obj[tx]['spentby'], txs[i + 1:i + 2])
             assert_equal(json_obj[tx]['depends'], txs[i - 1:i])
 
+        # Check the compact binary mempool contents: one record per entry, starting with the txid and wtxid
+        bin_mempool = self.test_rest_request("/mempool/contents", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        hex_mempool = self.test_rest_request("/mempool/contents", req_type=ReqType.HEX, ret_type=RetType.BYTES)
+        assert_equal(bin_mempool.hex(), hex_mempool.decode('ascii').strip())
+        for tx in txs:
+            assert bytes.fromhex(tx)[::-1] + bytes.fromhex(raw_mempool_verbose[tx]['wtxid'])[::-1] in bin_mempool
+
         # Check the mempool response for explicit parameters
         json_obj = self.test_rest_request("/mempool/contents", query_params={"verbose": "true", "mempool_sequence": "false"})
         assert_equal(json_obj, raw_mempool_verbose)
@@ -4,11 +4,15 @@
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 """Tests some generic aspects of the RPC interface."""
 
+from decimal import Decimal
+import http.client
 import json
 import os
+import urllib.parse
 from dataclasses import dataclass
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_equal, assert_greater_than_or_equal
+from test_framework.util import assert_equal, assert_greater_than_or_equal, str_to_b64str
+from test_framework.wallet import MiniWallet
 from threading import Thread
 from typing import Optional
 import subprocess
@@ -226,6 +230,31 @@ class RPCInterfaceTest(BitcoinTestFramework):
         # Sanity check: command was not executed
         assert_equal(block_count + 1, self.nodes[0].getblockcount())
 
+    def test_result_in_parts(self):
+        self.log.info("Testing a result sent in parts...")
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+        self.generate(wallet, 101)
+        for _ in range(3):
+            wallet.send_self_transfer(from_node=node)
+        mempool = node.getrawmempool(verbose=True)
+        assert_equal(len(mempool), 3)
+
+        url = urllib.parse.urlparse(node.url)
+        headers = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}"}
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        for version in [None, 1, 2]:
+            request = format_request(BatchOptions(version), 7, {"method": "getrawmempool", "params": [True]})
+            # Reuse the connection, which stays usable after a reply sent in parts
+            conn.request("POST", "/", json.dumps(request), headers)
+            response = conn.getresponse()
+            assert_equal(response.status, 200)
+            assert_equal(response.getheader("Content-Type"), "application/json")
+            assert_equal(response.getheader("Transfer-Encoding"), "chunked")
+            expected = format_response(BatchOptions(version), 7, {"result": mempool})
+            assert_equal(json.loads(response.read(), parse_float=Decimal), expected)
+        conn.close()
+
     def test_work_queue_exceeded(self):
         self.log.info("Testing work queue exceeded...")
         self.restart_node(0, ['-rpcworkqueue=1', '-rpcthreads=1'])
@@ -242,6 +271,7 @@ class RPCInterfaceTest(BitcoinTestFramework):
         self.test_getrpcinfo()
         self.test_batch_requests()
         self.test_http_status_codes()
+        self.test_result_in_parts()
         self.test_work_queue_exceeded()
 
 
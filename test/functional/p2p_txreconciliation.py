@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test transaction reconciliation rounds (BIP 330) initiated by the node.
+
+The node initiates reconciliations with its outbound peers. Two such peers are
+connected:
+
+- One answers every REQRECON with a SKETCH of an empty set, so the node finds
+  the whole set difference, sends a successful RECONCILDIFF and announces the
+  transactions it reconciled.
+- One stops answering, so the node announces the set it requested
+  reconciliation for once RECON_RESPONSE_TIMEOUT has passed.
+"""
+import time
+
+from test_framework.messages import (
+    MSG_WTX,
+    msg_sendtxrcncl,
+    msg_sketch,
+    msg_verack,
+    msg_wtxidrelay,
+)
+from test_framework.p2p import P2PInterface
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+# Must match RECON_REQUEST_INTERVAL and RECON_RESPONSE_TIMEOUT in node/txreconciliation.h.
+RECON_REQUEST_INTERVAL = 8
+RECON_RESPONSE_TIMEOUT = 60
+# Large enough for the node to decode the difference to an empty set.
+EMPTY_SKETCH = bytes(64 * 4)
+NUM_TXS = 20
+
+
+class ReconciliationPeer(P2PInterface):
+    def __init__(self):
+        super().__init__()
+        self.answer_requests = True
+        self.reqrecons = []
+        self.reconcildiffs = []
+        self.announced = set()
+
+    def on_version(self, message):
+        # The node connected to us: complete the handshake, registering for reconciliation.
+        self.send_version()
+        self.send_message(msg_wtxidrelay())
+        sendtxrcncl = msg_sendtxrcncl()
+        sendtxrcncl.version = 1
+        sendtxrcncl.salt = 2
+        self.send_message(sendtxrcncl)
+        self.send_message(msg_verack())
+        self.nServices = message.nServices
+        self.relay = message.relay
+
+    def on_reqrecon(self, message):
+        self.reqrecons.append(message)
+        if self.answer_requests:
+            self.send_message(msg_sketch(EMPTY_SKETCH))
+
+    def on_reconcildiff(self, message):
+        self.reconcildiffs.append(message)
+
+    def on_inv(self, message):
+        self.announced.update(inv.hash for inv in message.inv if inv.type == MSG_WTX)
+
+
+class TxReconciliationTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [['-txreconciliation']]
+
+    def bump_mocktime(self, seconds, peers):
+        for _ in range(seconds):
+            self.mocktime += 1
+            self.nodes[0].setmocktime(self.mocktime)
+            for peer in peers:
+                peer.sync_with_ping()
+
+    def bump_mocktime_until(self, predicate, peers):
+        # Announcements go out on the node's randomized trickle timer.
+        for _ in range(RECON_RESPONSE_TIMEOUT):
+            if predicate():
+                return
+            self.bump_mocktime(1, peers)
+        assert predicate()
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+        # Leave IBD so transactions are relayed.
+        self.generate(node, 1)
+        self.mocktime = int(time.time())
+        node.setmocktime(self.mocktime)
+
+        answering = node.add_outbound_p2p_connection(ReconciliationPeer(), p2p_idx=0)
+        silent = node.add_outbound_p2p_connection(ReconciliationPeer(), p2p_idx=1)
+        peers = [answering, silent]
+
+        self.log.info("Check that the node requests a reconciliation right after registering the peer")
+        for peer in peers:
+            peer.wait_until(lambda peer=peer: len(peer.reconcildiffs) == 1)
+            assert_equal(peer.reqrecons[0].set_size, 0)
+            assert peer.reconcildiffs[0].success
+        silent.answer_requests = False
+
+        # With two outbound reconciling peers, each transaction is flooded to about
+        # one of them and reconciled with the other.
+        wtxids = {int(self.wallet.send_self_transfer(from_node=node)["wtxid"], 16) for _ in range(NUM_TXS)}
+        self.bump_mocktime(RECON_REQUEST_INTERVAL + 2, peers)
+        for peer in peers:
+            peer.wait_until(lambda peer=peer: len(peer.reqrecons) == 2)
+
+        self.log.info("Check that a decoded sketch ends in a successful reconcildiff and announcements")
+        answering.wait_until(lambda: len(answering.reconcildiffs) == 2)
+        assert answering.reqrecons[1].set_size > 0
+        assert answering.reconcildiffs[1].success
+        assert_equal(answering.reconcildiffs[1].ask_short_ids, [])
+        self.bump_mocktime_until(lambda: answering.announced == wtxids, [answering])
+
+        self.log.info("Check that the set of an unanswered request is announced after the timeout")
+        reconciled = silent.reqrecons[1].set_size
+        assert reconciled > 0
+        self.bump_mocktime(RECON_RESPONSE_TIMEOUT // 2, peers)
+        assert len(silent.announced) <= NUM_TXS - reconciled
+        assert_equal(len(silent.reqrecons), 2)
+        with node.assert_debug_log(["Reconciliation request to peer=1 timed out"]):
+            self.bump_mocktime(RECON_RESPONSE_TIMEOUT // 2 + 2, peers)
+        self.bump_mocktime_until(lambda: silent.announced == wtxids, peers)
+        # No new request is sent while the expired one is unanswered.
+        assert_equal(len(silent.reqrecons), 2)
+
+
+if __name__ == '__main__':
+    TxReconciliationTest(__file__).main()